@@ -0,0 +1,554 @@
+#include <algorithm>
+#include <filesystem>
+#include <cstring>
+
+#include "archive.hpp"
+#include "configuration.hpp"
+#include "durability.hpp"
+
+#include "sqlite3/rotation.hpp"
+
+using namespace WarGrey::SCADA;
+using namespace WarGrey::GYDM;
+
+/*************************************************************************************************/
+static const char archive_magic[4] = { 'W', 'G', 'C', 'A' };
+static const unsigned char archive_version = 1;
+
+namespace {
+	private class BitWriter {
+	public:
+		void write(unsigned long long bits, unsigned int n) {
+			for (unsigned int i = n; i > 0; i--) {
+				if (this->used == 0) {
+					this->octets.push_back(0);
+				}
+
+				if (((bits >> (i - 1)) & 0b1) == 0b1) {
+					this->octets.back() |= (0x80 >> this->used);
+				}
+
+				this->used = (this->used + 1) % 8;
+			}
+		}
+
+	public:
+		std::vector<char> octets;
+
+	private:
+		unsigned int used = 0;
+	};
+
+	private class BitReader {
+	public:
+		BitReader(const std::vector<char>& octets) : octets(octets), cursor(0U) {}
+
+	public:
+		unsigned long long read(unsigned int n) {
+			unsigned long long bits = 0ULL;
+
+			for (unsigned int i = 0; i < n; i++) {
+				size_t idx = this->cursor >> 3;
+				unsigned int bit = 0;
+
+				if (idx < this->octets.size()) {
+					bit = (((unsigned char)(this->octets[idx])) >> (7 - (this->cursor & 0x7))) & 0b1;
+				}
+
+				bits = (bits << 1) | bit;
+				this->cursor++;
+			}
+
+			return bits;
+		}
+
+		bool overrun() {
+			return (this->cursor > this->octets.size() * 8U);
+		}
+
+	private:
+		const std::vector<char>& octets;
+		size_t cursor;
+	};
+}
+
+static inline unsigned long long zigzag(long long n) {
+	return (((unsigned long long)n) << 1) ^ ((unsigned long long)(n >> 63));
+}
+
+static inline long long unzigzag(unsigned long long z) {
+	return (long long)(z >> 1) ^ -((long long)(z & 0b1));
+}
+
+static inline unsigned long long double_bits(double v) {
+	unsigned long long bits;
+
+	memcpy(&bits, &v, sizeof(double));
+
+	return bits;
+}
+
+static inline double bits_double(unsigned long long bits) {
+	double v;
+
+	memcpy(&v, &bits, sizeof(double));
+
+	return v;
+}
+
+static inline unsigned int leading_zeros(unsigned long long x) {
+	unsigned int n = 0;
+
+	while ((n < 64) && (((x >> (63 - n)) & 0b1) == 0)) n++;
+
+	return n;
+}
+
+static inline unsigned int trailing_zeros(unsigned long long x) {
+	unsigned int n = 0;
+
+	while ((n < 64) && (((x >> n) & 0b1) == 0)) n++;
+
+	return n;
+}
+
+static void encode_timepoints(BitWriter& bw, const long long* timepoints, unsigned int count) {
+	long long delta = 0LL;
+
+	for (unsigned int i = 0; i < count; i++) {
+		if (i == 0) {
+			bw.write((unsigned long long)timepoints[i], 64);
+		} else {
+			long long d = timepoints[i] - timepoints[i - 1];
+			unsigned long long dod = zigzag(d - delta);
+
+			if (dod == 0) {
+				bw.write(0b0, 1);
+			} else if (dod < (1ULL << 7)) {
+				bw.write(0b10, 2);
+				bw.write(dod, 7);
+			} else if (dod < (1ULL << 9)) {
+				bw.write(0b110, 3);
+				bw.write(dod, 9);
+			} else if (dod < (1ULL << 12)) {
+				bw.write(0b1110, 4);
+				bw.write(dod, 12);
+			} else {
+				bw.write(0b1111, 4);
+				bw.write(dod, 64);
+			}
+
+			delta = d;
+		}
+	}
+}
+
+static void decode_timepoints(BitReader& br, long long* timepoints, unsigned int count) {
+	long long delta = 0LL;
+
+	for (unsigned int i = 0; i < count; i++) {
+		if (i == 0) {
+			timepoints[i] = (long long)br.read(64);
+		} else {
+			unsigned long long dod = 0ULL;
+
+			if (br.read(1) == 1) {
+				if (br.read(1) == 0) {
+					dod = br.read(7);
+				} else if (br.read(1) == 0) {
+					dod = br.read(9);
+				} else if (br.read(1) == 0) {
+					dod = br.read(12);
+				} else {
+					dod = br.read(64);
+				}
+			}
+
+			delta += unzigzag(dod);
+			timepoints[i] = timepoints[i - 1] + delta;
+		}
+	}
+}
+
+static void encode_column(BitWriter& bw, const double* values, unsigned int stride, unsigned int count) {
+	unsigned long long prev = 0ULL;
+	unsigned int prev_leading = 65;
+	unsigned int prev_trailing = 0;
+
+	for (unsigned int i = 0; i < count; i++) {
+		unsigned long long bits = double_bits(values[i * stride]);
+
+		if (i == 0) {
+			bw.write(bits, 64);
+		} else {
+			unsigned long long x = bits ^ prev;
+
+			if (x == 0) {
+				bw.write(0b0, 1);
+			} else {
+				unsigned int leading = std::min(leading_zeros(x), 31U);
+				unsigned int trailing = trailing_zeros(x);
+
+				bw.write(0b1, 1);
+
+				if ((prev_leading <= 64) && (leading >= prev_leading) && (trailing >= prev_trailing)) {
+					// the meaningful bits fit in the previous window
+					bw.write(0b0, 1);
+					bw.write(x >> prev_trailing, 64 - prev_leading - prev_trailing);
+				} else {
+					unsigned int significant = 64 - leading - trailing;
+
+					bw.write(0b1, 1);
+					bw.write(leading, 5);
+					bw.write(significant % 64, 6); // 64 is stored as 0
+					bw.write(x >> trailing, significant);
+
+					prev_leading = leading;
+					prev_trailing = trailing;
+				}
+			}
+		}
+
+		prev = bits;
+	}
+}
+
+static void decode_column(BitReader& br, double* values, unsigned int stride, unsigned int count) {
+	unsigned long long prev = 0ULL;
+	unsigned int prev_leading = 0;
+	unsigned int prev_trailing = 0;
+
+	for (unsigned int i = 0; i < count; i++) {
+		if (i == 0) {
+			prev = br.read(64);
+		} else if (br.read(1) == 1) {
+			if (br.read(1) == 1) {
+				unsigned int significant = 0;
+
+				prev_leading = (unsigned int)br.read(5);
+				significant = (unsigned int)br.read(6);
+
+				if (significant == 0) {
+					significant = 64;
+				}
+
+				prev_trailing = 64 - prev_leading - significant;
+			}
+
+			prev ^= (br.read(64 - prev_leading - prev_trailing) << prev_trailing);
+		}
+
+		values[i * stride] = bits_double(prev);
+	}
+}
+
+template<typename T>
+static void write_scalar(std::ofstream& out, T v) {
+	out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template<typename T>
+static T read_scalar(std::ifstream& in) {
+	T v = T();
+
+	in.read(reinterpret_cast<char*>(&v), sizeof(T));
+
+	return v;
+}
+
+/*************************************************************************************************/
+ColumnarArchiveWriter::ColumnarArchiveWriter(std::wstring path, unsigned int column_count, unsigned int block_size)
+	: archive(path, std::ios::binary | std::ios::trunc), total(0ULL), column_count(column_count), block_size(block_size), closed(false) {
+	this->archive.write(archive_magic, sizeof(archive_magic));
+	write_scalar<unsigned char>(this->archive, archive_version);
+	write_scalar<unsigned char>(this->archive, (unsigned char)column_count);
+}
+
+ColumnarArchiveWriter::~ColumnarArchiveWriter() {
+	this->close();
+}
+
+void ColumnarArchiveWriter::append(long long timepoint, const double* values) {
+	this->timepoints.push_back(timepoint);
+	this->values.insert(this->values.end(), values, values + this->column_count);
+
+	if (this->timepoints.size() >= this->block_size) {
+		this->flush_block();
+	}
+}
+
+unsigned long long ColumnarArchiveWriter::count() {
+	return this->total;
+}
+
+bool ColumnarArchiveWriter::good() {
+	return !this->archive.fail();
+}
+
+bool ColumnarArchiveWriter::close() {
+	if (!this->closed) {
+		unsigned long long footer = 0ULL;
+
+		this->flush_block();
+
+		footer = (unsigned long long)this->archive.tellp();
+		for (auto it = this->indices.begin(); it != this->indices.end(); it++) {
+			write_scalar<unsigned long long>(this->archive, it->offset);
+			write_scalar<unsigned int>(this->archive, it->count);
+			write_scalar<unsigned int>(this->archive, it->size);
+			write_scalar<long long>(this->archive, it->open_timepoint);
+			write_scalar<long long>(this->archive, it->close_timepoint);
+
+			for (unsigned int c = 0; c < this->column_count; c++) {
+				write_scalar<double>(this->archive, it->min[c]);
+				write_scalar<double>(this->archive, it->max[c]);
+			}
+		}
+
+		write_scalar<unsigned long long>(this->archive, footer);
+		write_scalar<unsigned int>(this->archive, (unsigned int)this->indices.size());
+		this->archive.write(archive_magic, sizeof(archive_magic));
+		this->archive.close();
+
+		this->closed = true;
+	}
+
+	return !this->archive.fail();
+}
+
+void ColumnarArchiveWriter::flush_block() {
+	unsigned int count = (unsigned int)this->timepoints.size();
+
+	if (count > 0) {
+		ArchiveBlockIndex index;
+		BitWriter bw;
+
+		index.offset = (unsigned long long)this->archive.tellp();
+		index.count = count;
+		index.open_timepoint = this->timepoints.front();
+		index.close_timepoint = this->timepoints.back();
+
+		for (unsigned int c = 0; c < this->column_count; c++) {
+			double vmin = this->values[c];
+			double vmax = this->values[c];
+
+			for (unsigned int i = 1; i < count; i++) {
+				vmin = std::min(vmin, this->values[i * this->column_count + c]);
+				vmax = std::max(vmax, this->values[i * this->column_count + c]);
+			}
+
+			index.min.push_back(vmin);
+			index.max.push_back(vmax);
+		}
+
+		encode_timepoints(bw, this->timepoints.data(), count);
+		for (unsigned int c = 0; c < this->column_count; c++) {
+			encode_column(bw, this->values.data() + c, this->column_count, count);
+		}
+
+		index.size = (unsigned int)bw.octets.size();
+		this->archive.write(bw.octets.data(), bw.octets.size());
+		this->indices.push_back(index);
+
+		this->total += count;
+		this->timepoints.clear();
+		this->values.clear();
+	}
+}
+
+/*************************************************************************************************/
+ColumnarArchiveReader::ColumnarArchiveReader(std::wstring path)
+	: archive(path, std::ios::binary), total(0ULL), columns(0U), okay(false) {
+	char magic[sizeof(archive_magic)];
+
+	if (this->archive.is_open()) {
+		this->archive.read(magic, sizeof(magic));
+
+		if ((memcmp(magic, archive_magic, sizeof(magic)) == 0) && (read_scalar<unsigned char>(this->archive) == archive_version)) {
+			long long tail = (long long)(sizeof(unsigned long long) + sizeof(unsigned int) + sizeof(archive_magic));
+			unsigned long long footer = 0ULL;
+			unsigned int block_count = 0U;
+
+			this->columns = read_scalar<unsigned char>(this->archive);
+
+			this->archive.seekg(-tail, std::ios::end);
+			footer = read_scalar<unsigned long long>(this->archive);
+			block_count = read_scalar<unsigned int>(this->archive);
+			this->archive.read(magic, sizeof(magic));
+
+			if ((!this->archive.fail()) && (memcmp(magic, archive_magic, sizeof(magic)) == 0)) {
+				this->archive.seekg(footer, std::ios::beg);
+
+				for (unsigned int i = 0; i < block_count; i++) {
+					ArchiveBlockIndex index;
+
+					index.offset = read_scalar<unsigned long long>(this->archive);
+					index.count = read_scalar<unsigned int>(this->archive);
+					index.size = read_scalar<unsigned int>(this->archive);
+					index.open_timepoint = read_scalar<long long>(this->archive);
+					index.close_timepoint = read_scalar<long long>(this->archive);
+
+					for (unsigned int c = 0; c < this->columns; c++) {
+						index.min.push_back(read_scalar<double>(this->archive));
+						index.max.push_back(read_scalar<double>(this->archive));
+					}
+
+					this->total += index.count;
+					this->indices.push_back(index);
+				}
+
+				this->okay = !this->archive.fail();
+			}
+		}
+	}
+}
+
+bool ColumnarArchiveReader::ready() {
+	return this->okay;
+}
+
+unsigned int ColumnarArchiveReader::column_count() {
+	return this->columns;
+}
+
+unsigned long long ColumnarArchiveReader::count() {
+	return this->total;
+}
+
+const std::vector<ArchiveBlockIndex>& ColumnarArchiveReader::blocks() {
+	return this->indices;
+}
+
+bool ColumnarArchiveReader::decode_block(ArchiveBlockIndex& index, std::vector<long long>& timepoints, std::vector<double>& values) {
+	std::vector<char> octets(index.size);
+
+	this->archive.clear();
+	this->archive.seekg(index.offset, std::ios::beg);
+	this->archive.read(octets.data(), index.size);
+
+	bool okay = !this->archive.fail();
+
+	if (okay) {
+		BitReader br(octets);
+
+		timepoints.resize(index.count);
+		values.resize(size_t(index.count) * this->columns);
+
+		decode_timepoints(br, timepoints.data(), index.count);
+		for (unsigned int c = 0; c < this->columns; c++) {
+			decode_column(br, values.data() + c, this->columns, index.count);
+		}
+
+		okay = !br.overrun();
+	}
+
+	return okay;
+}
+
+void ColumnarArchiveReader::foreach(long long open_timepoint, long long close_timepoint, bool asc, std::function<bool(long long, const double*)> step) {
+	std::vector<long long> timepoints;
+	std::vector<double> values;
+	size_t block_count = this->indices.size();
+	bool go_on = this->okay;
+
+	for (size_t b = 0; go_on && (b < block_count); b++) {
+		ArchiveBlockIndex& index = this->indices[asc ? b : (block_count - b - 1)];
+
+		if ((index.close_timepoint >= open_timepoint) && (index.open_timepoint <= close_timepoint)) {
+			if (this->decode_block(index, timepoints, values)) {
+				for (unsigned int i = 0; go_on && (i < index.count); i++) {
+					unsigned int idx = (asc ? i : (index.count - i - 1));
+					long long ts = timepoints[idx];
+
+					if ((ts >= open_timepoint) && (ts <= close_timepoint)) {
+						go_on = step(ts, values.data() + size_t(idx) * this->columns);
+					}
+				}
+			} else {
+				go_on = false;
+			}
+		}
+	}
+}
+
+bool ColumnarArchiveReader::verify(unsigned long long expected) {
+	std::vector<long long> timepoints;
+	std::vector<double> values;
+	unsigned long long decoded = 0ULL;
+	bool okay = this->okay;
+
+	for (auto it = this->indices.begin(); okay && (it != this->indices.end()); it++) {
+		okay = (this->decode_block((*it), timepoints, values)
+			&& (it->count > 0U)
+			&& (timepoints.front() == it->open_timepoint)
+			&& (timepoints.back() == it->close_timepoint));
+
+		decoded += it->count;
+	}
+
+	return (okay && (decoded == expected));
+}
+
+/*************************************************************************************************/
+Platform::String^ WarGrey::SCADA::columnar_archive_name(Platform::String^ dbsource) {
+	return dbsource + ".wgca";
+}
+
+bool WarGrey::SCADA::columnar_archive_compact(Platform::String^ source, Platform::String^ archive, unsigned int column_count
+	, std::function<unsigned long long(IDBSystem*)> count
+	, std::function<void(IDBSystem*, ColumnarArchiveWriter*)> dump, Syslog* logger) {
+	std::filesystem::path src(source->Data());
+	std::filesystem::path dest(archive->Data());
+	std::filesystem::path tmp(std::wstring(archive->Data()) + L".tmp");
+	std::error_code ec;
+	bool done = false;
+
+	if (std::filesystem::exists(src, ec) && (!std::filesystem::exists(dest, ec))) {
+		unsigned long long src_size = std::filesystem::file_size(src, ec);
+		unsigned long long expected = 0ULL;
+		bool okay = false;
+
+		{ // the source is closed before being removed
+			SQLite3* dbc = new SQLite3(source->Data(), logger);
+			ColumnarArchiveWriter writer(tmp.wstring(), column_count, archive_block_size);
+
+			dbc->set_busy_handler(durability_busy_handler);
+			apply_durability(dbc, DurabilityProfile::Reader);
+
+			expected = count(dbc);
+			dump(dbc, &writer);
+			okay = writer.close();
+
+			delete dbc;
+		}
+
+		if (okay) { // the archive is decoded from the disk, rather than trusting its own footer
+			ColumnarArchiveReader reader(tmp.wstring());
+
+			okay = reader.verify(expected);
+		}
+
+		if (okay) {
+			std::filesystem::rename(tmp, dest, ec);
+			okay = !ec;
+		}
+
+		if (okay) {
+			unsigned long long dest_size = std::filesystem::file_size(dest, ec);
+
+			std::filesystem::remove(src, ec);
+			std::filesystem::remove(std::wstring(source->Data()) + L"-wal", ec);
+			std::filesystem::remove(std::wstring(source->Data()) + L"-shm", ec);
+
+			logger->log_message(Log::Info, L"archived %s: %llu records, %llu -> %llu bytes",
+				source->Data(), expected, src_size, dest_size);
+
+			done = true;
+		} else {
+			std::filesystem::remove(tmp, ec);
+			logger->log_message(Log::Warning, L"failed to archive %s, the source is kept", source->Data());
+		}
+	}
+
+	return done;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <functional>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "dbsystem.hpp"
+#include "syslog.hpp"
+
+namespace WarGrey::SCADA {
+	private struct ArchiveBlockIndex {
+		unsigned long long offset;
+		unsigned int count;
+		unsigned int size;
+		long long open_timepoint;
+		long long close_timepoint;
+		std::vector<double> min;
+		std::vector<double> max;
+	};
+
+	/** NOTE
+	 * Rotated history files are never updated after the period is closed,
+	 *   so they are compacted into columnar archives of blocks, each block holds:
+	 *     timestamps encoded as delta-of-deltas, and
+	 *     every column of doubles encoded as Gorilla-style XORs against the previous value.
+	 *
+	 * The index of blocks (time range and min/max of each column) is placed at the end of the file,
+	 *   readers seek to the blocks overlapping the requested range only.
+	 */
+	private class ColumnarArchiveWriter {
+	public:
+		ColumnarArchiveWriter(std::wstring path, unsigned int column_count, unsigned int block_size);
+		~ColumnarArchiveWriter() noexcept;
+
+	public:
+		void append(long long timepoint, const double* values);
+		bool close();
+
+	public:
+		unsigned long long count();
+		bool good();
+
+	private:
+		void flush_block();
+
+	private:
+		std::ofstream archive;
+		std::vector<WarGrey::SCADA::ArchiveBlockIndex> indices;
+		std::vector<long long> timepoints;
+		std::vector<double> values;
+		unsigned long long total;
+		unsigned int column_count;
+		unsigned int block_size;
+		bool closed;
+	};
+
+	private class ColumnarArchiveReader {
+	public:
+		ColumnarArchiveReader(std::wstring path);
+
+	public:
+		bool ready();
+		unsigned int column_count();
+		unsigned long long count();
+		const std::vector<WarGrey::SCADA::ArchiveBlockIndex>& blocks();
+
+	public:
+		/**
+		 * `step` is applied to records within [open_timepoint, close_timepoint] (in milliseconds),
+		 *   it returns `false` to stop.
+		 */
+		void foreach(long long open_timepoint, long long close_timepoint, bool asc,
+			std::function<bool(long long timepoint, const double* values)> step);
+
+		/**
+		 * decodes every block, returns `false` if any block is broken or the archive does not hold `expected` records.
+		 */
+		bool verify(unsigned long long expected);
+
+	private:
+		bool decode_block(WarGrey::SCADA::ArchiveBlockIndex& index, std::vector<long long>& timepoints, std::vector<double>& values);
+
+	private:
+		std::ifstream archive;
+		std::vector<WarGrey::SCADA::ArchiveBlockIndex> indices;
+		unsigned long long total;
+		unsigned int columns;
+		bool okay;
+	};
+
+	Platform::String^ columnar_archive_name(Platform::String^ dbsource);
+
+	/**
+	 * `dump` feeds all records of the source database into the writer, `count` counts the records of the source.
+	 * The source is removed only if every block of the archive has been decoded back
+	 *   and the archive holds as many records as the source does.
+	 */
+	bool columnar_archive_compact(Platform::String^ source, Platform::String^ archive, unsigned int column_count,
+		std::function<unsigned long long(WarGrey::SCADA::IDBSystem*)> count,
+		std::function<void(WarGrey::SCADA::IDBSystem*, WarGrey::SCADA::ColumnarArchiveWriter*)> dump,
+		WarGrey::GYDM::Syslog* logger);
+}
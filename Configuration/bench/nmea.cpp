@@ -0,0 +1,122 @@
+#include <cstdint>
+
+#include "nmea.hpp"
+
+using namespace WarGrey::DTPM;
+
+/*************************************************************************************************/
+static inline int hexadecimal_value(char ch) {
+	int v = -1;
+
+	if ((ch >= '0') && (ch <= '9')) {
+		v = ch - '0';
+	} else if ((ch >= 'A') && (ch <= 'F')) {
+		v = ch - 'A' + 10;
+	} else if ((ch >= 'a') && (ch <= 'f')) {
+		v = ch - 'a' + 10;
+	}
+
+	return v;
+}
+
+/*************************************************************************************************/
+unsigned char WarGrey::DTPM::nmea_checksum_bytewise(const char* body, size_t size) {
+	unsigned char cs = 0U;
+
+	for (size_t idx = 0; idx < size; idx++) {
+		cs ^= (unsigned char)(body[idx]);
+	}
+
+	return cs;
+}
+
+unsigned char WarGrey::DTPM::nmea_checksum(const char* body, size_t size) {
+	uint64_t acc = 0U;
+	size_t idx = 0U;
+
+	// XOR is associative, so does it on the whole words and folds the result down to one byte
+	for (; idx + sizeof(uint64_t) <= size; idx += sizeof(uint64_t)) {
+		uint64_t word;
+
+		std::memcpy(&word, body + idx, sizeof(uint64_t));
+		acc ^= word;
+	}
+
+	acc ^= (acc >> 32U);
+	acc ^= (acc >> 16U);
+	acc ^= (acc >> 8U);
+
+	return (unsigned char)(acc) ^ nmea_checksum_bytewise(body + idx, size - idx);
+}
+
+size_t WarGrey::DTPM::nmea_sentence_validate(const char* sentence, size_t size) {
+	size_t star = 0U;
+
+	if ((size > 4U) && ((sentence[0] == '$') || (sentence[0] == '!'))) {
+		const char* asterisk = static_cast<const char*>(std::memchr(sentence + 1, '*', size - 1U));
+
+		if (asterisk != nullptr) {
+			size_t pos = size_t(asterisk - sentence);
+
+			if (pos + 2U < size) {
+				int hi = hexadecimal_value(sentence[pos + 1U]);
+				int lo = hexadecimal_value(sentence[pos + 2U]);
+
+				if ((hi >= 0) && (lo >= 0)) {
+					if (nmea_checksum(sentence + 1, pos - 1U) == (unsigned char)((hi << 4) | lo)) {
+						star = pos;
+					}
+				}
+			}
+		}
+	}
+
+	return star;
+}
+
+unsigned int WarGrey::DTPM::nmea_sentence_tag(const char* sentence, size_t size) {
+	const char* comma = static_cast<const char*>(std::memchr(sentence, ',', size));
+	unsigned int tag = 0U;
+
+	if (comma != nullptr) {
+		size_t end = size_t(comma - sentence);
+
+		if (end >= 4U) { // the talker might be absent or proprietary
+			tag = nmea_tag(sentence[end - 3U], sentence[end - 2U], sentence[end - 1U]);
+		}
+	}
+
+	return tag;
+}
+
+size_t WarGrey::DTPM::nmea_sentence_tokenize(const char* sentence, size_t star, size_t fields[], size_t capacity, bool* overflowed) {
+	size_t count = 0U;
+	size_t idx = 1U;
+	bool done = false;
+
+	while ((!done) && (count < capacity)) {
+		const char* comma = static_cast<const char*>(std::memchr(sentence + idx, ',', star - idx));
+
+		fields[count++] = idx;
+
+		if (comma == nullptr) {
+			done = true;
+		} else {
+			idx = size_t(comma - sentence) + 1U;
+		}
+	}
+
+	(*overflowed) = (!done);
+
+	return count;
+}
+
+bool WarGrey::DTPM::nmea_subscribed(unsigned int tag, const unsigned int subscriptions[], size_t n) {
+	bool subscribed = (subscriptions == nullptr);
+
+	for (size_t idx = 0; (!subscribed) && (idx < n); idx++) {
+		subscribed = (subscriptions[idx] == tag);
+	}
+
+	return subscribed;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+namespace WarGrey::DTPM {
+	/** NOTE
+	 * These kernels work on the raw bytes of NMEA 0183 sentences (including the encapsulated `!AIVDM`),
+	 *   fields are reported as offsets into the original buffer, so that nothing is copied
+	 *   until the receiver really needs the value.
+	 *
+	 * Sentences are identified by packed 3-char tags regardless of the talker,
+	 *   sentences whose tags are not subscribed are dropped right after the checksum,
+	 *   e.g. GSA/GSV/ZDA/GLL are no-ops in `Compass`.
+	 *
+	 * The file does not depend on the platform so that the replay benchmark could be run on Linux.
+	 * It is not part of the application yet, sentences of `Compass` and `Transponder` are still parsed by
+	 *   the GPS/AIS clients of the submodule, which expose no hook for the raw bytes.
+	 */
+	static const size_t nmea_max_field_count = 32U;
+
+	constexpr unsigned int nmea_tag(char c0, char c1, char c2) {
+		return (((unsigned int)((unsigned char)c0)) << 16U)
+			| (((unsigned int)((unsigned char)c1)) << 8U)
+			| ((unsigned int)((unsigned char)c2));
+	}
+
+	static const unsigned int NMEA_GGA = nmea_tag('G', 'G', 'A');
+	static const unsigned int NMEA_VTG = nmea_tag('V', 'T', 'G');
+	static const unsigned int NMEA_HDT = nmea_tag('H', 'D', 'T');
+	static const unsigned int NMEA_ROT = nmea_tag('R', 'O', 'T');
+	static const unsigned int NMEA_GLL = nmea_tag('G', 'L', 'L');
+	static const unsigned int NMEA_GSA = nmea_tag('G', 'S', 'A');
+	static const unsigned int NMEA_GSV = nmea_tag('G', 'S', 'V');
+	static const unsigned int NMEA_ZDA = nmea_tag('Z', 'D', 'A');
+	static const unsigned int NMEA_VDM = nmea_tag('V', 'D', 'M');
+	static const unsigned int NMEA_VDO = nmea_tag('V', 'D', 'O');
+
+	static const unsigned int compass_nmea_subscriptions[] = { NMEA_GGA, NMEA_VTG, NMEA_HDT, NMEA_ROT };
+	static const unsigned int transponder_nmea_subscriptions[] = { NMEA_VDM, NMEA_VDO };
+
+	unsigned char nmea_checksum(const char* body, size_t size);
+	unsigned char nmea_checksum_bytewise(const char* body, size_t size);
+
+	/**
+	 * returns the position of the '*' if the sentence is well-formed and the checksum matches, otherwise returns `0`.
+	 */
+	size_t nmea_sentence_validate(const char* sentence, size_t size);
+	unsigned int nmea_sentence_tag(const char* sentence, size_t size);
+
+	/**
+	 * returns the number of fields, `overflowed` is set if the sentence has more fields than `capacity`,
+	 *   in which case the rest of the sentence is not tokenized.
+	 */
+	size_t nmea_sentence_tokenize(const char* sentence, size_t star, size_t fields[], size_t capacity, bool* overflowed);
+
+	bool nmea_subscribed(unsigned int tag, const unsigned int subscriptions[], size_t n);
+
+	template<size_t N>
+	bool nmea_subscribed(unsigned int tag, const unsigned int (&subscriptions)[N]) {
+		return nmea_subscribed(tag, subscriptions, N);
+	}
+
+	/**
+	 * `on_sentence(tag, sentence, fields, field_count)`, `fields[i]` is the offset of the i-th field relative to `sentence`,
+	 *   the field ends right before the next ',' (or the '*' for the last one).
+	 * `subscriptions` being `nullptr` means all sentences are wanted.
+	 * Sentences that are malformed or have more than `nmea_max_field_count` fields are counted in `discarded`,
+	 *   the latter are also counted in `overflowed`.
+	 * returns the number of bytes consumed, the incomplete tail should be prepended to the next read.
+	 */
+	template<typename Dispatch>
+	size_t nmea_scan(const char* buffer, size_t size, const unsigned int subscriptions[], size_t n
+		, Dispatch on_sentence, size_t* discarded = nullptr, size_t* overflowed = nullptr) {
+		size_t fields[nmea_max_field_count];
+		size_t idx = 0U;
+
+		while (idx < size) {
+			const char* line = buffer + idx;
+			const char* eol = static_cast<const char*>(std::memchr(line, '\n', size - idx));
+			size_t length, offset;
+
+			if (eol == nullptr) {
+				break;
+			}
+
+			length = size_t(eol - line);
+			offset = 0U;
+
+			while ((offset < length) && (line[offset] != '$') && (line[offset] != '!')) {
+				offset++;
+			}
+
+			if (offset < length) {
+				const char* sentence = line + offset;
+				size_t star = nmea_sentence_validate(sentence, length - offset);
+				unsigned int tag = ((star > 0U) ? nmea_sentence_tag(sentence, star) : 0U);
+
+				bool dispatched = false;
+
+				if ((star > 0U) && nmea_subscribed(tag, subscriptions, n)) {
+					bool overflow = false;
+					size_t count = nmea_sentence_tokenize(sentence, star, fields, nmea_max_field_count, &overflow);
+
+					if (!overflow) {
+						on_sentence(tag, sentence, fields, count);
+						dispatched = true;
+					} else if (overflowed != nullptr) {
+						(*overflowed) += 1U;
+					}
+				}
+
+				if ((!dispatched) && (discarded != nullptr)) {
+					(*discarded) += 1U;
+				}
+			}
+
+			idx = size_t(eol - buffer) + 1U;
+		}
+
+		return idx;
+	}
+}
@@ -0,0 +1,157 @@
+/**
+ * Replay benchmark for the NMEA 0183 kernels, it runs on Linux without the UWP runtime:
+ *
+ *   g++ -std=c++17 -O2 -o nmea_replay nmea_replay.cpp nmea.cpp
+ *   ./nmea_replay [-n rounds] gps.log ais.log ...
+ *
+ * Logs are raw captures of the MOXA TCP streams (one sentence per line, e.g. `nc moxa 4002 > gps.log`),
+ *   all of them are loaded into memory before timing, so that only the parsing is measured.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "nmea.hpp"
+
+using namespace WarGrey::DTPM;
+
+/*************************************************************************************************/
+static const unsigned int subscriptions[] = { NMEA_GGA, NMEA_VTG, NMEA_HDT, NMEA_ROT, NMEA_VDM, NMEA_VDO };
+
+static bool load_log(const char* path, std::string& buffer) {
+	FILE* log = fopen(path, "rb");
+	bool okay = (log != nullptr);
+
+	if (okay) {
+		char chunk[64 * 1024];
+		size_t size = 0U;
+
+		while ((size = fread(chunk, 1U, sizeof(chunk), log)) > 0U) {
+			buffer.append(chunk, size);
+		}
+
+		if ((buffer.size() > 0U) && (buffer.back() != '\n')) {
+			buffer.push_back('\n');
+		}
+
+		fclose(log);
+	}
+
+	return okay;
+}
+
+/**
+ * The conventional way: copy the line, check the sum byte by byte and split fields into strings.
+ */
+static size_t copying_parse(const std::string& buffer, size_t* fields) {
+	size_t sentences = 0U;
+	size_t idx = 0U;
+
+	while (idx < buffer.size()) {
+		size_t eol = buffer.find('\n', idx);
+		std::string line = buffer.substr(idx, eol - idx);
+		size_t head = line.find_first_of("$!");
+		size_t star = line.rfind('*');
+
+		idx = eol + 1U;
+
+		if ((head != std::string::npos) && (star != std::string::npos) && (star > head) && (star + 2U < line.size())) {
+			unsigned char expected = (unsigned char)(std::strtoul(line.substr(star + 1U, 2U).c_str(), nullptr, 16));
+
+			if (nmea_checksum_bytewise(line.c_str() + head + 1U, star - head - 1U) == expected) {
+				std::vector<std::string> tokens;
+				size_t start = head + 1U;
+
+				for (size_t comma = line.find(',', start); comma < star; comma = line.find(',', start)) {
+					tokens.push_back(line.substr(start, comma - start));
+					start = comma + 1U;
+				}
+
+				tokens.push_back(line.substr(start, star - start));
+				(*fields) += tokens.size();
+				sentences++;
+			}
+		}
+	}
+
+	return sentences;
+}
+
+static size_t zero_copy_parse(const std::string& buffer, const unsigned int subscriptions[], size_t n, size_t* fields, size_t* discarded) {
+	size_t sentences = 0U;
+
+	nmea_scan(buffer.data(), buffer.size(), subscriptions, n,
+		[&](unsigned int, const char*, size_t[], size_t count) {
+			(*fields) += count;
+			sentences++;
+		}, discarded);
+
+	return sentences;
+}
+
+/*************************************************************************************************/
+template<typename Parse>
+static void run(const char* name, size_t rounds, size_t lines, size_t bytes, Parse parse) {
+	size_t sentences = 0U;
+	size_t fields = 0U;
+	size_t discarded = 0U;
+	auto start = std::chrono::steady_clock::now();
+
+	for (size_t r = 0; r < rounds; r++) {
+		sentences += parse(&fields, &discarded);
+	}
+
+	{ // report
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		double seconds = elapsed.count();
+
+		printf("%-24s %12.0f lines/s %12.0f dispatched/s %10.2f MB/s (dispatched: %zu, discarded: %zu, fields: %zu)\n",
+			name, double(lines * rounds) / seconds, double(sentences) / seconds,
+			double(bytes * rounds) / seconds / 1048576.0,
+			sentences / rounds, discarded / rounds, fields / rounds);
+	}
+}
+
+int main(int argc, char* argv[]) {
+	std::string buffer;
+	size_t rounds = 20U;
+	size_t lines = 0U;
+
+	for (int idx = 1; idx < argc; idx++) {
+		if ((strcmp(argv[idx], "-n") == 0) && (idx + 1 < argc)) {
+			rounds = size_t(std::strtoul(argv[++idx], nullptr, 10));
+		} else if (!load_log(argv[idx], buffer)) {
+			fprintf(stderr, "failed to load %s\n", argv[idx]);
+			return 1;
+		}
+	}
+
+	if ((buffer.size() == 0U) || (rounds == 0U)) {
+		fprintf(stderr, "usage: %s [-n rounds] nmea.log ...\n", argv[0]);
+		return 1;
+	}
+
+	for (char ch : buffer) {
+		lines += ((ch == '\n') ? 1U : 0U);
+	}
+
+	printf("%zu lines, %zu bytes, %zu rounds\n", lines, buffer.size(), rounds);
+
+	run("copying", rounds, lines, buffer.size(), [&](size_t* fields, size_t*) {
+		return copying_parse(buffer, fields);
+	});
+
+	run("zero-copy", rounds, lines, buffer.size(), [&](size_t* fields, size_t* discarded) {
+		return zero_copy_parse(buffer, nullptr, 0U, fields, discarded);
+	});
+
+	run("zero-copy, subscribed", rounds, lines, buffer.size(), [&](size_t* fields, size_t* discarded) {
+		return zero_copy_parse(buffer, subscriptions, sizeof(subscriptions) / sizeof(unsigned int), fields, discarded);
+	});
+
+	return 0;
+}
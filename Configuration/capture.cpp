@@ -0,0 +1,166 @@
+#include <ppltasks.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+#include "capture.hpp"
+#include "configuration.hpp"
+
+using namespace WarGrey::SCADA;
+using namespace WarGrey::GYDM;
+
+using namespace Concurrency;
+
+using namespace Windows::Storage;
+
+using namespace Microsoft::Graphics::Canvas;
+
+/*************************************************************************************************/
+namespace {
+	private struct CaptureJob {
+		CanvasRenderTarget^ snapshot;
+		Platform::String^ path;
+	};
+
+	private class CapturePipeline {
+	public:
+		CapturePipeline(Syslog* logger, size_t capacity) : logger(logger), capacity(capacity), generation(0U) {
+			this->logger->reference();
+		}
+
+		~CapturePipeline() noexcept {
+			this->shutdown();
+			this->logger->destroy();
+		}
+
+	public:
+		Syslog* get_logger() {
+			return this->logger;
+		}
+
+		bool enqueue(CanvasRenderTarget^ snapshot, Platform::String^ filename) {
+			bool accepted = false;
+
+			{ std::unique_lock<std::mutex> lock(this->section);
+				if (!this->worker.joinable()) {
+					size_t generation = this->generation;
+
+					this->worker = std::thread([this, generation]() { this->run(generation); });
+				}
+
+				if (this->jobs.size() < this->capacity) {
+					CaptureJob job;
+
+					job.snapshot = snapshot;
+					job.path = ApplicationData::Current->LocalFolder->Path + "\\" + filename;
+					this->jobs.push_back(job);
+					accepted = true;
+				}
+			}
+
+			if (accepted) {
+				this->available.notify_one();
+			} else {
+				this->logger->log_message(Log::Warning, L"too many pending screenshots, %s is dropped", filename->Data());
+			}
+
+			return accepted;
+		}
+
+		void shutdown() {
+			std::unique_lock<std::mutex> lock(this->section);
+
+			if (this->worker.joinable()) {
+				std::thread worker;
+
+				// an older worker exits once the queue is drained, even if a newer one has already started
+				this->generation += 1U;
+				this->worker.swap(worker);
+				this->available.notify_all();
+
+				lock.unlock();
+				worker.join();
+			}
+		}
+
+	private:
+		void run(size_t generation) {
+			bool terminated = false;
+
+			while (!terminated) {
+				CaptureJob job;
+				bool ready = false;
+
+				{ std::unique_lock<std::mutex> lock(this->section);
+					this->available.wait(lock, [this, generation]() { return ((this->generation != generation) || (!this->jobs.empty())); });
+
+					// pending screenshots are still saved before exiting
+					if (!this->jobs.empty()) {
+						job = this->jobs.front();
+						this->jobs.pop_front();
+						ready = true;
+					} else {
+						terminated = (this->generation != generation);
+					}
+				}
+
+				if (ready) {
+					this->save(job);
+				}
+			}
+		}
+
+		void save(CaptureJob& job) {
+			try {
+				create_task(job.snapshot->SaveAsync(job.path, CanvasBitmapFileFormat::Png)).wait();
+				this->logger->log_message(Log::Notice, L"screenshot has been saved: %s", job.path->Data());
+			} catch (Platform::Exception^ e) {
+				this->logger->log_message(Log::Warning, L"failed to save screenshot %s: %s", job.path->Data(), e->Message->Data());
+			}
+		}
+
+	private:
+		Syslog* logger;
+		std::deque<CaptureJob> jobs;
+		std::mutex section;
+		std::condition_variable available;
+		std::thread worker;
+		size_t capacity;
+		size_t generation;
+	};
+}
+
+/*************************************************************************************************/
+static CapturePipeline* the_pipeline = nullptr;
+static std::mutex the_pipeline_section;
+
+static CapturePipeline* capture_pipeline() {
+	std::unique_lock<std::mutex> lock(the_pipeline_section);
+
+	if (the_pipeline == nullptr) {
+		the_pipeline = new CapturePipeline(make_system_logger(default_logging_level, "Capture"), capture_queue_capacity);
+	}
+
+	return the_pipeline;
+}
+
+Syslog* WarGrey::SCADA::capture_logger() {
+	return capture_pipeline()->get_logger();
+}
+
+bool WarGrey::SCADA::capture_enqueue(CanvasRenderTarget^ snapshot, Platform::String^ filename) {
+	return capture_pipeline()->enqueue(snapshot, filename);
+}
+
+void WarGrey::SCADA::capture_pipeline_shutdown() {
+	CapturePipeline* pipeline = nullptr;
+
+	{ std::unique_lock<std::mutex> lock(the_pipeline_section);
+		pipeline = the_pipeline;
+	}
+
+	if (pipeline != nullptr) {
+		pipeline->shutdown();
+	}
+}
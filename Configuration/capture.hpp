@@ -0,0 +1,27 @@
+#pragma once
+
+#include "syslog.hpp"
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * Taking the snapshot is cheap since it is just drawing the planet once more into an offscreen target,
+	 *   but reading the pixels back from GPU, encoding the PNG and writing the file are not,
+	 *   so the snapshot is handed over to a single worker thread through a bounded queue.
+	 *
+	 * Snapshots are dropped when the queue is full, screenshots are never worth stalling
+	 *   the UI thread (and therefore the PLC confirmations that wait on the critical section).
+	 *
+	 * Outcomes are logged to `capture_logger()`, statuslines that care should be pushed as its receivers.
+	 *
+	 * `capture_pipeline_shutdown()` saves pending snapshots before returning,
+	 *   the worker will be restarted by the next `capture_enqueue()`.
+	 */
+	WarGrey::GYDM::Syslog* capture_logger();
+
+	/**
+	 * `filename` is relative to the local folder of the application.
+	 * returns `false` if the snapshot is dropped.
+	 */
+	bool capture_enqueue(Microsoft::Graphics::Canvas::CanvasRenderTarget^ snapshot, Platform::String^ filename);
+	void capture_pipeline_shutdown();
+}
@@ -33,13 +33,56 @@ static const unsigned short dtpm_plc_master_port = 2008;
 static Platform::String^ moxa_gateway = "192.168.3.242";
 static Platform::String^ plc_hostname = "192.168.3.242";
 
+// the hot-standby PLC connection, it could be another gateway or just another socket to the same one, `nullptr` disables it.
+static Platform::String^ plc_standby_hostname = nullptr;
+
 /*************************************************************************************************/
 static const unsigned int frame_per_second = 5U;
 static const unsigned int timemachine_frame_per_second = 4U;
 static const long long timemachine_speed = 2; // seconds per step
 static const long long plc_master_suicide_timeout = 4000;
+static const long long plc_standby_promotion_timeout = 1200; // a little longer than the polling interval
+static const bool plc_relay_over_slang = false; // consoles share one PLC poller, a dead poller costs up to the silence timeout
+static const long long plc_relay_silence_timeout = 2000;
+static const size_t plc_relay_keyframe_interval = 10U;
 static const long long plc_settings_pinfree_seconds = 600;
 static const long long gps_suicide_timeout = 4000;
+static const long long thumbnail_refresh_interval = 2000; // ms, thumbnails are redrawn at most 0.5 times per second
+
+static const long long frame_probe_report_interval = 60; // seconds
+static const bool frame_probe_overlay = false;
+
+static const size_t capture_queue_capacity = 4U; // pending screenshots, more are dropped
+static const size_t history_prefetch_depth = 3U; // history batches decoded ahead of the one being delivered
+static const size_t history_prefetch_batch = 4096U; // records, a rotated file is decoded in batches of this size
+static const size_t persistence_queue_capacity = 1024U;
+static const size_t persistence_batch_size = 64U; // intents written in one transaction
+static const size_t history_ring_capacity = 4U * 3600U; // records, about the last 4 hours at 1Hz
+static const unsigned int archive_block_size = 1024U; // records
+static const long long history_archive_age = 2LL; // rotation periods, older files are compacted into archives
+static const unsigned int history_archive_sweep = 7U; // aged periods checked on each rotation
+static const long long historian_heartbeat = 60LL * 1000LL; // ms, unchanged signals are still archived once a minute
+static const int sqlite3_busy_retry_limit = 200; // about 2s, with WAL only checkpoints and recovery keep the database busy
+static const char* const sqlite3_journal_mode = "WAL";
+static const unsigned int sqlite3_page_size = 4096U;
+static const long long sqlite3_journal_size_limit = 4LL * 1024LL * 1024LL; // bytes
+static const char* const sqlite3_telemetry_synchronous = "NORMAL"; // with WAL, only the latest transactions might be rolled back
+static const long long sqlite3_telemetry_mmap_size = 64LL * 1024LL * 1024LL; // bytes, per connection
+static const unsigned int sqlite3_telemetry_autocheckpoint = 1000U; // pages
+static const char* const sqlite3_journal_synchronous = "FULL";
+static const long long sqlite3_journal_mmap_size = 0LL;
+static const unsigned int sqlite3_journal_autocheckpoint = 100U; // pages
+
+static const size_t ais_target_capacity = 1024U;
+static const double ais_gridsize = 1852.0; // meters, one nautical mile
+static const double ais_visible_range = 1852.0 * 12.0;
+static const long long ais_classA_ttl = 360000; // ms
+static const long long ais_classB_ttl = 1080000;
+static const long long ais_batch_latency = 20LL; // ms, a burst is taken as over once the transponder has been quiet that long
+static const double ais_cpa_range = 1852.0 * 6.0; // meters, ships farther away are not taken as encounters
+static const double ais_cpa_warning = 500.0; // meters
+static const double ais_tcpa_limit = 1200.0; // seconds
+static const size_t ais_cpa_candidates = 8U;
 
 static const unsigned int diagnostics_caption_background = 0x8FBC8F;
 static const unsigned int diagnostics_caption_foreground = 0xF8F8FF;
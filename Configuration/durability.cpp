@@ -0,0 +1,66 @@
+#include <thread>
+#include <chrono>
+#include <string>
+#include <algorithm>
+
+#include "durability.hpp"
+#include "configuration.hpp"
+
+using namespace WarGrey::SCADA;
+
+/*************************************************************************************************/
+SQLite3Durability WarGrey::SCADA::durability_profile(DurabilityProfile profile) {
+	SQLite3Durability durability;
+
+	durability.journal_mode = sqlite3_journal_mode;
+	durability.page_size = sqlite3_page_size;
+	durability.journal_size_limit = sqlite3_journal_size_limit;
+
+	switch (profile) {
+	case DurabilityProfile::Journal: {
+		durability.synchronous = sqlite3_journal_synchronous;
+		durability.mmap_size = sqlite3_journal_mmap_size;
+		durability.wal_autocheckpoint = sqlite3_journal_autocheckpoint;
+	}; break;
+	default: {
+		durability.synchronous = sqlite3_telemetry_synchronous;
+		durability.mmap_size = sqlite3_telemetry_mmap_size;
+		durability.wal_autocheckpoint = sqlite3_telemetry_autocheckpoint;
+	}
+	}
+
+	return durability;
+}
+
+void WarGrey::SCADA::apply_durability(IDBSystem* dbc, DurabilityProfile profile) {
+	SQLite3Durability durability = durability_profile(profile);
+
+	if (profile != DurabilityProfile::Reader) {
+		dbc->exec("PRAGMA page_size = " + std::to_string(durability.page_size) + ";");
+		dbc->exec(std::string("PRAGMA journal_mode = ") + durability.journal_mode + ";");
+	}
+
+	dbc->exec(std::string("PRAGMA synchronous = ") + durability.synchronous + ";");
+	dbc->exec("PRAGMA mmap_size = " + std::to_string(durability.mmap_size) + ";");
+
+	if (profile != DurabilityProfile::Reader) {
+		dbc->exec("PRAGMA wal_autocheckpoint = " + std::to_string(durability.wal_autocheckpoint) + ";");
+		dbc->exec("PRAGMA journal_size_limit = " + std::to_string(durability.journal_size_limit) + ";");
+	}
+}
+
+void WarGrey::SCADA::checkpoint_durability(IDBSystem* dbc) {
+	// the previous file will not be written anymore, folding the WAL back so that it can be copied alone
+	dbc->exec("PRAGMA wal_checkpoint(TRUNCATE);");
+}
+
+int WarGrey::SCADA::durability_busy_handler(void* args, int count) {
+	int go_on = 0;
+
+	if (count < sqlite3_busy_retry_limit) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(std::min(count + 1, 10)));
+		go_on = 1;
+	}
+
+	return go_on;
+}
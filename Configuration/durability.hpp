@@ -0,0 +1,39 @@
+#pragma once
+
+#include "dbsystem.hpp"
+
+namespace WarGrey::SCADA {
+	private enum class DurabilityProfile {
+		Telemetry, // bulk history, losing the last few records on power failure is acceptable
+		Journal,   // alarms, every committed record must survive
+		Reader     // connections that only load or export history
+	};
+
+	private struct SQLite3Durability {
+		const char* journal_mode;
+		const char* synchronous;
+		unsigned int page_size;
+		long long mmap_size;
+		unsigned int wal_autocheckpoint; // pages
+		long long journal_size_limit;
+	};
+
+	/** NOTE
+	 * Rotated files are written by the persistence queue while history is being loaded from them,
+	 *   with WAL journaling, readers and the writer no longer block each other,
+	 *   hence the busy handler only has to wait out checkpoints and recovery, not spin forever.
+	 *
+	 * Profiles should be applied on opening and on rotation, before tables are created,
+	 *   otherwise the page size does not take effect.
+	 *
+	 * `mmap_size` and `synchronous` are settings of the connection rather than of the file,
+	 *   hence connections opened for loading or exporting apply the `Reader` profile,
+	 *   which only sets the per-connection settings and leaves the file as it is.
+	 */
+	WarGrey::SCADA::SQLite3Durability durability_profile(WarGrey::SCADA::DurabilityProfile profile);
+
+	void apply_durability(WarGrey::SCADA::IDBSystem* dbc, WarGrey::SCADA::DurabilityProfile profile);
+	void checkpoint_durability(WarGrey::SCADA::IDBSystem* dbc);
+
+	int durability_busy_handler(void* args, int count);
+}
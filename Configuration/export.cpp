@@ -0,0 +1,273 @@
+#include <filesystem>
+#include <memory>
+#include <cstdio>
+
+#include "export.hpp"
+#include "configuration.hpp"
+#include "durability.hpp"
+
+#include "sqlite3/rotation.hpp"
+#include "datum/time.hpp"
+
+using namespace WarGrey::SCADA;
+using namespace WarGrey::GYDM;
+
+using namespace Concurrency;
+
+using namespace Windows::Storage;
+
+/*************************************************************************************************/
+namespace {
+	private class CSVExportSink : public IHistoryExportSink {
+	public:
+		CSVExportSink(std::wstring path, std::vector<std::string>& columns)
+			: csv(path, std::ios::trunc), column_count(columns.size()), written(0ULL) {
+			this->csv << "timestamp";
+
+			for (auto it = columns.begin(); it != columns.end(); it++) {
+				this->csv << "," << (*it);
+			}
+
+			this->csv << std::endl;
+		}
+
+	public:
+		bool push(long long timepoint, const double* values) override {
+			char cell[32];
+
+			this->csv << timepoint;
+
+			for (size_t i = 0; i < this->column_count; i++) {
+				snprintf(cell, sizeof(cell), ",%.17g", values[i]);
+				this->csv << cell;
+			}
+
+			this->csv << '\n';
+
+			if (!this->csv.fail()) {
+				this->written++;
+			}
+
+			return !this->csv.fail();
+		}
+
+		bool close() override {
+			this->csv.close();
+
+			return !this->csv.fail();
+		}
+
+		unsigned long long rows() override {
+			return this->written;
+		}
+
+	private:
+		std::ofstream csv;
+		size_t column_count;
+		unsigned long long written;
+	};
+
+	private class ColumnarExportSink : public IHistoryExportSink {
+	public:
+		ColumnarExportSink(std::wstring path, std::vector<std::string>& columns)
+			: writer(path, (unsigned int)(columns.size()), archive_block_size) {}
+
+	public:
+		bool push(long long timepoint, const double* values) override {
+			this->writer.append(timepoint, values);
+
+			return this->writer.good();
+		}
+
+		bool close() override {
+			return this->writer.close();
+		}
+
+		unsigned long long rows() override {
+			return this->writer.count();
+		}
+
+	private:
+		ColumnarArchiveWriter writer;
+	};
+
+	private class BucketExportSink : public IHistoryExportSink {
+	public:
+		BucketExportSink(IHistoryExportSink* sink, size_t column_count, long long bucket_ms)
+			: sink(sink), sums(column_count, 0.0), means(column_count, 0.0), bucket_ms(bucket_ms), bucket(0LL), count(0U) {}
+
+		virtual ~BucketExportSink() noexcept {
+			delete this->sink;
+		}
+
+	public:
+		bool push(long long timepoint, const double* values) override {
+			long long bucket = timepoint - (timepoint % this->bucket_ms);
+			bool go_on = true;
+
+			if ((this->count > 0U) && (bucket != this->bucket)) {
+				go_on = this->flush();
+			}
+
+			this->bucket = bucket;
+			this->count++;
+
+			for (size_t i = 0; i < this->sums.size(); i++) {
+				this->sums[i] += values[i];
+			}
+
+			return go_on;
+		}
+
+		bool close() override {
+			bool okay = this->flush();
+
+			return (this->sink->close() && okay);
+		}
+
+		unsigned long long rows() override {
+			return this->sink->rows();
+		}
+
+	private:
+		bool flush() {
+			bool go_on = true;
+
+			if (this->count > 0U) {
+				for (size_t i = 0; i < this->sums.size(); i++) {
+					this->means[i] = this->sums[i] / double(this->count);
+					this->sums[i] = 0.0;
+				}
+
+				go_on = this->sink->push(this->bucket, this->means.data());
+				this->count = 0U;
+			}
+
+			return go_on;
+		}
+
+	private:
+		IHistoryExportSink* sink;
+		std::vector<double> sums;
+		std::vector<double> means;
+		long long bucket_ms;
+		long long bucket;
+		unsigned int count;
+	};
+
+	private class GuardedExportSink : public IHistoryExportSink {
+	public:
+		GuardedExportSink(IHistoryExportSink* sink, cancellation_token token) : failed(false), sink(sink), token(token) {}
+
+		virtual ~GuardedExportSink() noexcept {
+			delete this->sink;
+		}
+
+	public:
+		bool push(long long timepoint, const double* values) override {
+			bool go_on = ((!this->token.is_canceled()) && (!this->failed));
+
+			if (go_on) {
+				go_on = this->sink->push(timepoint, values);
+				this->failed = !go_on;
+			}
+
+			return go_on;
+		}
+
+		bool close() override {
+			if (!this->sink->close()) {
+				this->failed = true;
+			}
+
+			return !this->failed;
+		}
+
+		unsigned long long rows() override {
+			return this->sink->rows();
+		}
+
+		bool cancelled() {
+			return this->token.is_canceled();
+		}
+
+	public:
+		bool failed;
+
+	private:
+		IHistoryExportSink* sink;
+		cancellation_token token;
+	};
+}
+
+/*************************************************************************************************/
+task<unsigned long long> WarGrey::SCADA::history_export_async(Platform::String^ filename, HistoryExportFormat format
+	, std::vector<std::string> columns, std::vector<Platform::String^> sources, long long open_ms, long long close_ms, long long bucket_ms
+	, std::function<void(IDBSystem*, long long, long long, IHistoryExportSink*)> dump, cancellation_token token, Syslog* logger) {
+	Platform::String^ path = ApplicationData::Current->LocalFolder->Path + "\\" + filename;
+
+	return create_task([=]() mutable {
+		IHistoryExportSink* sink = nullptr;
+		std::unique_ptr<GuardedExportSink> guard;
+		unsigned long long rows = 0ULL;
+		double ms = current_inexact_milliseconds();
+		bool completed = false;
+		std::error_code ec;
+
+		switch (format) {
+		case HistoryExportFormat::Columnar: sink = new ColumnarExportSink(path->Data(), columns); break;
+		default: sink = new CSVExportSink(path->Data(), columns); break;
+		}
+
+		if (bucket_ms > 0LL) {
+			sink = new BucketExportSink(sink, columns.size(), bucket_ms);
+		}
+
+		// the guard owns the chain of sinks, which are closed (and the file is released) however the export ends
+		guard.reset(new GuardedExportSink(sink, token));
+
+		try {
+			for (auto it = sources.begin(); (it != sources.end()) && (!guard->cancelled()) && (!guard->failed); it++) {
+				ColumnarArchiveReader reader(columnar_archive_name(*it)->Data());
+
+				if (reader.ready()) {
+					reader.foreach(open_ms, close_ms, true, [&](long long timepoint, const double* values) {
+						return guard->push(timepoint, values);
+					});
+				} else if (std::filesystem::exists(std::filesystem::path((*it)->Data()), ec)) {
+					std::unique_ptr<SQLite3> dbc(new SQLite3((*it)->Data(), logger));
+
+					dbc->set_busy_handler(durability_busy_handler);
+					apply_durability(dbc.get(), DurabilityProfile::Reader);
+					dump(dbc.get(), open_ms, close_ms, guard.get());
+				}
+			}
+
+			completed = (guard->close() && (!guard->cancelled()));
+		} catch (Platform::Exception^ e) {
+			logger->log_message(Log::Warning, L"failed to export to %s: %s", path->Data(), e->Message->Data());
+			guard.reset();
+			std::filesystem::remove(std::filesystem::path(path->Data()), ec);
+
+			throw;
+		}
+
+		rows = guard->rows();
+		guard.reset();
+
+		if (completed) {
+			logger->log_message(Log::Info, L"exported %llu rows to %s within %lfms",
+				rows, path->Data(), current_inexact_milliseconds() - ms);
+		} else {
+			std::filesystem::remove(std::filesystem::path(path->Data()), ec);
+
+			if (token.is_canceled()) {
+				logger->log_message(Log::Notice, L"exporting to %s is cancelled after %llu rows, the file is removed", path->Data(), rows);
+			} else {
+				logger->log_message(Log::Warning, L"failed to export to %s after %llu rows, the file is removed", path->Data(), rows);
+			}
+		}
+
+		return rows;
+	}, token);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <ppltasks.h>
+#include <functional>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "archive.hpp"
+
+#include "dbsystem.hpp"
+#include "syslog.hpp"
+
+namespace WarGrey::SCADA {
+	private enum class HistoryExportFormat { CSV, Columnar };
+
+	private class IHistoryExportSink abstract {
+	public:
+		virtual ~IHistoryExportSink() noexcept {}
+
+	public:
+		/**
+		 * returns `false` if the export should be stopped (cancelled or failed).
+		 */
+		virtual bool push(long long timepoint, const double* values) = 0;
+
+		/**
+		 * returns `false` if the pending rows cannot be written.
+		 */
+		virtual bool close() = 0;
+
+	public:
+		/**
+		 * returns the number of rows written into the file, which is not the number of records pushed if bucketed.
+		 */
+		virtual unsigned long long rows() = 0;
+	};
+
+	/** NOTE
+	 * Ranges are exported period by period, each period is read from its archive if it has been compacted,
+	 *   otherwise from its SQLite file through the cursor `dump` made by the datalet.
+	 *
+	 * Records are streamed into the sink one by one, memory usage does not depend on the length of the range.
+	 * If `bucket_ms` is positive, records are averaged in buckets of that length before written.
+	 *
+	 * The task returns the number of rows written, `filename` is relative to the local folder of the application.
+	 * The file is removed if the export is cancelled or fails, exceptions raised by `dump` are rethrown.
+	 */
+	Concurrency::task<unsigned long long> history_export_async(Platform::String^ filename,
+		WarGrey::SCADA::HistoryExportFormat format, std::vector<std::string> columns,
+		std::vector<Platform::String^> sources, long long open_ms, long long close_ms, long long bucket_ms,
+		std::function<void(WarGrey::SCADA::IDBSystem*, long long, long long, WarGrey::SCADA::IHistoryExportSink*)> dump,
+		Concurrency::cancellation_token token, WarGrey::GYDM::Syslog* logger);
+}
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <cmath>
+
+#include "historian.hpp"
+
+using namespace WarGrey::SCADA;
+
+/*************************************************************************************************/
+SignalCompressor::SignalCompressor(SignalCompression method, double deviation, long long heartbeat_ms)
+	: method(method), deviation(std::fabs(deviation)), heartbeat(heartbeat_ms), started(false) {
+	/** NOTE
+	 * The line between two archived points may deviate from the best line within the doors by the width of the doors,
+	 *   hence the half width, which keeps the interpolated value within `deviation` of the original one.
+	 */
+	this->door = this->deviation * 0.5;
+}
+
+bool SignalCompressor::push(long long timepoint, double value, long long* archived_timepoint, double* archived_value) {
+	long long pivot_timepoint = timepoint;
+	double pivot_value = value;
+	bool archiving = false;
+
+	if (!this->started) {
+		this->started = true;
+		archiving = true;
+	} else if (timepoint > this->last_timepoint) {
+		bool expired = ((timepoint - this->archived_timepoint) >= this->heartbeat);
+
+		if (this->method == SignalCompression::Deadband) {
+			archiving = (expired || (std::fabs(value - this->archived_value) > this->deviation));
+		} else {
+			double span = double(timepoint - this->archived_timepoint);
+
+			this->upper_slope = std::max(this->upper_slope, (value - this->archived_value - this->door) / span);
+			this->lower_slope = std::min(this->lower_slope, (value - this->archived_value + this->door) / span);
+
+			// once the doors open, the previous point is the last one that the line can pass through
+			archiving = (expired || (this->upper_slope > this->lower_slope));
+
+			if (archiving && (this->last_timepoint > this->archived_timepoint)) {
+				pivot_timepoint = this->last_timepoint;
+				pivot_value = this->last_value;
+			}
+		}
+	}
+
+	if (archiving) {
+		this->archive(pivot_timepoint, pivot_value);
+
+		if (pivot_timepoint < timepoint) { // the doors swing again from the pivot
+			double span = double(timepoint - pivot_timepoint);
+
+			this->upper_slope = (value - pivot_value - this->door) / span;
+			this->lower_slope = (value - pivot_value + this->door) / span;
+		}
+
+		(*archived_timepoint) = pivot_timepoint;
+		(*archived_value) = pivot_value;
+	}
+
+	this->last_timepoint = timepoint;
+	this->last_value = value;
+
+	return archiving;
+}
+
+bool SignalCompressor::flush(long long* archived_timepoint, double* archived_value) {
+	bool archiving = (this->started && (this->last_timepoint > this->archived_timepoint));
+
+	if (archiving) {
+		this->archive(this->last_timepoint, this->last_value);
+
+		(*archived_timepoint) = this->last_timepoint;
+		(*archived_value) = this->last_value;
+	}
+
+	return archiving;
+}
+
+void SignalCompressor::archive(long long timepoint, double value) {
+	this->archived_timepoint = timepoint;
+	this->archived_value = value;
+	this->upper_slope = -HUGE_VAL;
+	this->lower_slope = +HUGE_VAL;
+}
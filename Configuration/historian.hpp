@@ -0,0 +1,46 @@
+#pragma once
+
+namespace WarGrey::SCADA {
+	private enum class SignalCompression { Deadband, SwingingDoor };
+
+	/** NOTE
+	 * Deadband archives a value once it moves away from the last archived one by more than `deviation`.
+	 * Swinging door archives the turning points only, every value in between stays within `deviation`
+	 *   of the straight line drawn through the archived points, so trends are reconstructed by linear interpolation.
+	 *
+	 * Either way, an unchanged signal is still archived once per `heartbeat_ms` so that gaps can be told from plateaus.
+	 */
+	private class SignalCompressor {
+	public:
+		SignalCompressor(WarGrey::SCADA::SignalCompression method, double deviation, long long heartbeat_ms);
+
+	public:
+		/**
+		 * returns `true` if a point should be archived, which is not necessarily the one just pushed.
+		 */
+		bool push(long long timepoint, double value, long long* archived_timepoint, double* archived_value);
+
+		/**
+		 * returns `true` if the last pushed point has not been archived.
+		 */
+		bool flush(long long* archived_timepoint, double* archived_value);
+
+	private:
+		void archive(long long timepoint, double value);
+
+	private:
+		WarGrey::SCADA::SignalCompression method;
+		double deviation;
+		double door;
+		long long heartbeat;
+
+	private:
+		long long archived_timepoint;
+		double archived_value;
+		long long last_timepoint;
+		double last_value;
+		double upper_slope;
+		double lower_slope;
+		bool started;
+	};
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include <mutex>
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * Records saved since the application started are also kept in memory, at most `capacity` of them,
+	 *   windows that begin after the oldest record in the ring are served without touching the database.
+	 *
+	 * Records are pushed by the thread that saves them (PLC or GPS) and read by the loader,
+	 *   timestamps (in milliseconds) are expected to be non-decreasing.
+	 *
+	 * Readers copy the requested range out of the ring and deliver it after unlocking,
+	 *   so that slow receivers never block the thread that saves records.
+	 */
+	template<typename Record>
+	private class HistoryRing {
+	public:
+		HistoryRing(size_t capacity) : capacity(capacity) {}
+
+	public:
+		void push(long long timepoint, const Record& record) {
+			std::unique_lock<std::mutex> lock(this->section);
+
+			if (this->records.size() >= this->capacity) {
+				this->records.pop_front();
+			}
+
+			this->records.push_back(std::pair<long long, Record>(timepoint, record));
+		}
+
+		bool covers(long long open_timepoint, long long close_timepoint) {
+			std::unique_lock<std::mutex> lock(this->section);
+
+			return ((!this->records.empty()) && (this->records.front().first <= std::min(open_timepoint, close_timepoint)));
+		}
+
+		/**
+		 * `step` is applied to records within [open_timepoint, close_timepoint], it returns `false` to stop.
+		 */
+		template<typename F>
+		void foreach(long long open_timepoint, long long close_timepoint, bool asc, F step) {
+			long long lower = std::min(open_timepoint, close_timepoint);
+			long long upper = std::max(open_timepoint, close_timepoint);
+			std::vector<Record> range;
+			size_t total = 0U;
+			bool go_on = true;
+
+			{ std::unique_lock<std::mutex> lock(this->section);
+				auto open = std::lower_bound(this->records.begin(), this->records.end(), lower,
+					[](const std::pair<long long, Record>& self, long long timepoint) { return self.first < timepoint; });
+				auto close = std::upper_bound(open, this->records.end(), upper,
+					[](long long timepoint, const std::pair<long long, Record>& self) { return timepoint < self.first; });
+
+				range.reserve(std::distance(open, close));
+
+				for (auto it = open; it != close; it++) {
+					range.push_back(it->second);
+				}
+			}
+
+			total = range.size();
+
+			for (size_t i = 0; go_on && (i < total); i++) {
+				go_on = step(range[asc ? i : (total - i - 1)]);
+			}
+		}
+
+	private:
+		std::deque<std::pair<long long, Record>> records;
+		std::mutex section;
+		size_t capacity;
+	};
+}
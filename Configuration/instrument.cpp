@@ -0,0 +1,149 @@
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "instrument.hpp"
+
+using namespace WarGrey::SCADA;
+using namespace WarGrey::GYDM;
+
+/*************************************************************************************************/
+static const size_t FRAME_PROBE_SUBBUCKETS = 8U;
+
+static std::map<std::wstring, FrameProbe*> probes;
+static std::mutex probes_section;
+
+static size_t duration_bucket(unsigned long long us) {
+	size_t bucket = size_t(us);
+
+	if (us >= FRAME_PROBE_SUBBUCKETS) {
+		size_t msb = 3U;
+
+		while ((us >> (msb + 1U)) > 0ULL) {
+			msb++;
+		}
+
+		bucket = (msb - 2U) * FRAME_PROBE_SUBBUCKETS + size_t((us >> (msb - 3U)) & (FRAME_PROBE_SUBBUCKETS - 1U));
+	}
+
+	return ((bucket < FRAME_PROBE_BUCKETS) ? bucket : (FRAME_PROBE_BUCKETS - 1U));
+}
+
+static double bucket_duration(size_t bucket) {
+	unsigned long long us = bucket;
+
+	if (bucket >= FRAME_PROBE_SUBBUCKETS) {
+		size_t msb = bucket / FRAME_PROBE_SUBBUCKETS + 2U;
+
+		us = (FRAME_PROBE_SUBBUCKETS + (bucket % FRAME_PROBE_SUBBUCKETS)) << (msb - 3U);
+	}
+
+	return double(us) / 1000.0;
+}
+
+/*************************************************************************************************/
+FrameProbe::FrameProbe(Platform::String^ name) : name(name) {
+	this->reset();
+}
+
+void FrameProbe::count(FrameCounter which, unsigned long long n) {
+	this->counters[_I(which)].fetch_add(n, std::memory_order_relaxed);
+}
+
+void FrameProbe::sample_draw(double duration_ms) {
+	unsigned long long us = ((duration_ms > 0.0) ? (unsigned long long)(duration_ms * 1000.0) : 0ULL);
+
+	this->durations[duration_bucket(us)].fetch_add(1U, std::memory_order_relaxed);
+}
+
+void FrameProbe::rewind_draw() {
+	for (size_t idx = 0; idx < FRAME_PROBE_BUCKETS; idx++) {
+		this->durations[idx].store(0U, std::memory_order_relaxed);
+	}
+}
+
+void FrameProbe::reset() {
+	for (size_t idx = 0; idx < _N(FrameCounter); idx++) {
+		this->counters[idx].store(0ULL, std::memory_order_relaxed);
+	}
+
+	this->rewind_draw();
+}
+
+unsigned long long FrameProbe::counter(FrameCounter which) {
+	return this->counters[_I(which)].load(std::memory_order_relaxed);
+}
+
+unsigned long long FrameProbe::draw_samples() {
+	unsigned long long total = 0ULL;
+
+	for (size_t idx = 0; idx < FRAME_PROBE_BUCKETS; idx++) {
+		total += this->durations[idx].load(std::memory_order_relaxed);
+	}
+
+	return total;
+}
+
+double FrameProbe::draw_percentile(double p) {
+	unsigned long long total = this->draw_samples();
+	double duration = 0.0;
+
+	if (total > 0ULL) {
+		unsigned long long rank = (unsigned long long)(double(total) * p);
+		unsigned long long seen = 0ULL;
+
+		for (size_t idx = 0; idx < FRAME_PROBE_BUCKETS; idx++) {
+			seen += this->durations[idx].load(std::memory_order_relaxed);
+
+			if (seen > rank) {
+				duration = bucket_duration(idx);
+				break;
+			}
+		}
+	}
+
+	return duration;
+}
+
+/*************************************************************************************************/
+FrameProbe* WarGrey::SCADA::frame_probe(Platform::String^ name) {
+	std::unique_lock<std::mutex> lock(probes_section);
+	std::wstring key(name->Data());
+	auto maybe_probe = probes.find(key);
+	FrameProbe* probe = nullptr;
+
+	if (maybe_probe == probes.end()) {
+		probe = new FrameProbe(name);
+		probes.insert(std::pair<std::wstring, FrameProbe*>(key, probe));
+	} else {
+		probe = maybe_probe->second;
+	}
+
+	return probe;
+}
+
+void WarGrey::SCADA::frame_probe_count(Platform::String^ name, FrameCounter which, unsigned long long n) {
+	frame_probe(name)->count(which, n);
+}
+
+void WarGrey::SCADA::frame_probe_foreach(std::function<void(FrameProbe*)> do_with) {
+	std::unique_lock<std::mutex> lock(probes_section);
+
+	for (auto it = probes.begin(); it != probes.end(); it++) {
+		do_with(it->second);
+	}
+}
+
+void WarGrey::SCADA::frame_probe_reset() {
+	frame_probe_foreach([](FrameProbe* probe) { probe->reset(); });
+}
+
+void WarGrey::SCADA::frame_probe_report(Syslog* logger, Log level) {
+	frame_probe_foreach([=](FrameProbe* probe) {
+		logger->log_message(level, L"%s: %llu updates, %llu draws(p50: %.3fms, p99: %.3fms)",
+			probe->name->Data(), probe->counter(FrameCounter::Update), probe->counter(FrameCounter::Draw),
+			probe->draw_percentile(0.50), probe->draw_percentile(0.99));
+
+		probe->rewind_draw();
+	});
+}
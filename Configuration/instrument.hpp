@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+#include "datum/enum.hpp"
+
+#include "syslog.hpp"
+
+namespace WarGrey::SCADA {
+	private enum class FrameCounter { Update, Draw, _ };
+
+	static const size_t FRAME_PROBE_BUCKETS = 192U;
+
+	/** NOTE
+	 * Probes are created once and never destroyed, callers are free to cache them.
+	 *
+	 * Counting is just a relaxed atomic increment, and draw durations go into a log-linear histogram
+	 *   of fixed size (8 sub-buckets per octave of microseconds, the error of percentiles is under 12.5%),
+	 *   so that the instrumentation is cheap enough to stay enabled in production.
+	 *
+	 * Nothing here depends on the canvas, headless tests can read the counters directly.
+	 */
+	private class FrameProbe {
+	public:
+		FrameProbe(Platform::String^ name);
+
+	public:
+		void count(WarGrey::SCADA::FrameCounter which, unsigned long long n = 1ULL);
+		void sample_draw(double duration_ms);
+		void rewind_draw();
+		void reset();
+
+	public:
+		unsigned long long counter(WarGrey::SCADA::FrameCounter which);
+		unsigned long long draw_samples();
+		double draw_percentile(double p);
+
+	public:
+		Platform::String^ name;
+
+	private:
+		std::atomic<unsigned long long> counters[_N(WarGrey::SCADA::FrameCounter)];
+		std::atomic<unsigned int> durations[FRAME_PROBE_BUCKETS];
+	};
+
+	WarGrey::SCADA::FrameProbe* frame_probe(Platform::String^ name);
+	void frame_probe_count(Platform::String^ name, WarGrey::SCADA::FrameCounter which, unsigned long long n = 1ULL);
+	void frame_probe_foreach(std::function<void(WarGrey::SCADA::FrameProbe*)> do_with);
+	void frame_probe_reset();
+
+	/**
+	 * counters are cumulative, whereas percentiles are of the draws since the last report.
+	 */
+	void frame_probe_report(WarGrey::GYDM::Syslog* logger, WarGrey::GYDM::Log level = WarGrey::GYDM::Log::Notice);
+}
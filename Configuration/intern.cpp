@@ -0,0 +1,97 @@
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include "intern.hpp"
+
+#include "text.hpp"
+#include "brushes.hxx"
+
+using namespace WarGrey::SCADA;
+
+using namespace Microsoft::Graphics::Canvas::Text;
+using namespace Microsoft::Graphics::Canvas::Brushes;
+
+typedef std::tuple<std::wstring, float, bool> FontKey;
+typedef std::pair<unsigned int, double> BrushKey;
+
+/*************************************************************************************************/
+namespace {
+	// the pool is made on demand, some fonts and brushes are interned while initializing statics of other files
+	private struct InternPool {
+		std::map<FontKey, CanvasTextFormat^> fonts;
+		std::map<BrushKey, CanvasSolidColorBrush^> brushes;
+		std::mutex section;
+	};
+
+	InternPool* the_pool() {
+		static InternPool pool;
+
+		return &pool;
+	}
+}
+
+static CanvasTextFormat^ intern_font(Platform::String^ family, float size, bool bold) {
+	InternPool* pool = the_pool();
+	std::unique_lock<std::mutex> lock(pool->section);
+	FontKey key((family == nullptr) ? L"" : family->Data(), size, bold);
+	auto maybe_font = pool->fonts.find(key);
+	CanvasTextFormat^ font = nullptr;
+
+	if (maybe_font == pool->fonts.end()) {
+		if (family == nullptr) {
+			font = (bold ? make_bold_text_format(size) : make_text_format(size));
+		} else {
+			font = (bold ? make_bold_text_format(family, size) : make_text_format(family, size));
+		}
+
+		pool->fonts.insert(std::pair<FontKey, CanvasTextFormat^>(key, font));
+	} else {
+		font = maybe_font->second;
+	}
+
+	return font;
+}
+
+/*************************************************************************************************/
+CanvasTextFormat^ WarGrey::SCADA::intern_text_format(float size) {
+	return intern_font(nullptr, size, false);
+}
+
+CanvasTextFormat^ WarGrey::SCADA::intern_text_format(Platform::String^ family, float size) {
+	return intern_font(family, size, false);
+}
+
+CanvasTextFormat^ WarGrey::SCADA::intern_bold_text_format(float size) {
+	return intern_font(nullptr, size, true);
+}
+
+CanvasTextFormat^ WarGrey::SCADA::intern_bold_text_format(Platform::String^ family, float size) {
+	return intern_font(family, size, true);
+}
+
+CanvasSolidColorBrush^ WarGrey::SCADA::intern_brush(unsigned int rgb, double alpha) {
+	InternPool* pool = the_pool();
+	std::unique_lock<std::mutex> lock(pool->section);
+	BrushKey key(rgb, alpha);
+	auto maybe_brush = pool->brushes.find(key);
+	CanvasSolidColorBrush^ brush = nullptr;
+
+	if (maybe_brush == pool->brushes.end()) {
+		brush = Colours::make(rgb, alpha);
+		pool->brushes.insert(std::pair<BrushKey, CanvasSolidColorBrush^>(key, brush));
+	} else {
+		brush = maybe_brush->second;
+	}
+
+	return brush;
+}
+
+void WarGrey::SCADA::intern_pool_clear() {
+	InternPool* pool = the_pool();
+	std::unique_lock<std::mutex> lock(pool->section);
+
+	pool->fonts.clear();
+	pool->brushes.clear();
+}
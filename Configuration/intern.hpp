@@ -0,0 +1,22 @@
+#pragma once
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * Text formats and solid brushes are immutable once they are made (nobody is allowed to modify them),
+	 *   so pages, their timemachine copies and widgets could share the same instances,
+	 *   text formats are keyed by (family, size, weight) and brushes are keyed by the colour.
+	 *
+	 * `nullptr` family means the default family of `make_text_format`.
+	 *
+	 * After the device is lost or the DPI/theme is changed, just clear the pool,
+	 *   resources that are still held by graphlets are not affected.
+	 */
+	Microsoft::Graphics::Canvas::Text::CanvasTextFormat^ intern_text_format(float size);
+	Microsoft::Graphics::Canvas::Text::CanvasTextFormat^ intern_text_format(Platform::String^ family, float size);
+	Microsoft::Graphics::Canvas::Text::CanvasTextFormat^ intern_bold_text_format(float size);
+	Microsoft::Graphics::Canvas::Text::CanvasTextFormat^ intern_bold_text_format(Platform::String^ family, float size);
+
+	Microsoft::Graphics::Canvas::Brushes::CanvasSolidColorBrush^ intern_brush(unsigned int rgb, double alpha = 1.0);
+
+	void intern_pool_clear();
+}
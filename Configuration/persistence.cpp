@@ -0,0 +1,337 @@
+#include <set>
+#include <map>
+#include <algorithm>
+#include <cstring>
+
+#include "persistence.hpp"
+#include "durability.hpp"
+
+#include "datum/time.hpp"
+
+using namespace WarGrey::SCADA;
+using namespace WarGrey::GYDM;
+
+typedef std::deque<std::function<void(void)>> PersistenceContinuations;
+typedef std::map<IDBSystem*, PersistenceContinuations> PersistenceTransactions; // database => intents written in the transaction
+
+static void rollback_transaction(IDBSystem* dbc, Syslog* logger) {
+	try {
+		dbc->exec("ROLLBACK TRANSACTION;");
+	} catch (Platform::Exception^ e) {
+		logger->log_message(Log::Warning, L"failed to rollback: %s", e->Message->Data());
+	}
+}
+
+/**
+ * returns the number of written intents that are rolled back since their transactions fail to commit.
+ */
+static unsigned long long commit_transactions(PersistenceTransactions& transactions, PersistenceContinuations& committed, Syslog* logger) {
+	unsigned long long rolled_back = 0U;
+
+	for (auto it = transactions.begin(); it != transactions.end(); it++) {
+		try {
+			it->first->exec("COMMIT TRANSACTION;");
+
+			for (auto cit = it->second.begin(); cit != it->second.end(); cit++) {
+				if ((*cit) != nullptr) {
+					committed.push_back(*cit);
+				}
+			}
+		} catch (Platform::Exception^ e) {
+			logger->log_message(Log::Warning, L"failed to commit %llu intent(s): %s",
+				(unsigned long long)(it->second.size()), e->Message->Data());
+			rollback_transaction(it->first, logger);
+			rolled_back += it->second.size();
+		}
+	}
+
+	transactions.clear();
+
+	return rolled_back;
+}
+
+static void run_continuations(PersistenceContinuations& continuations, Syslog* logger) {
+	for (auto it = continuations.begin(); it != continuations.end(); it++) {
+		try {
+			(*it)();
+		} catch (Platform::Exception^ e) {
+			logger->log_message(Log::Warning, L"failed to continue after committing: %s", e->Message->Data());
+		}
+	}
+
+	continuations.clear();
+}
+
+static std::set<PersistenceQueue*> the_queues;
+static std::mutex the_queues_section;
+
+/*************************************************************************************************/
+PersistenceQueue::PersistenceQueue(Syslog* logger, PersistencePolicy policy, size_t capacity, size_t batch_size
+	, std::function<void(IDBSystem*)> prepare, std::function<void(void)> batch_committed)
+	: logger(logger), policy(policy), prepare(prepare), batch_committed(batch_committed), capacity(capacity), batch_size(batch_size)
+	, writing(0U), congested(false), terminated(false) {
+	memset(&this->statistics, 0, sizeof(PersistenceMetrics));
+
+	this->writer = std::thread([this]() { this->run(); });
+
+	{ std::unique_lock<std::mutex> lock(the_queues_section);
+		the_queues.insert(this);
+	}
+}
+
+PersistenceQueue::~PersistenceQueue() noexcept {
+	{ std::unique_lock<std::mutex> lock(the_queues_section);
+		the_queues.erase(this);
+	}
+
+	{ std::unique_lock<std::mutex> lock(this->section);
+		this->terminated = true;
+	}
+
+	this->available.notify_one();
+
+	if (this->writer.joinable()) {
+		this->writer.join();
+	}
+
+	this->logger->log_message(Log::Debug, L"persistence closed: %llu written, %llu failed, %llu dropped, %llu overflowed in %llu batches",
+		this->statistics.written, this->statistics.failed, this->statistics.dropped,
+		this->statistics.overflowed, this->statistics.batches);
+}
+
+bool PersistenceQueue::push(Platform::String^ dbpath, std::function<void(IDBSystem*)> intent, std::function<void(void)> committed) {
+	bool accepted = true;
+	bool congesting = false;
+
+	{ std::unique_lock<std::mutex> lock(this->section);
+		if (this->intents.size() >= this->capacity) {
+			congesting = !this->congested;
+			this->congested = true;
+
+			if (this->policy == PersistencePolicy::Lossy) {
+				this->statistics.dropped += 1U;
+				accepted = false;
+			} else {
+				this->statistics.overflowed += 1U;
+			}
+		}
+
+		if (accepted) {
+			this->intents.push_back({ dbpath, intent, committed });
+			this->statistics.enqueued += 1U;
+			this->statistics.high_water = std::max(this->statistics.high_water, this->intents.size());
+		}
+	}
+
+	if (congesting) {
+		this->logger->log_message(Log::Warning, L"persistence is congested, more than %u intents are pending",
+			(unsigned int)(this->capacity));
+	}
+
+	if (accepted) {
+		this->available.notify_one();
+	}
+
+	return accepted;
+}
+
+void PersistenceQueue::flush() {
+	std::unique_lock<std::mutex> lock(this->section);
+
+	this->drained.wait(lock, [this]() { return (this->intents.empty() && (this->writing == 0U)); });
+}
+
+PersistenceMetrics PersistenceQueue::metrics() {
+	std::unique_lock<std::mutex> lock(this->section);
+	PersistenceMetrics snapshot = this->statistics;
+
+	snapshot.pending = this->intents.size() + this->writing;
+
+	return snapshot;
+}
+
+/*************************************************************************************************/
+void PersistenceQueue::run() {
+	std::deque<PersistenceIntent> batch;
+	bool terminated = false;
+
+	while (!terminated) {
+		{ std::unique_lock<std::mutex> lock(this->section);
+			this->available.wait(lock, [this]() { return (this->terminated || (!this->intents.empty())); });
+
+			// accepted intents are always written before exiting
+			while ((!this->intents.empty()) && (batch.size() < this->batch_size)) {
+				batch.push_back(this->intents.front());
+				this->intents.pop_front();
+			}
+
+			this->writing = batch.size();
+			terminated = (this->terminated && batch.empty());
+		}
+
+		if (!batch.empty()) {
+			double ms = current_inexact_milliseconds();
+			bool relieved = false;
+
+			this->write(batch);
+			ms = current_inexact_milliseconds() - ms;
+
+			{ std::unique_lock<std::mutex> lock(this->section);
+				this->statistics.batches += 1U;
+				this->statistics.max_batch_ms = std::max(this->statistics.max_batch_ms, ms);
+				this->writing = 0U;
+
+				if (this->congested && (this->intents.size() < this->capacity / 2U)) {
+					this->congested = false;
+					relieved = true;
+				}
+			}
+
+			if (relieved) {
+				this->logger->log_message(Log::Notice, L"persistence is relieved");
+			}
+
+			batch.clear();
+		}
+
+		this->drained.notify_all();
+	}
+
+	this->disconnect(std::set<std::wstring>());
+}
+
+void PersistenceQueue::write(std::deque<PersistenceIntent>& batch) {
+	PersistenceTransactions transactions;
+	PersistenceContinuations continuations;
+	std::set<std::wstring> touched;
+	std::set<std::wstring> unavailables;
+	unsigned long long written = 0U;
+	unsigned long long failed = 0U;
+	unsigned long long rolled_back = 0U;
+
+	for (auto it = batch.begin(); it != batch.end(); it++) {
+		IDBSystem* dbc = nullptr;
+		bool writable = true;
+
+		if (it->dbpath == nullptr) {
+			// the intent might open another connection to a database being written in this batch,
+			//   and it should see the effects of all intents pushed before it
+			rolled_back += commit_transactions(transactions, continuations, this->logger);
+			run_continuations(continuations, this->logger);
+		} else {
+			std::wstring dbpath(it->dbpath->Data());
+
+			if (unavailables.find(dbpath) != unavailables.end()) {
+				writable = false;
+			} else {
+				dbc = this->connect(dbpath);
+				touched.insert(dbpath);
+
+				if (dbc == nullptr) {
+					unavailables.insert(dbpath);
+					writable = false;
+				} else if (transactions.find(dbc) == transactions.end()) {
+					try {
+						dbc->exec("BEGIN TRANSACTION;");
+						transactions.insert(PersistenceTransactions::value_type(dbc, PersistenceContinuations()));
+					} catch (Platform::Exception^ e) {
+						// intents of the file are failed for the rest of the batch
+						this->logger->log_message(Log::Warning, L"failed to begin transaction: %s", e->Message->Data());
+						unavailables.insert(dbpath);
+						writable = false;
+					}
+				}
+			}
+		}
+
+		if (writable) {
+			try {
+				it->write(dbc);
+				written += 1U;
+
+				if (dbc != nullptr) {
+					transactions[dbc].push_back(it->committed);
+				} else if (it->committed != nullptr) {
+					continuations.push_back(it->committed);
+				}
+			} catch (Platform::Exception^ e) {
+				this->logger->log_message(Log::Warning, L"failed to persist: %s", e->Message->Data());
+				failed += 1U;
+			}
+		} else {
+			failed += 1U;
+		}
+	}
+
+	rolled_back += commit_transactions(transactions, continuations, this->logger);
+	written -= rolled_back;
+	failed += rolled_back;
+
+	run_continuations(continuations, this->logger);
+
+	if ((written > 0U) && (this->batch_committed != nullptr)) {
+		try {
+			this->batch_committed();
+		} catch (Platform::Exception^ e) {
+			this->logger->log_message(Log::Warning, L"failed to continue after the batch: %s", e->Message->Data());
+		}
+	}
+
+	// files of the past periods are no longer written once the latest batch has moved on
+	this->disconnect(touched);
+
+	{ std::unique_lock<std::mutex> lock(this->section);
+		this->statistics.written += written;
+		this->statistics.failed += failed;
+	}
+}
+
+IDBSystem* PersistenceQueue::connect(const std::wstring& dbpath) {
+	auto maybe_dbc = this->connections.find(dbpath);
+	IDBSystem* dbc = nullptr;
+
+	if (maybe_dbc == this->connections.end()) {
+		ISQLite3* sqlite3 = nullptr;
+
+		try {
+			sqlite3 = new SQLite3(dbpath.c_str(), this->logger);
+			sqlite3->set_busy_handler(durability_busy_handler);
+			this->prepare(sqlite3);
+
+			this->connections.insert(std::pair<std::wstring, ISQLite3*>(dbpath, sqlite3));
+			dbc = sqlite3;
+		} catch (Platform::Exception^ e) {
+			this->logger->log_message(Log::Warning, L"failed to open %s: %s", dbpath.c_str(), e->Message->Data());
+
+			if (sqlite3 != nullptr) {
+				delete sqlite3;
+			}
+		}
+	} else {
+		dbc = maybe_dbc->second;
+	}
+
+	return dbc;
+}
+
+void PersistenceQueue::disconnect(const std::set<std::wstring>& keeps) {
+	auto it = this->connections.begin();
+
+	while (it != this->connections.end()) {
+		if (keeps.find(it->first) == keeps.end()) {
+			delete it->second;
+			it = this->connections.erase(it);
+		} else {
+			it++;
+		}
+	}
+}
+
+/*************************************************************************************************/
+void WarGrey::SCADA::persistence_flush_all() {
+	std::unique_lock<std::mutex> lock(the_queues_section);
+
+	for (auto it = the_queues.begin(); it != the_queues.end(); it++) {
+		(*it)->flush();
+	}
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <string>
+#include <map>
+#include <set>
+
+#include "dbsystem.hpp"
+#include "sqlite3/rotation.hpp"
+#include "syslog.hpp"
+
+namespace WarGrey::SCADA {
+	private enum class PersistencePolicy {
+		Lossless, // intents beyond the capacity are still accepted, but counted as overflowed
+		Lossy     // intents beyond the capacity are dropped
+	};
+
+	private struct PersistenceMetrics {
+		unsigned long long enqueued;
+		unsigned long long written;
+		unsigned long long failed;
+		unsigned long long dropped;
+		unsigned long long overflowed;
+		unsigned long long batches;
+		size_t pending;
+		size_t high_water;
+		double max_batch_ms;
+	};
+
+	private struct PersistenceIntent {
+		Platform::String^ dbpath;
+		std::function<void(WarGrey::SCADA::IDBSystem*)> write;
+		std::function<void(void)> committed;
+	};
+
+	/** NOTE
+	 * Datalets are saved from PLC and GPS callbacks, usually while the critical section of some planet is held,
+	 *   so that writes are queued as intents and performed by a single writer thread in the background.
+	 *
+	 * Intents are bound to the file they write into when they are pushed, the file is resolved from the timepoint
+	 *   of the record, rather than the current file of the rotative database, which might rotate before the intent runs.
+	 * The writer keeps its own connection to each file, prepared with `prepare` once opened, and closes the ones
+	 *   that the latest batch does not write into, so that it never shares a connection with the rotation.
+	 *
+	 * The writer drains at most `batch_size` intents each time, and wraps the intents of the same
+	 *   file into one transaction. The destructor does not return until all accepted intents are written.
+	 * Intents of a transaction that fails to begin or commit are rolled back and counted as failed.
+	 * The `committed` continuation of an intent only runs after the transaction of the intent is committed,
+	 *   and `batch_committed` runs once after each batch that has written intents, on the writer thread.
+	 *
+	 * UWP applications are not destructed after suspending, so `persistence_flush_all()` should be called
+	 *   in `on_suspending()` to write the pending intents of all living queues.
+	 *
+	 * Intents are run in the writer thread, they should own (copy) the records to be written.
+	 */
+	private class PersistenceQueue {
+	public:
+		PersistenceQueue(WarGrey::GYDM::Syslog* logger, WarGrey::SCADA::PersistencePolicy policy,
+			size_t capacity, size_t batch_size, std::function<void(WarGrey::SCADA::IDBSystem*)> prepare,
+			std::function<void(void)> batch_committed = nullptr);
+
+		~PersistenceQueue() noexcept;
+
+	public:
+		/**
+		 * `dbpath` is the file that the intent writes into, `nullptr` if the intent manages its own database,
+		 *   in which case the intent is given `nullptr`.
+		 * returns `false` if the intent is dropped.
+		 */
+		bool push(Platform::String^ dbpath, std::function<void(WarGrey::SCADA::IDBSystem*)> intent,
+			std::function<void(void)> committed = nullptr);
+		void flush();
+
+	public:
+		WarGrey::SCADA::PersistenceMetrics metrics();
+
+	private:
+		void run();
+		void write(std::deque<WarGrey::SCADA::PersistenceIntent>& batch);
+		WarGrey::SCADA::IDBSystem* connect(const std::wstring& dbpath);
+		void disconnect(const std::set<std::wstring>& keeps);
+
+	private:
+		WarGrey::GYDM::Syslog* logger;
+		WarGrey::SCADA::PersistencePolicy policy;
+		WarGrey::SCADA::PersistenceMetrics statistics;
+		std::deque<WarGrey::SCADA::PersistenceIntent> intents;
+		std::function<void(WarGrey::SCADA::IDBSystem*)> prepare;
+		std::function<void(void)> batch_committed;
+		std::map<std::wstring, WarGrey::SCADA::ISQLite3*> connections; // owned by the writer thread
+		std::mutex section;
+		std::condition_variable available;
+		std::condition_variable drained;
+		std::thread writer;
+		size_t capacity;
+		size_t batch_size;
+		size_t writing;
+		bool congested;
+		bool terminated;
+	};
+
+	void persistence_flush_all();
+}
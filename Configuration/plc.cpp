@@ -1,6 +1,12 @@
+#include <vector>
+#include <memory>
+#include <mutex>
+
 #include "plc.hpp"
+#include "slang/relay.hpp"
 
 #include "datum/box.hpp"
+#include "datum/time.hpp"
 #include "datum/enum.hpp"
 
 #include "math.hpp"
@@ -95,25 +101,267 @@ float WarGrey::SCADA::RealData(const uint8* src, size_t idx) {
 }
 
 /*************************************************************************************************/
-PLCMaster::PLCMaster(Syslog* logger, Platform::String^ server, unsigned short port, long long ms) : MRMaster(logger, server, port), last_sent_time(-1L) {
+namespace WarGrey::SCADA {
+	private class PLCFailover {
+	public:
+		PLCFailover(long long promotion_timeout) : promotion_timeout(promotion_timeout), last_accepted(0LL), last_timepoint(0LL), active(0) {
+			this->receivers = std::make_shared<PLCFailover::Receivers>();
+		}
+
+	public:
+		void push_receiver(IMRConfirmation* receiver) {
+			std::unique_lock<std::mutex> lock(this->section);
+			auto receivers = std::make_shared<PLCFailover::Receivers>(*this->receivers);
+
+			/** NOTE
+			 * Receivers might be pushed while a frame is being delivered (e.g. pages constructed lazily),
+			 *   the list is therefore copied on write, and each frame is delivered to the snapshot taken
+			 *   in `pre_read_data`, so that no receiver sees a `post_read_data` without the `pre_read_data`.
+			 */
+			receivers->push_back(receiver);
+			this->receivers = receivers;
+		}
+
+		bool is_active(int link) {
+			std::unique_lock<std::mutex> lock(this->section);
+
+			return (this->active == link);
+		}
+
+	public:
+		bool pre_read_data(int link, Syslog* logger) {
+			std::shared_ptr<const PLCFailover::Receivers> receivers = nullptr;
+			bool accepted = false;
+
+			{ std::unique_lock<std::mutex> lock(this->section);
+				long long now = current_milliseconds();
+
+				if (this->active == link) {
+					accepted = true;
+				} else if ((now - this->last_accepted) >= this->promotion_timeout) {
+					logger->log_message(Log::Warning, L"the %s connection is late for %lldms, switch to the %s one",
+						link_name(this->active), now - this->last_accepted, link_name(link));
+
+					this->active = link;
+					accepted = true;
+				}
+
+				if (accepted) {
+					this->last_accepted = now;
+					receivers = this->receivers;
+				}
+			}
+
+			// only touched by the thread of the link from now on
+			this->deliveries[link] = receivers;
+
+			if (accepted) {
+				for (auto r : (*receivers)) {
+					r->pre_read_data(logger);
+				}
+			}
+
+			return accepted;
+		}
+
+		void on_all_signals(int link, long long timepoint_ms, size_t addr0, size_t addrn, uint8* data, size_t size, Syslog* logger) {
+			bool fresh = false;
+
+			{ std::unique_lock<std::mutex> lock(this->section);
+				// the same frame might be delivered by both connections around the switching
+				if (timepoint_ms > this->last_timepoint) {
+					this->last_timepoint = timepoint_ms;
+					fresh = true;
+				}
+			}
+
+			if (fresh && (this->deliveries[link] != nullptr)) {
+				for (auto r : (*this->deliveries[link])) {
+					r->on_all_signals(timepoint_ms, addr0, addrn, data, size, logger);
+				}
+			}
+		}
+
+		void post_read_data(int link, Syslog* logger) {
+			if (this->deliveries[link] != nullptr) {
+				for (auto r : (*this->deliveries[link])) {
+					r->post_read_data(logger);
+				}
+
+				this->deliveries[link] = nullptr;
+			}
+		}
+
+	private:
+		static const wchar_t* link_name(int link) {
+			const wchar_t* name = L"primary";
+
+			switch (link) {
+			case 1: name = L"standby"; break;
+			case 2: name = L"relay"; break;
+			}
+
+			return name;
+		}
+
+	private:
+		typedef std::vector<IMRConfirmation*> Receivers;
+
+	private:
+		std::shared_ptr<const PLCFailover::Receivers> receivers;
+		std::shared_ptr<const PLCFailover::Receivers> deliveries[3]; // primary, standby and relay
+		std::mutex section;
+		long long promotion_timeout;
+		long long last_accepted;
+		long long last_timepoint;
+		int active;
+	};
+}
+
+namespace WarGrey::SCADA {
+	private class PLCLink : public MRConfirmation {
+	public:
+		PLCLink(PLCFailover* failover, int link) : failover(failover), accepted(false), link(link) {}
+
+	public:
+		void pre_read_data(Syslog* logger) override {
+			this->accepted = this->failover->pre_read_data(this->link, logger);
+		}
+
+		void on_all_signals(long long timepoint_ms, size_t addr0, size_t addrn, uint8* data, size_t size, Syslog* logger) override {
+			if (this->accepted) {
+				this->failover->on_all_signals(this->link, timepoint_ms, addr0, addrn, data, size, logger);
+			}
+		}
+
+		void post_read_data(Syslog* logger) override {
+			if (this->accepted) {
+				this->failover->post_read_data(this->link, logger);
+				this->accepted = false;
+			}
+		}
+
+	private:
+		PLCFailover* failover;
+		bool accepted;
+		int link;
+	};
+}
+
+/*************************************************************************************************/
+PLCLinkage::PLCLinkage() : failover(nullptr), relay(nullptr) {
+	for (size_t idx = 0; idx < sizeof(this->links) / sizeof(PLCLink*); idx++) {
+		this->links[idx] = nullptr;
+	}
+}
+
+PLCLinkage::~PLCLinkage() {
+	// the primary connection and the standby one have gone
+	if (this->relay != nullptr) {
+		delete this->relay;
+	}
+
+	for (size_t idx = 0; idx < sizeof(this->links) / sizeof(PLCLink*); idx++) {
+		if (this->links[idx] != nullptr) {
+			delete this->links[idx];
+		}
+	}
+
+	if (this->failover != nullptr) {
+		delete this->failover;
+	}
+}
+
+/*************************************************************************************************/
+PLCMaster::PLCMaster(Syslog* logger, Platform::String^ server, unsigned short port, long long ms, Platform::String^ standby, long long promotion_timeout)
+	: PLCLinkage(), MRMaster(logger, server, port), last_sent_time(-1L), standby(nullptr) {
 	this->set_suicide_timeout(ms);
+
+	if (standby != nullptr) {
+		this->setup_failover(promotion_timeout);
+		this->links[1] = new PLCLink(this->failover, 1);
+		this->standby = new PLCMaster(logger, standby, port, ms);
+		this->standby->push_frame_receiver(this->links[1]);
+	}
+}
+
+PLCMaster::~PLCMaster() {
+	/** NOTE
+	 * The standby connection is shut down here, the relay, links and the failover are deleted
+	 *   by `PLCLinkage` once `MRMaster` has shut down the primary connection.
+	 */
+	if (this->standby != nullptr) {
+		delete this->standby;
+	}
+}
+
+void PLCMaster::setup_failover(long long promotion_timeout) {
+	if (this->failover == nullptr) {
+		this->failover = new PLCFailover(promotion_timeout);
+		this->links[0] = new PLCLink(this->failover, 0);
+		MRMaster::push_confirmation_receiver(this->links[0]);
+	}
+}
+
+void PLCMaster::relay_over_slang(SlangPort sp, long long silence_timeout, size_t keyframe_interval) {
+	if (this->relay == nullptr) {
+		this->setup_failover(silence_timeout);
+		this->links[2] = new PLCLink(this->failover, 2);
+		this->relay = new PLCRelay(this->get_logger(), sp, silence_timeout, keyframe_interval);
+		this->relay->push_confirmation_receiver(this->links[2]);
+
+		// the relay publishes whatever frames the failover accepts while this console is the poller
+		this->failover->push_receiver(this->relay);
+	}
+}
+
+void PLCMaster::push_frame_receiver(IMRConfirmation* receiver) {
+	if (this->failover != nullptr) {
+		this->failover->push_receiver(receiver);
+	} else {
+		MRMaster::push_confirmation_receiver(receiver);
+	}
+}
+
+MRMaster* PLCMaster::active_master() {
+	MRMaster* master = this;
+
+	if (this->standby != nullptr) {
+		if (this->failover->is_active(1)) {
+			if (this->standby->connected()) {
+				master = this->standby;
+			}
+		}
+	}
+
+	return master;
 }
 
 void PLCMaster::send_scheduled_request(long long count, long long interval, long long uptime) {
-	if (this->last_sent_time != uptime) {
-		this->read_all_signal((uint16)98U, (uint16)0U, (uint16)0x1263U);
+	// with the relay, only the elected console polls
+	bool polling = ((this->relay == nullptr) || this->relay->polling());
+
+	if (polling && (this->last_sent_time != uptime)) {
+		if (this->connected()) {
+			this->read_all_signal((uint16)98U, (uint16)0U, (uint16)0x1263U);
+		}
+
 		this->last_sent_time = uptime;
 	}
+
+	if (polling && (this->standby != nullptr)) { // keep it warm
+		this->standby->send_scheduled_request(count, interval, uptime);
+	}
 }
 
 void PLCMaster::send_setting(int16 address, float datum) {
 	if (address > 0U) {
-		this->write_analog_quantity((uint16)20U, address, datum);
+		this->active_master()->write_analog_quantity((uint16)20U, address, datum);
 	}
 }
 
 void PLCMaster::send_command(uint8 idx, uint8 bidx) {
-	this->write_digital_quantity((uint16)300U, idx, bidx, true);
+	this->active_master()->write_digital_quantity((uint16)300U, idx, bidx, true);
 }
 
 void PLCMaster::send_command(uint16 index_p1) {
@@ -2,6 +2,8 @@
 
 #include "mrit.hpp"
 
+#include "slang/port.hpp"
+
 #include "datum/flonum.hpp"
 
 #include "syslog.hpp"
@@ -48,9 +50,50 @@ namespace WarGrey::SCADA {
 		virtual void on_signals_updated(long long timepoint_ms, WarGrey::GYDM::Syslog* logger) {}
 	};
 
-	private class PLCMaster : public WarGrey::SCADA::MRMaster {
+	private class PLCFailover;
+	private class PLCRelay;
+	private class PLCLink;
+
+	/** NOTE
+	 * As the base listed before `MRMaster`, it is destructed after the primary connection,
+	 *   so that whatever the primary connection delivers frames to is deleted only after the connection has gone.
+	 */
+	private class PLCLinkage {
+	protected:
+		virtual ~PLCLinkage() noexcept;
+		PLCLinkage();
+
+	protected:
+		WarGrey::SCADA::PLCFailover* failover;
+		WarGrey::SCADA::PLCRelay* relay;
+		WarGrey::SCADA::PLCLink* links[3]; // primary, standby and relay
+	};
+
+	/** NOTE
+	 * With a `standby` server (which could also be the same gateway as the `server`),
+	 *   a second connection is kept warm and polled along with the primary one,
+	 *   frames are relayed from the active connection only and the standby one is promoted
+	 *   as soon as the active one is late for `promotion_timeout`, so that the data gap
+	 *   is bounded by one polling interval rather than the suicide timeout plus the reconnecting.
+	 *
+	 * Frames are deduplicated by their timestamps, receivers never see a frame older than the last one.
+	 *
+	 * With the slang relay, the PLC is only polled by the elected console, others take frames from the relay
+	 *   as the third connection and fall back to polling on their own once the relay goes silent.
+	 *
+	 * Receivers are pushed with `push_frame_receiver` so that they are delivered by the failover,
+	 *   the `push_confirmation_receiver` of `MRMaster` is not accessible through a `PLCMaster*`.
+	 */
+	private class PLCMaster : private WarGrey::SCADA::PLCLinkage, public WarGrey::SCADA::MRMaster {
+	public:
+		virtual ~PLCMaster() noexcept;
+
+		PLCMaster(WarGrey::GYDM::Syslog* logger, Platform::String^ server, unsigned short port, long long timeout = 0LL,
+			Platform::String^ standby = nullptr, long long promotion_timeout = 1000LL);
+
 	public:
-		PLCMaster(WarGrey::GYDM::Syslog* logger, Platform::String^ server, unsigned short port, long long timeout = 0LL);
+		void push_frame_receiver(WarGrey::SCADA::IMRConfirmation* receiver);
+		void relay_over_slang(WarGrey::GYDM::SlangPort sp, long long silence_timeout, size_t keyframe_interval);
 
 	public:
 		void send_scheduled_request(long long count, long long interval, long long uptime);
@@ -58,7 +101,17 @@ namespace WarGrey::SCADA {
 		void send_command(uint8 idx, uint8 bidx);
 		void send_command(uint16 index_p1);
 
+	private:
+		using WarGrey::SCADA::MRMaster::push_confirmation_receiver;
+
+	private:
+		void setup_failover(long long promotion_timeout);
+		WarGrey::SCADA::MRMaster* active_master();
+
 	private:
 		long long last_sent_time;
+
+	private:
+		WarGrey::SCADA::PLCMaster* standby;
 	};
 }
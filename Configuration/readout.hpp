@@ -0,0 +1,47 @@
+#pragma once
+
+#include <map>
+#include <cmath>
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * Readouts are fed every PLC frame, but what they display rarely changes after rounding,
+	 *   `ReadoutCache` remembers what each readout displays so that the relayout could be skipped.
+	 */
+	template<typename E>
+	private class ReadoutCache {
+	public:
+		bool changed(E id, Platform::String^ text) {
+			auto maybe_text = this->texts.find(id);
+			bool updated = ((maybe_text == this->texts.end()) || (!maybe_text->second->Equals(text)));
+
+			if (updated) {
+				this->texts[id] = text;
+			}
+
+			return updated;
+		}
+
+		bool changed(E id, double value, unsigned int precision) {
+			double rounded = std::round(value * std::pow(10.0, double(precision)));
+			auto maybe_value = this->values.find(id);
+			bool updated = ((maybe_value == this->values.end()) || (maybe_value->second != rounded));
+
+			if (updated) {
+				this->values[id] = rounded;
+			}
+
+			return updated;
+		}
+
+	public:
+		void forget(E id) {
+			this->texts.erase(id);
+			this->values.erase(id);
+		}
+
+	private:
+		std::map<E, Platform::String^> texts;
+		std::map<E, double> values;
+	};
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * The ORM generator only makes `std::list` result sets, other kinds of result sets are made
+	 *   with cursors here, so that regenerating the DAOs does not wipe them.
+	 *
+	 * `Cursor` is the cursor interface generated for the table of `Record`, such as `IEarthWorkCursor`,
+	 *   rows are restored straight into the buffer owned by the caller, no row is allocated.
+	 */
+	template<typename Record, class Cursor>
+	private class BufferResultSet : public Cursor {
+	public:
+		BufferResultSet(Record* buffer, size_t capacity) : count(0U), buffer(buffer), capacity(capacity) {}
+
+	public:
+		bool step(Record& self, bool asc, int code) override {
+			if (this->count < this->capacity) {
+				this->buffer[this->count] = self;
+				this->count++;
+			}
+
+			return (this->count < this->capacity);
+		}
+
+	public:
+		size_t count;
+
+	private:
+		Record* buffer;
+		size_t capacity;
+	};
+}
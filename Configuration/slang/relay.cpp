@@ -0,0 +1,333 @@
+#include <random>
+#include <cwchar>
+
+#include "slang/relay.hpp"
+#include "configuration.hpp"
+
+#include "datum/time.hpp"
+
+#include "asn/der.hpp"
+
+#include "syslog.hpp"
+
+using namespace WarGrey::SCADA;
+using namespace WarGrey::GYDM;
+
+/*************************************************************************************************/
+static const uint8 RELAY_MAGIC0 = 'P';
+static const uint8 RELAY_MAGIC1 = 'R';
+static const uint8 RELAY_KEYFRAME = 0U;
+static const uint8 RELAY_DELTA = 1U;
+static const size_t RELAY_HEADER_SIZE = 21U;
+static const size_t RELAY_RUN_HEADER_SIZE = 4U;
+
+static inline void relay_put_uint16(octets& frame, size_t v) {
+	frame.push_back((uint8)((v >> 8U) & 0xFFU));
+	frame.push_back((uint8)(v & 0xFFU));
+}
+
+static inline void relay_put_uint32(octets& frame, uint32 v) {
+	relay_put_uint16(frame, (v >> 16U) & 0xFFFFU);
+	relay_put_uint16(frame, v & 0xFFFFU);
+}
+
+static inline size_t relay_ref_uint16(const uint8* src, size_t idx) {
+	return (size_t(src[idx]) << 8U) | size_t(src[idx + 1]);
+}
+
+static inline uint32 relay_ref_uint32(const uint8* src, size_t idx) {
+	return (uint32(relay_ref_uint16(src, idx)) << 16U) | uint32(relay_ref_uint16(src, idx + 2));
+}
+
+static void relay_fill_header(octets& frame, uint8 kind, size_t length, uint32 identity, uint32 sequence, size_t addr0, size_t addrn, size_t size, size_t runs) {
+	frame.push_back(RELAY_MAGIC0);
+	frame.push_back(RELAY_MAGIC1);
+	frame.push_back(kind);
+	relay_put_uint16(frame, length);
+	relay_put_uint32(frame, identity);
+	relay_put_uint32(frame, sequence);
+	relay_put_uint16(frame, addr0);
+	relay_put_uint16(frame, addrn);
+	relay_put_uint16(frame, size);
+	relay_put_uint16(frame, runs);
+}
+
+static bool relay_next_run(const uint8* prev, const uint8* data, size_t size, size_t* idx, size_t* start, size_t* end) {
+	size_t i = (*idx);
+
+	while ((i < size) && (prev[i] == data[i])) {
+		i++;
+	}
+
+	if (i < size) {
+		size_t e = i + 1U;
+
+		// gaps no longer than a run header are cheaper to be carried along
+		while (e < size) {
+			size_t gap = 0U;
+
+			while ((e + gap < size) && (prev[e + gap] == data[e + gap]) && (gap <= RELAY_RUN_HEADER_SIZE)) {
+				gap++;
+			}
+
+			if ((e + gap < size) && (gap <= RELAY_RUN_HEADER_SIZE)) {
+				e += gap + 1U;
+			} else {
+				break;
+			}
+		}
+
+		(*start) = i;
+		(*end) = e;
+	}
+
+	(*idx) = ((i < size) ? (*end) : size);
+
+	return (i < size);
+}
+
+static size_t relay_delta_runs(const uint8* prev, const uint8* data, size_t size, size_t* payload) {
+	size_t runs = 0U;
+	size_t idx = 0U;
+	size_t start, end;
+
+	(*payload) = 0U;
+
+	while (relay_next_run(prev, data, size, &idx, &start, &end)) {
+		runs++;
+		(*payload) += RELAY_RUN_HEADER_SIZE + (end - start);
+	}
+
+	return runs;
+}
+
+static void relay_fill_delta(octets& frame, const uint8* prev, const uint8* data, size_t size) {
+	size_t idx = 0U;
+	size_t start, end;
+
+	while (relay_next_run(prev, data, size, &idx, &start, &end)) {
+		relay_put_uint16(frame, start);
+		relay_put_uint16(frame, end - start);
+		frame.append(data + start, end - start);
+	}
+}
+
+static bool relay_trusted_peer(Platform::String^ remote_peer) {
+	return ((remote_peer != nullptr)
+		&& (wcsncmp(remote_peer->Data(), system_subnet_prefix->Data(), system_subnet_prefix->Length()) == 0));
+}
+
+/*************************************************************************************************/
+PLCRelay::PLCRelay(Syslog* logger, SlangPort sp, long long silence_timeout, size_t keyframe_interval)
+	: port(plc_relay_slang_port(sp)), published(nullptr), published_size(0U), published_addr0(0U), sequence(0U), since_keyframe(0U)
+	, consumed(nullptr), consumed_size(0U), consumed_addr0(0U), consumed_addrn(0U)
+	, consumed_publisher(0U), consumed_sequence(0U), synchronized(false)
+	, silence_timeout(silence_timeout), last_heard(0LL), keyframe_interval(keyframe_interval) {
+	std::random_device rd;
+
+	do {
+		this->identity = rd();
+	} while (this->identity == 0U);
+
+	this->slangd = new SlangDaemon<uint8>(logger, this->port, this);
+	this->slangd->join_multicast_group(slang_multicast_group);
+}
+
+PLCRelay::~PLCRelay() {
+	delete this->slangd;
+
+	if (this->published != nullptr) {
+		delete[] this->published;
+	}
+
+	if (this->consumed != nullptr) {
+		delete[] this->consumed;
+	}
+}
+
+void PLCRelay::push_confirmation_receiver(IMRConfirmation* receiver) {
+	if (receiver != nullptr) {
+		std::unique_lock<std::mutex> lock(this->section);
+
+		this->receivers.push_back(receiver);
+	}
+}
+
+bool PLCRelay::polling() {
+	std::unique_lock<std::mutex> lock(this->section);
+
+	return ((current_milliseconds() - this->last_heard) >= this->silence_timeout);
+}
+
+/*************************************************************************************************/
+void PLCRelay::on_all_signals(long long timepoint_ms, size_t addr0, size_t addrn, uint8* data, size_t size, Syslog* logger) {
+	// the whole datagram, including the header, should be measured by the length field
+	if ((RELAY_HEADER_SIZE + RELAY_RUN_HEADER_SIZE + size <= 0xFFFFU) && this->polling()) {
+		bool keyframe = ((this->published == nullptr)
+			|| (this->published_size != size) || (this->published_addr0 != addr0)
+			|| (this->since_keyframe >= this->keyframe_interval));
+		size_t payload = 0U;
+		size_t runs = 0U;
+		octets frame;
+
+		if (!keyframe) {
+			runs = relay_delta_runs(this->published, data, size, &payload);
+			keyframe = (payload >= size);
+		}
+
+		if (keyframe) {
+			if (this->published_size != size) {
+				if (this->published != nullptr) {
+					delete[] this->published;
+				}
+
+				this->published = new uint8[size];
+				this->published_size = size;
+			}
+
+			frame.reserve(RELAY_HEADER_SIZE + RELAY_RUN_HEADER_SIZE + size);
+			relay_fill_header(frame, RELAY_KEYFRAME, RELAY_HEADER_SIZE + RELAY_RUN_HEADER_SIZE + size,
+				this->identity, ++this->sequence, addr0, addrn, size, 1U);
+			relay_put_uint16(frame, 0U);
+			relay_put_uint16(frame, size);
+			frame.append(data, size);
+			this->since_keyframe = 0U;
+		} else {
+			frame.reserve(RELAY_HEADER_SIZE + payload);
+			relay_fill_header(frame, RELAY_DELTA, RELAY_HEADER_SIZE + payload,
+				this->identity, ++this->sequence, addr0, addrn, size, runs);
+			relay_fill_delta(frame, this->published, data, size);
+			this->since_keyframe++;
+		}
+
+		memcpy(this->published, data, size);
+		this->published_addr0 = addr0;
+		this->slangd->multicast(this->port, frame);
+	}
+}
+
+void PLCRelay::on_message(long long timepoint_ms, Platform::String^ remote_peer, uint16 remote_port, uint8 type
+	, const uint8* message, Syslog* logger) {
+	if ((message[0] == RELAY_MAGIC0) && (message[1] == RELAY_MAGIC1)) {
+		size_t message_size = relay_ref_uint16(message, 3U);
+		uint32 publisher = relay_ref_uint32(message, 5U);
+		bool acceptable = false;
+
+		if (message_size < RELAY_HEADER_SIZE) {
+			logger->log_message(Log::Warning, L"dropped a malformed PLC relay datagram(%u bytes) from %s", message_size, remote_peer->Data());
+		} else if (!relay_trusted_peer(remote_peer)) {
+			logger->log_message(Log::Warning, L"dropped a PLC relay datagram from %s, which is out of the subnet", remote_peer->Data());
+		} else if (publisher != this->identity) { // multicast loops back
+			std::unique_lock<std::mutex> lock(this->section);
+			bool polling = ((current_milliseconds() - this->last_heard) >= this->silence_timeout);
+
+			// the one with the smaller identity wins the election
+			acceptable = ((!polling) || (publisher < this->identity));
+		}
+
+		if (acceptable && this->apply_frame(message, message_size, logger)) {
+			std::deque<IMRConfirmation*> receivers;
+			long long now = current_milliseconds();
+
+			{ std::unique_lock<std::mutex> lock(this->section);
+				if ((now - this->last_heard) >= this->silence_timeout) {
+					logger->log_message(Log::Info, L"PLC frames are relayed by %s, stop polling", remote_peer->Data());
+				}
+
+				this->last_heard = now;
+				receivers = this->receivers;
+			}
+
+			for (auto r : receivers) {
+				r->pre_read_data(logger);
+				r->on_all_signals(now, this->consumed_addr0, this->consumed_addrn, this->consumed, this->consumed_size, logger);
+				r->post_read_data(logger);
+			}
+		}
+	}
+}
+
+bool PLCRelay::apply_frame(const uint8* message, size_t message_size, Syslog* logger) {
+	uint8 kind = message[2];
+	uint32 publisher = relay_ref_uint32(message, 5U);
+	uint32 sequence = relay_ref_uint32(message, 9U);
+	size_t addr0 = relay_ref_uint16(message, 13U);
+	size_t addrn = relay_ref_uint16(message, 15U);
+	size_t size = relay_ref_uint16(message, 17U);
+	size_t runs = relay_ref_uint16(message, 19U);
+	size_t idx = RELAY_HEADER_SIZE;
+	bool wellformed = ((kind == RELAY_KEYFRAME) || (kind == RELAY_DELTA));
+	bool applied = false;
+
+	// runs are validated before anything is applied, so that a malformed datagram never breaks the consumed frame
+	for (size_t r = 0; wellformed && (r < runs); r++) {
+		wellformed = (idx + RELAY_RUN_HEADER_SIZE <= message_size);
+
+		if (wellformed) {
+			size_t offset = relay_ref_uint16(message, idx);
+			size_t length = relay_ref_uint16(message, idx + 2U);
+
+			idx += RELAY_RUN_HEADER_SIZE;
+			wellformed = ((offset + length <= size) && (idx + length <= message_size));
+			idx += length;
+		}
+	}
+
+	// runs should end right at the length, nothing is left behind
+	wellformed = (wellformed && (idx == message_size));
+
+	if (!wellformed) {
+		logger->log_message(Log::Warning, L"dropped a malformed PLC relay datagram(%u bytes)", message_size);
+	} else if (kind == RELAY_KEYFRAME) {
+		if (this->consumed_size != size) {
+			if (this->consumed != nullptr) {
+				delete[] this->consumed;
+			}
+
+			this->consumed = new uint8[size];
+			this->consumed_size = size;
+		}
+
+		this->synchronized = true;
+	} else if (this->synchronized) {
+		if ((publisher != this->consumed_publisher) || (sequence != this->consumed_sequence + 1U) || (size != this->consumed_size)) {
+			logger->log_message(Log::Debug, L"lost PLC relay frames(%u -> %u), wait for the next keyframe",
+				this->consumed_sequence, sequence);
+
+			this->synchronized = false;
+		}
+	}
+
+	if (wellformed && this->synchronized) {
+		idx = RELAY_HEADER_SIZE;
+
+		for (size_t r = 0; r < runs; r++) {
+			size_t offset = relay_ref_uint16(message, idx);
+			size_t length = relay_ref_uint16(message, idx + 2U);
+
+			idx += RELAY_RUN_HEADER_SIZE;
+			memcpy(this->consumed + offset, message + idx, length);
+			idx += length;
+		}
+
+		this->consumed_publisher = publisher;
+		this->consumed_sequence = sequence;
+		this->consumed_addr0 = addr0;
+		this->consumed_addrn = addrn;
+		applied = true;
+	}
+
+	return applied;
+}
+
+/*************************************************************************************************/
+unsigned short WarGrey::SCADA::plc_relay_slang_port(SlangPort sp) {
+	unsigned short port = 0;
+
+	switch (sp) {
+	case SlangPort::SCADA: port = 2009; break;
+	case SlangPort::DTPM: port = 2010; break;
+	}
+
+	return port;
+}
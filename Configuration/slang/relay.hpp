@@ -0,0 +1,75 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+
+#include "mrit.hpp"
+
+#include "peer/slang.hpp"
+#include "slang/port.hpp"
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * Consoles share one PLC poller, the poller multicasts raw frames, delta-encoded against the previous one,
+	 *   all the others consume them and keep their own PLC connections idle.
+	 *
+	 * The election is implicit, any console that does not hear a relay for `silence_timeout` polls the PLC
+	 *   on its own and starts publishing, and whoever hears a publisher with a smaller identity yields,
+	 *   so there would be only one poller in steady state.
+	 *
+	 * A delta frame can only be applied on top of the frame right before it, after a lost datagram,
+	 *   consumers wait for the next keyframe which is sent every `keyframe_interval` frames.
+	 *
+	 * The daemon does not tell the size of a datagram, the header therefore carries the length,
+	 *   datagrams are checked against it before being applied, a malformed one is dropped as a whole
+	 *   and never touches the consumed frame.
+	 * Datagrams from peers outside the `system_subnet_prefix` are ignored.
+	 */
+	private class PLCRelay : public WarGrey::SCADA::MRConfirmation, public WarGrey::GYDM::SlangLocalPeer<uint8> {
+	public:
+		virtual ~PLCRelay() noexcept;
+		PLCRelay(WarGrey::GYDM::Syslog* logger, WarGrey::GYDM::SlangPort sp, long long silence_timeout, size_t keyframe_interval);
+
+	public:
+		void push_confirmation_receiver(WarGrey::SCADA::IMRConfirmation* receiver);
+		bool polling();
+
+	public:
+		void on_all_signals(long long timepoint_ms, size_t addr0, size_t addrn, uint8* data, size_t size, WarGrey::GYDM::Syslog* logger) override;
+		void on_message(long long timepoint_ms, Platform::String^ remote_peer, uint16 remote_port, uint8 type,
+			const uint8* message, WarGrey::GYDM::Syslog* logger) override;
+
+	private:
+		bool apply_frame(const uint8* message, size_t message_size, WarGrey::GYDM::Syslog* logger);
+
+	private:
+		WarGrey::GYDM::ISlangDaemon* slangd;
+		std::deque<WarGrey::SCADA::IMRConfirmation*> receivers;
+		std::mutex section;
+
+	private: // publisher
+		uint8* published;
+		size_t published_size;
+		size_t published_addr0;
+		uint32 sequence;
+		size_t since_keyframe;
+
+	private: // consumer
+		uint8* consumed;
+		size_t consumed_size;
+		size_t consumed_addr0;
+		size_t consumed_addrn;
+		uint32 consumed_publisher;
+		uint32 consumed_sequence;
+		bool synchronized;
+
+	private:
+		unsigned short port;
+		uint32 identity;
+		long long silence_timeout;
+		long long last_heard;
+		size_t keyframe_interval;
+	};
+
+	unsigned short plc_relay_slang_port(WarGrey::GYDM::SlangPort sp);
+}
@@ -1,25 +1,30 @@
 #include "transponder.hpp"
 #include "moxa.hpp"
+#include "configuration.hpp"
 
 using namespace WarGrey::SCADA;
 using namespace WarGrey::DTPM;
 using namespace WarGrey::GYDM;
 
-#define ON_MOBILE(responders, on_respond, logger, ...) do { \
-for (auto r : responders) { \
-if (r->respondable()) { \
-r->pre_respond(logger); \
-r->on_respond(__VA_ARGS__, logger); \
-r->post_respond(logger); \
-} \
-} \
-} while (0)
-
 /*************************************************************************************************/
-Transponder::Transponder() {
+Transponder::Transponder(bool merge_positions)
+	: logger(nullptr), batch_timepoint(0LL), merge_positions(merge_positions), pending(false), terminated(false) {
+	this->flusher = std::thread([this]() { this->do_flushing_loop(); });
 	this->tranceiver = moxa_tcp_as_ais(MOXA_TCP::AIS, this);
 }
 
+Transponder::~Transponder() {
+	{ std::unique_lock<std::mutex> lock(this->dispatching);
+		this->terminated = true;
+	}
+
+	this->batching.notify_one();
+
+	if (this->flusher.joinable()) {
+		this->flusher.join(); // the pending batch is dropped, responders might have gone
+	}
+}
+
 void Transponder::set_gps_convertion_matrix(GPSCS^ gcs) {
 	this->gcs = gcs;
 }
@@ -42,11 +47,7 @@ void Transponder::on_ASO(int id, long long timepoint_ms, bool self, uint16 mmsi,
 
 		pr.geo = Degrees_to_XY(pr.latitude, pr.longitude, 0.0, this->gcs->parameter);
 
-		if (self) {
-			ON_MOBILE(this->responders, on_self_position_report, logger, timepoint_ms, &pr);
-		} else {
-			ON_MOBILE(this->responders, on_position_report, logger, timepoint_ms, mmsi, &pr);
-		}
+		this->batch_position(timepoint_ms, self, mmsi, pr, logger);
 	}
 }
 
@@ -61,11 +62,7 @@ void Transponder::on_BCS(int id, long long timepoint_ms, bool self, uint16 mmsi,
 		pr.turn = flnan;
 		pr.geo = Degrees_to_XY(pr.latitude, pr.longitude, 0.0, this->gcs->parameter);
 
-		if (self) {
-			ON_MOBILE(this->responders, on_self_position_report, logger, timepoint_ms, &pr);
-		} else {
-			ON_MOBILE(this->responders, on_position_report, logger, timepoint_ms, mmsi, &pr);
-		}
+		this->batch_position(timepoint_ms, self, mmsi, pr, logger);
 	}
 }
 
@@ -81,11 +78,7 @@ void Transponder::on_BCSE(int id, long long timepoint_ms, bool self, uint16 mmsi
 			pr.turn = flnan;
 			pr.geo = Degrees_to_XY(pr.latitude, pr.longitude, 0.0, this->gcs->parameter);
 
-			if (self) {
-				ON_MOBILE(this->responders, on_self_position_report, logger, timepoint_ms, &pr);
-			} else {
-				ON_MOBILE(this->responders, on_position_report, logger, timepoint_ms, mmsi, &pr);
-			}
+			this->batch_position(timepoint_ms, self, mmsi, pr, logger);
 		}
 
 		{ // dispatch voyage report
@@ -94,7 +87,7 @@ void Transponder::on_BCSE(int id, long long timepoint_ms, bool self, uint16 mmsi
 			vr.shipname = prcb->shipname;
 			ais_shipbox_filter(prcb->shipbox, &vr.to_bow, &vr.to_stern, &vr.to_port, &vr.to_starboard);
 
-			ON_MOBILE(this->responders, on_voyage_report, logger, timepoint_ms, mmsi, &vr);
+			this->batch_voyage(timepoint_ms, mmsi, vr, logger);
 		}
 	}
 }
@@ -108,7 +101,7 @@ void Transponder::on_SVD(int id, long long timepoint_ms, bool self, uint16 mmsi,
 		vr.shipname = svd->shipname;
 		ais_shipbox_filter(svd->shipbox, &vr.to_bow, &vr.to_stern, &vr.to_port, &vr.to_starboard);
 
-		ON_MOBILE(this->responders, on_voyage_report, logger, timepoint_ms, mmsi, &vr);
+		this->batch_voyage(timepoint_ms, mmsi, vr, logger);
 	}
 }
 
@@ -120,7 +113,7 @@ void Transponder::on_SDR(int id, long long timepoint_ms, bool self, uint16 mmsi,
 		case SDR::Format::PartA: {
 			vr.shipname = sdr->part.a.shipname;
 
-			ON_MOBILE(this->responders, on_voyage_report, logger, timepoint_ms, mmsi, &vr);
+			this->batch_voyage(timepoint_ms, mmsi, vr, logger);
 		}; break;
 		case SDR::Format::PartB: {
 			vr.callsign = sdr->part.b.callsign;
@@ -131,8 +124,119 @@ void Transponder::on_SDR(int id, long long timepoint_ms, bool self, uint16 mmsi,
 				ais_shipbox_filter(sdr->part.b.craft.box, &vr.to_bow, &vr.to_stern, &vr.to_port, &vr.to_starboard);
 			}
 
-			ON_MOBILE(this->responders, on_voyage_report, logger, timepoint_ms, mmsi, &vr);
+			this->batch_voyage(timepoint_ms, mmsi, vr, logger);
 		}; break;
 		}
 	}
 }
+
+/*************************************************************************************************/
+void Transponder::batch_position(long long timepoint_ms, bool self, uint16 mmsi, AISPositionReport& pr, Syslog* logger) {
+	this->check_batch(timepoint_ms, logger);
+
+	{ std::unique_lock<std::mutex> lock(this->section);
+		auto slot = this->position_slots.find(mmsi);
+
+		if (this->merge_positions && (slot != this->position_slots.end())) { // last wins
+			AISBatchedPosition& last = this->positions[slot->second];
+
+			last.timepoint = timepoint_ms;
+			last.self = self;
+			last.report = pr;
+		} else {
+			this->position_slots[mmsi] = this->positions.size();
+			this->positions.push_back({ timepoint_ms, self, mmsi, pr });
+		}
+	}
+
+	this->notify_batch();
+}
+
+void Transponder::batch_voyage(long long timepoint_ms, uint16 mmsi, AISVoyageReport& vr, Syslog* logger) {
+	this->check_batch(timepoint_ms, logger);
+
+	{ // NOTE: voyage reports are partial (e.g. SDR Part A and Part B), they are never merged
+		std::unique_lock<std::mutex> lock(this->section);
+
+		this->voyages.push_back({ timepoint_ms, mmsi, vr });
+	}
+
+	this->notify_batch();
+}
+
+void Transponder::check_batch(long long timepoint_ms, Syslog* logger) {
+	std::unique_lock<std::mutex> lock(this->dispatching);
+
+	if (this->batch_timepoint != timepoint_ms) {
+		this->do_flushing_batch();
+		this->batch_timepoint = timepoint_ms;
+	}
+
+	this->logger = logger;
+}
+
+void Transponder::notify_batch() {
+	{ std::unique_lock<std::mutex> lock(this->dispatching);
+		this->pending = true;
+	}
+
+	this->batching.notify_one();
+}
+
+void Transponder::do_flushing_loop() {
+	std::unique_lock<std::mutex> lock(this->dispatching);
+
+	while (!this->terminated) {
+		if (!this->pending) {
+			this->batching.wait(lock);
+		} else {
+			this->pending = false;
+
+			// every message arrived within the latency postpones the flushing
+			if (this->batching.wait_for(lock, std::chrono::milliseconds(ais_batch_latency)) == std::cv_status::timeout) {
+				if (!this->terminated) {
+					this->do_flushing_batch();
+				}
+			}
+		}
+	}
+}
+
+void Transponder::do_flushing_batch() {
+	std::deque<AISBatchedPosition> positions;
+	std::deque<AISBatchedVoyage> voyages;
+
+	{ // responders might take a while, do not block the receiving thread
+		std::unique_lock<std::mutex> lock(this->section);
+
+		positions.swap(this->positions);
+		voyages.swap(this->voyages);
+		this->position_slots.clear();
+	}
+
+	if ((!positions.empty()) || (!voyages.empty())) {
+		this->dispatch_batch(positions, voyages, this->logger);
+	}
+}
+
+void Transponder::dispatch_batch(std::deque<AISBatchedPosition>& positions, std::deque<AISBatchedVoyage>& voyages, Syslog* logger) {
+	for (auto r : this->responders) {
+		if (r->respondable()) {
+			r->pre_respond(logger);
+
+			for (auto it = positions.begin(); it != positions.end(); it++) {
+				if (it->self) {
+					r->on_self_position_report(it->timepoint, &it->report, logger);
+				} else {
+					r->on_position_report(it->timepoint, it->mmsi, &it->report, logger);
+				}
+			}
+
+			for (auto it = voyages.begin(); it != voyages.end(); it++) {
+				r->on_voyage_report(it->timepoint, it->mmsi, &it->report, logger);
+			}
+
+			r->post_respond(logger);
+		}
+	}
+}
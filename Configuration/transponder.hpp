@@ -1,5 +1,11 @@
 #pragma once
 
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
 #include "graphlet/filesystem/configuration/aislet.hpp"
 #include "graphlet/filesystem/configuration/gpslet.hpp"
 
@@ -20,9 +26,33 @@ namespace WarGrey::DTPM {
 		virtual void post_respond(WarGrey::GYDM::Syslog* logger) = 0;
 	};
 
+	private struct AISBatchedPosition {
+		long long timepoint;
+		bool self;
+		uint16 mmsi;
+		WarGrey::DTPM::AISPositionReport report;
+	};
+
+	private struct AISBatchedVoyage {
+		long long timepoint;
+		uint16 mmsi;
+		WarGrey::DTPM::AISVoyageReport report;
+	};
+
+	/** NOTE
+	 * Messages decoded from the same TCP read share the same timepoint,
+	 *   they are collected and dispatched as a whole once a message of the next read arrives,
+	 *   so that responders only see one `pre_respond`/`post_respond` pair for a burst.
+	 *
+	 * The transceiver tells nothing about the end of a read, the last burst is therefore dispatched
+	 *   by the flushing thread once no more message arrives within `ais_batch_latency`,
+	 *   the UI thread never dispatches AIS messages.
+	 * Dispatching is serialized, responders are never invoked by two threads at the same time.
+	 */
 	private class Transponder : public WarGrey::DTPM::Transceiver {
 	public:
-		Transponder();
+		virtual ~Transponder() noexcept;
+		Transponder(bool merge_positions = true);
 		
 	public:
 		void on_ASO(int id, long long timepoint_ms, bool self, uint16 mmsi, WarGrey::DTPM::ASO* aso, uint8 priority, WarGrey::GYDM::Syslog* logger) override;
@@ -37,10 +67,34 @@ namespace WarGrey::DTPM {
 		void set_gps_convertion_matrix(WarGrey::DTPM::GPSCS^ gcs);
 		void push_receiver(WarGrey::DTPM::IAISResponder* receiver);
 
+	private:
+		void batch_position(long long timepoint_ms, bool self, uint16 mmsi, WarGrey::DTPM::AISPositionReport& pr, WarGrey::GYDM::Syslog* logger);
+		void batch_voyage(long long timepoint_ms, uint16 mmsi, WarGrey::DTPM::AISVoyageReport& vr, WarGrey::GYDM::Syslog* logger);
+		void check_batch(long long timepoint_ms, WarGrey::GYDM::Syslog* logger);
+		void notify_batch();
+		void do_flushing_batch();
+		void do_flushing_loop();
+		void dispatch_batch(std::deque<WarGrey::DTPM::AISBatchedPosition>& positions,
+			std::deque<WarGrey::DTPM::AISBatchedVoyage>& voyages, WarGrey::GYDM::Syslog* logger);
+
 	private:
 		WarGrey::DTPM::GPSCS^ gcs;
 		std::deque<WarGrey::DTPM::IAISResponder*> responders;
 
+	private:
+		std::deque<WarGrey::DTPM::AISBatchedPosition> positions;
+		std::deque<WarGrey::DTPM::AISBatchedVoyage> voyages;
+		std::map<uint16, size_t> position_slots;
+		std::mutex section;
+		std::mutex dispatching; // the receiving thread and the flushing thread both flush batches
+		std::condition_variable batching;
+		std::thread flusher;
+		WarGrey::GYDM::Syslog* logger;
+		long long batch_timepoint;
+		bool merge_positions;
+		bool pending;
+		bool terminated;
+
 	private: // never delete this shared object
 		WarGrey::DTPM::INMEA0183* tranceiver;
 	};
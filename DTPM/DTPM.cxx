@@ -1,5 +1,7 @@
 ﻿#include "application.hxx"
 #include "configuration.hpp"
+#include "capture.hpp"
+#include "persistence.hpp"
 
 #include "monitor.hpp"
 #include "widget.hxx"
@@ -58,7 +60,13 @@ internal:
 		
 		moxa_tcp_setup();
 
-		this->plc = new PLCMaster(plc_logger, plc_hostname, dtpm_plc_master_port, plc_master_suicide_timeout);
+		this->plc = new PLCMaster(plc_logger, plc_hostname, dtpm_plc_master_port, plc_master_suicide_timeout,
+			plc_standby_hostname, plc_standby_promotion_timeout);
+
+		if (plc_relay_over_slang) {
+			this->plc->relay_over_slang(SlangPort::DTPM, plc_relay_silence_timeout, plc_relay_keyframe_interval);
+		}
+
 		this->compass = new Compass();
 		this->transponder = new Transponder();
 
@@ -130,7 +138,13 @@ public:
 	void on_entered_background(EnteredBackgroundEventArgs^ args) {}
 	void on_background_activated(IBackgroundTaskInstance^ task) {}
 	void on_leaving_background(LeavingBackgroundEventArgs^ args) {}
-	void on_suspending(SuspendingEventArgs^ args) {}
+	void on_suspending(SuspendingEventArgs^ args) {
+		// pending screenshots are flushed, the pipeline will be restarted on demand
+		capture_pipeline_shutdown();
+
+		// pending records of all datasources are written, destructors are not guaranteed to run after suspending
+		persistence_flush_all();
+	}
 	void on_resuming() {}
 	
 private:
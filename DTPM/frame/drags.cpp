@@ -4,6 +4,7 @@
 #include "frame/drags.hpp"
 
 #include "configuration.hpp"
+#include "intern.hpp"
 #include "drag_info.hpp"
 #include "plc.hpp"
 
@@ -42,8 +43,8 @@ static CanvasSolidColorBrush^ suction_border_color = Colours::SeaGreen;
 private class Drags : public PLCConfirmation {
 public:
 	Drags(DragsFrame* master) : master(master) {
-		this->plain_style.number_font = make_bold_text_format("Cambria Math", small_metrics_font_size);
-		this->plain_style.unit_font = make_bold_text_format("Cambria", normal_font_size);
+		this->plain_style.number_font = intern_bold_text_format("Cambria Math", small_metrics_font_size);
+		this->plain_style.unit_font = intern_bold_text_format("Cambria", normal_font_size);
 		this->plain_style.minimize_number_width = 8U;
 
 		this->ps_address = make_ps_dredging_system_schema();
@@ -215,13 +216,13 @@ private:
 };
 
 /*************************************************************************************************/
-DragsFrame::DragsFrame(MRMaster* plc) : Planet(__MODULE__) {
+DragsFrame::DragsFrame(PLCMaster* plc) : Planet(__MODULE__) {
 	Drags* dashboard = new Drags(this);
 
 	this->dashboard = dashboard;
 
 	if (plc != nullptr) {
-		plc->push_confirmation_receiver(dashboard);
+		plc->push_frame_receiver(dashboard);
 	}
 }
 
@@ -2,13 +2,13 @@
 
 #include "timemachine.hpp"
 #include "planet.hpp"
-#include "mrit.hpp"
+#include "plc.hpp"
 
 namespace WarGrey::DTPM {
 	private class DragsFrame : public WarGrey::SCADA::Planet, public WarGrey::SCADA::ITimeMachineListener {
 	public:
 		virtual ~DragsFrame() noexcept;
-		DragsFrame(WarGrey::SCADA::MRMaster* plc = nullptr);
+		DragsFrame(WarGrey::SCADA::PLCMaster* plc = nullptr);
 
 	public:
 		void load(Microsoft::Graphics::Canvas::UI::CanvasCreateResourcesReason reason, float width, float height) override;
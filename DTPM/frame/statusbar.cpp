@@ -2,6 +2,8 @@
 
 #include "frame/statusbar.hpp"
 #include "configuration.hpp"
+#include "intern.hpp"
+#include "capture.hpp"
 #include "moxa.hpp"
 
 #include "datum/credit.hpp"
@@ -26,7 +28,7 @@ using namespace Microsoft::Graphics::Canvas::UI;
 using namespace Microsoft::Graphics::Canvas::Text;
 using namespace Microsoft::Graphics::Canvas::Brushes;
 
-static CanvasSolidColorBrush^ bar_background = Colours::make(diagnostics_region_background);
+static CanvasSolidColorBrush^ bar_background = intern_brush(diagnostics_region_background);
 static CanvasSolidColorBrush^ bar_foreground = Colours::GhostWhite;
 static CanvasSolidColorBrush^ bar_running_color = Colours::Green;
 static CanvasSolidColorBrush^ bar_stopped_color = Colours::Red;
@@ -42,7 +44,7 @@ namespace {
 
 	private class SystemStatuslet : public IGraphlet {
 	public:
-		SystemStatuslet(CanvasTextFormat^ status_font) : status_font(status_font), ipv4(nullptr), up_to_date(true) {}
+		SystemStatuslet(CanvasTextFormat^ status_font) : status_font(status_font), ipv4(nullptr), memory(nullptr), up_to_date(true) {}
 
 	public:
 		void on_available_storage_changed(unsigned long long free_bytes, unsigned long long total_bytes) {
@@ -73,6 +75,10 @@ namespace {
 		}
 
 		void update(long long count, long long interval, long long uptime) override {
+			if ((this->memory == nullptr) || ((count % frame_per_second) == 0)) {
+				this->update_memory_usage();
+			}
+
 			if (!this->up_to_date) {
 				this->notify_updated();
 			}
@@ -85,20 +91,33 @@ namespace {
 			ds->DrawTextLayout(this->ipv4, x + Width - this->ipv4->LayoutBounds.Width, context_y, Colours::Yellow);
 			ds->DrawTextLayout(this->storage, x + subwidth * 1.0F, context_y, Colours::YellowGreen);
 
-			{ // draw App Memory Usage
-				AppMemoryUsageLevel level;
-				unsigned long long app_usage, private_working_set;
-				CanvasSolidColorBrush^ color = Colours::GreenYellow;
-
-				private_working_set = system_physical_memory_usage(&app_usage, &level);
+			if (this->memory != nullptr) {
+				ds->DrawTextLayout(this->memory, x, context_y, this->memory_color);
+			}
+		}
 
-				switch (level) {
-				case AppMemoryUsageLevel::OverLimit: color = Colours::Firebrick; break;
-				case AppMemoryUsageLevel::High: color = Colours::Orange; break;
-				case AppMemoryUsageLevel::Low: color = Colours::RoyalBlue; break;
-				}
+	private:
+		void update_memory_usage() {
+			AppMemoryUsageLevel level;
+			unsigned long long app_usage, private_working_set;
+			CanvasSolidColorBrush^ color = Colours::GreenYellow;
+			Platform::String^ usage = nullptr;
+
+			private_working_set = system_physical_memory_usage(&app_usage, &level);
+			usage = status_speak("memory") + ": " + sstring(private_working_set, 1);
+
+			switch (level) {
+			case AppMemoryUsageLevel::OverLimit: color = Colours::Firebrick; break;
+			case AppMemoryUsageLevel::High: color = Colours::Orange; break;
+			case AppMemoryUsageLevel::Low: color = Colours::RoyalBlue; break;
+			}
 
-				ds->DrawText(status_speak("memory") + ": " + sstring(private_working_set, 1), x, context_y, color, this->status_font);
+			// the working set is sampled once per second and relaid out only if its rounded value changed
+			if ((this->memory == nullptr) || (!usage->Equals(this->memory_usage)) || (color != this->memory_color)) {
+				this->memory = make_text_layout(usage, this->status_font);
+				this->memory_usage = usage;
+				this->memory_color = color;
+				this->up_to_date = false;
 			}
 		}
 
@@ -106,6 +125,9 @@ namespace {
 		CanvasTextFormat^ status_font;
 		CanvasTextLayout^ storage;
 		CanvasTextLayout^ ipv4;
+		CanvasTextLayout^ memory;
+		Platform::String^ memory_usage;
+		CanvasSolidColorBrush^ memory_color;
 
 	private:
 		bool up_to_date;
@@ -114,7 +136,7 @@ namespace {
 	private class Statusbar final : public ISystemStatusListener {
 	public:
 		Statusbar(StatusFrame* master, ITCPConnection* plc) : master(master), plc(plc), system_metrics(nullptr) {
-			this->status_font = make_bold_text_format("Microsoft YaHei", small_font_size);
+			this->status_font = intern_bold_text_format("Microsoft YaHei", small_font_size);
 			this->devices[S::AIS] = moxa_tcp_ref(MOXA_TCP::AIS);
 			this->devices[S::PLC] = plc;
 		}
@@ -132,6 +154,7 @@ namespace {
 		void load(float width, float height) {
 			this->background = this->master->insert_one(new Rectanglet(width, height, bar_background));
 			this->log_receiver = this->master->insert_one(new Statuslinelet(default_gps_logging_level));
+			capture_logger()->push_log_receiver(this->log_receiver);
 			
 			this->load_device_indicator(S::GPS1, MOXA_TCP::MRIT_DGPS, this->status_font);
 			this->load_device_indicator(S::GPS2, MOXA_TCP::DP_DGPS, this->status_font);
@@ -171,9 +194,7 @@ namespace {
 	public:
 		void update(long long count, long long interval, long long uptime) {
 			if (this->plc != nullptr) {
-				if (this->plc->connected()) {
-					this->plc->send_scheduled_request(count, interval, uptime);
-				}
+				this->plc->send_scheduled_request(count, interval, uptime);
 			}
 
 			{ // check devices status
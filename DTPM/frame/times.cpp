@@ -13,6 +13,7 @@
 #include "graphlet/ui/textlet.hpp"
 
 #include "configuration.hpp"
+#include "intern.hpp"
 #include "plc.hpp"
 
 #include "iotables/di_hopper_pumps.hpp"
@@ -25,8 +26,8 @@ using namespace Microsoft::Graphics::Canvas::UI;
 using namespace Microsoft::Graphics::Canvas::Text;
 using namespace Microsoft::Graphics::Canvas::Brushes;
 
-static CanvasSolidColorBrush^ region_background = Colours::make(diagnostics_region_background);
-static CanvasSolidColorBrush^ metrics_background = Colours::make(diagnostics_alarm_background);
+static CanvasSolidColorBrush^ region_background = intern_brush(diagnostics_region_background);
+static CanvasSolidColorBrush^ metrics_background = intern_brush(diagnostics_alarm_background);
 static CanvasSolidColorBrush^ metrics_foreground = Colours::Green;
 
 static Platform::String^ dredging_open_timepoint_key = "Dredging_Open_UTC_Milliseconds";
@@ -39,8 +40,8 @@ namespace {
 	private class Times final : public PLCConfirmation {
 	public:
 		Times(TimesFrame* master, float width) : master(master), width(width) {
-			this->label_font = make_bold_text_format("Microsoft YaHei", normal_font_size);
-			this->metrics_font = make_bold_text_format("Cambria Math", large_font_size);
+			this->label_font = intern_bold_text_format("Microsoft YaHei", normal_font_size);
+			this->metrics_font = intern_bold_text_format("Cambria Math", large_font_size);
 
 			this->slot_height = this->metrics_font->FontSize * 1.2F;
 			this->inset = this->metrics_font->FontSize * 0.618F;
@@ -183,13 +184,13 @@ namespace {
 }
 
 /*************************************************************************************************/
-TimesFrame::TimesFrame(float width, MRMaster* plc) : Planet(__MODULE__), plc(plc) {
+TimesFrame::TimesFrame(float width, PLCMaster* plc) : Planet(__MODULE__), plc(plc) {
 	Times* dashboard = new Times(this, width);
 	
 	this->dashboard = dashboard;
 
 	if (this->plc != nullptr) {
-		this->plc->push_confirmation_receiver(dashboard);
+		this->plc->push_frame_receiver(dashboard);
 	}
 }
 
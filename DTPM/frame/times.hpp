@@ -3,13 +3,13 @@
 #include "planet.hpp"
 
 #include "gps.hpp"
-#include "mrit.hpp"
+#include "plc.hpp"
 
 namespace WarGrey::DTPM {
 	private class TimesFrame : public WarGrey::SCADA::Planet {
 	public:
 		virtual ~TimesFrame() noexcept;
-		TimesFrame(float width, WarGrey::SCADA::MRMaster* plc = nullptr);
+		TimesFrame(float width, WarGrey::SCADA::PLCMaster* plc = nullptr);
 
 	public:
 		void load(Microsoft::Graphics::Canvas::UI::CanvasCreateResourcesReason reason, float width, float height) override;
@@ -19,7 +19,7 @@ namespace WarGrey::DTPM {
 		bool can_select(WarGrey::SCADA::IGraphlet* g) override;
 
 	private:
-		WarGrey::SCADA::MRMaster* plc;
+		WarGrey::SCADA::PLCMaster* plc;
 		WarGrey::SCADA::MRConfirmation* dashboard;
 	};
 }
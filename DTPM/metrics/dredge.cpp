@@ -90,7 +90,7 @@ private: // never deletes these global objects
 };
 
 /*************************************************************************************************/
-DredgeMetrics::DredgeMetrics(Compass* compass, MRMaster* plc) {
+DredgeMetrics::DredgeMetrics(Compass* compass, PLCMaster* plc) {
 	this->provider = new DredgeMetrics::Provider();
 
 	if (compass != nullptr) {
@@ -98,7 +98,7 @@ DredgeMetrics::DredgeMetrics(Compass* compass, MRMaster* plc) {
 	}
 
 	if (plc != nullptr) {
-		plc->push_confirmation_receiver(this->provider);
+		plc->push_frame_receiver(this->provider);
 	}
 }
 
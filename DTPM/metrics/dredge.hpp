@@ -8,7 +8,7 @@
 namespace WarGrey::DTPM {
 	private class DredgeMetrics : public virtual WarGrey::DTPM::IMetricsProvider {
 	public:
-		DredgeMetrics(WarGrey::DTPM::Compass* compass, WarGrey::SCADA::MRMaster* plc);
+		DredgeMetrics(WarGrey::DTPM::Compass* compass, WarGrey::SCADA::PLCMaster* plc);
 
 	public:
 		unsigned int capacity() override;
@@ -0,0 +1,30 @@
+﻿#include "metrics/readoutlet.hpp"
+
+using namespace WarGrey::SCADA;
+using namespace WarGrey::DTPM;
+
+/*************************************************************************************************/
+void Readoutlet::update(long long count, long long interval, long long uptime) {
+	if (this->readouts_changed()) {
+		Metricslet::update(count, interval, uptime);
+	}
+}
+
+bool Readoutlet::readouts_changed() {
+	unsigned int capacity = this->provider->capacity();
+	bool changed = false;
+
+	for (unsigned int idx = 0; idx < capacity; idx++) {
+		MetricValue mv = this->provider->value_ref(idx);
+		bool type_changed = this->types.changed(idx, double(static_cast<unsigned int>(mv.type)), 0U);
+
+		// NOTE: only flonums come with precisions, the others are shown in full
+		if (mv.type == MetricValueType::Flonum) {
+			changed = (this->values.changed(idx, mv.as.flonum, mv.precision) || type_changed || changed);
+		} else {
+			changed = (this->values.changed(idx, double(mv.as.fixnum), 0U) || type_changed || changed);
+		}
+	}
+
+	return changed;
+}
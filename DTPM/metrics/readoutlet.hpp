@@ -0,0 +1,29 @@
+#pragma once
+
+#include "graphlet/ui/metricslet.hpp"
+
+#include "readout.hpp"
+
+namespace WarGrey::DTPM {
+	/** NOTE
+	 * Metrics providers are polled every frame, but the rows rarely change after rounding to their precisions,
+	 *   `Readoutlet` asks its provider first and lets the `Metricslet` refresh only if some row really changed.
+	 */
+	private class Readoutlet : public WarGrey::DTPM::Metricslet {
+	public:
+		template<typename... Args>
+		Readoutlet(WarGrey::DTPM::IMetricsProvider* provider, Args... args)
+			: Metricslet(provider, args...), provider(provider) {}
+
+	public:
+		void update(long long count, long long interval, long long uptime) override;
+
+	private:
+		bool readouts_changed();
+
+	private:
+		WarGrey::DTPM::IMetricsProvider* provider;
+		WarGrey::SCADA::ReadoutCache<unsigned int> values;
+		WarGrey::SCADA::ReadoutCache<unsigned int> types;
+	};
+}
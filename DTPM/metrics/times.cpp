@@ -14,6 +14,7 @@
 #include "brushes.hxx"
 
 #include "configuration.hpp"
+#include "intern.hpp"
 #include "plc.hpp"
 
 #include "iotables/di_hopper_pumps.hpp"
@@ -27,8 +28,8 @@ using namespace Microsoft::Graphics::Canvas::UI;
 using namespace Microsoft::Graphics::Canvas::Text;
 using namespace Microsoft::Graphics::Canvas::Brushes;
 
-static CanvasSolidColorBrush^ region_background = Colours::make(diagnostics_region_background);
-static CanvasSolidColorBrush^ metrics_background = Colours::make(diagnostics_alarm_background);
+static CanvasSolidColorBrush^ region_background = intern_brush(diagnostics_region_background);
+static CanvasSolidColorBrush^ metrics_background = intern_brush(diagnostics_alarm_background);
 static CanvasSolidColorBrush^ metrics_foreground = Colours::Green;
 
 static Platform::String^ dredging_open_timepoint_key = "Dredging_Open_UTC_Milliseconds";
@@ -86,11 +87,11 @@ private: // never deletes these global objects manually
 };
 
 /*************************************************************************************************/
-TimeMetrics::TimeMetrics(MRMaster* plc) {
+TimeMetrics::TimeMetrics(PLCMaster* plc) {
 	this->provider = new TimeMetrics::Provider();
 
 	if (plc != nullptr) {
-		plc->push_confirmation_receiver(this->provider);
+		plc->push_frame_receiver(this->provider);
 	}
 }
 
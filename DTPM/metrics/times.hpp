@@ -4,7 +4,7 @@
 
 #include "asn/der.hpp"
 
-#include "mrit.hpp"
+#include "plc.hpp"
 
 namespace WarGrey::DTPM {
 	private enum class TP : unsigned int {
@@ -33,7 +33,7 @@ namespace WarGrey::DTPM {
 
 	private class TimeMetrics : public WarGrey::DTPM::IMetricsProvider {
 	public:
-		TimeMetrics(WarGrey::SCADA::MRMaster* plc);
+		TimeMetrics(WarGrey::SCADA::PLCMaster* plc);
 
 	public:
 		unsigned int capacity() override;
@@ -9,6 +9,7 @@
 
 #include "metrics/dredge.hpp"
 #include "metrics/times.hpp"
+#include "metrics/readoutlet.hpp"
 
 #include "graphlet/planetlet.hpp"
 #include "graphlet/filesystem/s63let.hpp"
@@ -19,6 +20,9 @@
 
 #include "iotables/ai_dredges.hpp"
 
+#include "datum/time.hpp"
+#include "datum/flonum.hpp"
+
 #include "cs/wgs_xy.hpp"
 
 using namespace WarGrey::SCADA;
@@ -31,13 +35,40 @@ using namespace Microsoft::Graphics::Canvas::UI;
 using namespace Microsoft::Graphics::Canvas::Brushes;
 
 /*************************************************************************************************/
-DTPMonitor::DTPMonitor(Compass* compass, Transponder* transponder, MRMaster* plc)
-	: Planet(__MODULE__), compass(compass), transponder(transponder), plc(plc), track_source(nullptr) {
+private class AISViewport : public IAISTargetCursor {
+public:
+	AISViewport(AISlet* traffic) : traffic(traffic) {}
+
+public:
+	bool step(AISTarget& target) override {
+		if (!target.shown) { // the vessel has moved toward it since its last report
+			this->traffic->update_position(target.mmsi, &target.position);
+
+			if (target.voyaged) {
+				this->traffic->update_voyage(target.mmsi, &target.voyage);
+			}
+
+			target.shown = true;
+		}
+
+		return true;
+	}
+
+private:
+	AISlet* traffic;
+};
+
+/*************************************************************************************************/
+DTPMonitor::DTPMonitor(Compass* compass, Transponder* transponder, PLCMaster* plc)
+	: Planet(__MODULE__), compass(compass), transponder(transponder), plc(plc), track_source(nullptr)
+	, traffic(nullptr), thumbnail(nullptr), self_speed(flnan), self_course(flnan) {
 	Syslog* logger = make_system_logger(default_schema_logging_level, "DredgeTrackHistory");
 
 	this->track_source = new TrackDataSource(logger, RotationPeriod::Daily);
 	this->track_source->reference();
 
+	this->targets = new AISTargetTable(ais_target_capacity, ais_gridsize);
+
 	if (this->compass != nullptr) {
 		this->compass->push_receiver(this);
 	}
@@ -47,7 +78,7 @@ DTPMonitor::DTPMonitor(Compass* compass, Transponder* transponder, MRMaster* plc
 	}
 
 	if (this->plc != nullptr) {
-		this->plc->push_confirmation_receiver(this);
+		this->plc->push_frame_receiver(this);
 	}
 
 	this->memory = global_resident_metrics();
@@ -57,6 +88,12 @@ DTPMonitor::~DTPMonitor() {
 	if (this->track_source != nullptr) {
 		this->track_source->destroy();
 	}
+
+	delete this->targets;
+
+	if (this->thumbnail != nullptr) {
+		delete this->thumbnail;
+	}
 }
 
 void DTPMonitor::load(CanvasCreateResourcesReason reason, float width, float height) {
@@ -77,8 +114,8 @@ void DTPMonitor::load(CanvasCreateResourcesReason reason, float width, float hei
 	this->vessel = new TrailingSuctionDredgerlet("vessel", 1.0F);
 	this->track = new DredgeTracklet(this->track_source, "track", map_width, plot_height);
 	
-	this->metrics = this->insert_one(new Metricslet(new DredgeMetrics(this->compass, this->plc), "main", side_zone_width, GraphletAnchor::RT, 20U));
-	this->times = this->insert_one(new Metricslet(new TimeMetrics(this->plc), "worktime", side_zone_width, GraphletAnchor::RT, 3U));
+	this->metrics = this->insert_one(new Readoutlet(new DredgeMetrics(this->compass, this->plc), "main", side_zone_width, GraphletAnchor::RT, 20U));
+	this->times = this->insert_one(new Readoutlet(new TimeMetrics(this->plc), "worktime", side_zone_width, GraphletAnchor::RT, 3U));
 	this->status = this->insert_one(new Planetlet(status, width, status_height));
 	this->drags = this->insert_one(new Planetlet(drags, side_zone_width, 0.0F));
 	this->project = this->insert_one(new Projectlet(this->vessel, this->track, plot, L"湛江", map_width, plot_height));
@@ -104,6 +141,14 @@ void DTPMonitor::load(CanvasCreateResourcesReason reason, float width, float hei
 	{ // share the map to managed map objects
 		this->project->push_managed_map_objects(this->traffic);
 	}
+
+	{ // the snapshot is bound to the project, which is recreated along with the resources
+		if (this->thumbnail != nullptr) {
+			delete this->thumbnail;
+		}
+
+		this->thumbnail = new Snapshotlet(this->project, thumbnail_refresh_interval);
+	}
 }
 
 void DTPMonitor::reflow(float width, float height) {
@@ -131,6 +176,32 @@ void DTPMonitor::reflow(float width, float height) {
 }
 
 void DTPMonitor::update(long long count, long long interval, long long uptime) {
+	if ((count % frame_per_second) == 0) {
+		size_t evicted = 0U;
+
+		this->enter_critical_section();
+		this->begin_update_sequence();
+		evicted = this->targets->evict_stale(current_milliseconds(), ais_classA_ttl, ais_classB_ttl);
+
+		if ((this->project != nullptr) && (this->traffic != nullptr)) {
+			double2 vessel_pos = this->project->vessel_position();
+			AISViewport viewport(this->traffic);
+
+			this->targets->foreach_in_viewport(&viewport,
+				vessel_pos.x - ais_visible_range, vessel_pos.y - ais_visible_range,
+				vessel_pos.x + ais_visible_range, vessel_pos.y + ais_visible_range);
+
+			this->check_encounters(vessel_pos);
+		}
+
+		this->end_update_sequence();
+		this->leave_critical_section();
+
+		if (evicted > 0) {
+			this->get_logger()->log_message(Log::Debug, L"evicted %u stale AIS target(s), %u remain(s)",
+				evicted, this->targets->count());
+		}
+	}
 }
 
 void DTPMonitor::on_message(long long timepoint_ms, Platform::String^ remote_peer, uint16 port, MetricsBlock type, const uint8* message, Syslog* logger) {
@@ -140,8 +211,41 @@ void DTPMonitor::on_gps_message(long long timepoint_ms, DGPS& dgps) {
 
 }
 
+bool DTPMonitor::ais_target_visible(AISTarget* target) {
+	bool visible = ((target != nullptr) && target->located);
+
+	if (visible && (this->project != nullptr)) {
+		double2 vessel_pos = this->project->vessel_position();
+
+		visible = ((flabs(target->x - vessel_pos.x) <= ais_visible_range)
+			&& (flabs(target->y - vessel_pos.y) <= ais_visible_range));
+	}
+
+	return visible;
+}
+
+void DTPMonitor::check_encounters(double2& vessel_pos) {
+	AISEncounter encounters[ais_cpa_candidates];
+	size_t n = this->targets->nearest_cpa_candidates(encounters, vessel_pos.x, vessel_pos.y,
+		this->self_speed, this->self_course, ais_cpa_range, ais_tcpa_limit);
+
+	for (size_t idx = 0; idx < n; idx++) {
+		AISTarget* target = encounters[idx].target;
+
+		if (encounters[idx].cpa <= ais_cpa_warning) {
+			if (!target->warned) {
+				this->get_logger()->log_message(Log::Warning, L"AIS target %u: CPA %.0lfm in %.0lfs",
+					target->mmsi, encounters[idx].cpa, encounters[idx].tcpa);
+				target->warned = true;
+			}
+		} else {
+			target->warned = false;
+		}
+	}
+}
+
 IGraphlet* DTPMonitor::thumbnail_graphlet() {
-	return this->project;
+	return this->thumbnail;
 }
 
 bool DTPMonitor::can_select(IGraphlet* g) {
@@ -215,6 +319,9 @@ void DTPMonitor::on_sail(long long timepoint_ms, double s_kn, double track_deg,
 	if (this->traffic != nullptr) {
 		this->traffic->update_self_course(track_deg);
 	}
+
+	this->self_speed = s_kn;
+	this->self_course = track_deg;
 }
 
 void DTPMonitor::on_heading(long long timepoint_ms, double deg, Syslog* logger) {
@@ -226,10 +333,15 @@ void DTPMonitor::on_heading(long long timepoint_ms, double deg, Syslog* logger)
 
 void DTPMonitor::post_move(Syslog* logger) {
 	this->end_update_sequence();
+
+	if (this->thumbnail != nullptr) {
+		this->thumbnail->invalidate();
+	}
 }
 
 /*************************************************************************************************/
 void DTPMonitor::pre_respond(Syslog* logger) {
+	this->enter_critical_section();
 	this->begin_update_sequence();
 }
 
@@ -253,20 +365,39 @@ void DTPMonitor::on_self_position_report(long long timepoint_ms, AISPositionRepo
 }
 
 void DTPMonitor::on_position_report(long long timepoint_ms, uint16 mmsi, AISPositionReport* pr, Syslog* logger) {
-	if (this->traffic != nullptr) {
-		this->traffic->update_position(mmsi, pr);
+	AISTarget* target = this->targets->update_position(timepoint_ms, mmsi, pr);
+
+	// NOTE: the map only needs to know ships around, far away ones are kept in the table silently
+	if ((this->traffic != nullptr) && (target != nullptr)) {
+		if (this->ais_target_visible(target)) {
+			this->traffic->update_position(mmsi, pr);
+
+			if ((!target->shown) && target->voyaged) { // the voyage might be reported when the ship is far away
+				this->traffic->update_voyage(mmsi, &target->voyage);
+			}
+
+			target->shown = true;
+		} else { // the map keeps its last position, but no more updates
+			target->shown = false;
+		}
 	}
 }
 
 void DTPMonitor::on_voyage_report(long long timepoint_ms, uint16 mmsi, AISVoyageReport* vr, Syslog* logger) {
-	if (this->traffic != nullptr) {
+	AISTarget* target = this->targets->update_voyage(timepoint_ms, mmsi, vr);
+
+	// NOTE: voyages of ships whose positions are not known yet are kept in the table
+	if ((this->traffic != nullptr) && (target != nullptr) && target->shown) {
 		this->traffic->update_voyage(mmsi, vr);
 	}
 }
 
 void DTPMonitor::post_respond(Syslog* logger) {
-	if (this->traffic != nullptr) {
-		this->end_update_sequence();
+	this->end_update_sequence();
+	this->leave_critical_section();
+
+	if (this->thumbnail != nullptr) {
+		this->thumbnail->invalidate();
 	}
 }
 
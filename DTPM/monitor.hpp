@@ -13,6 +13,8 @@
 #include "metrics.hpp"
 #include "compass.hpp"
 #include "transponder.hpp"
+#include "traffic.hpp"
+#include "snapshot.hpp"
 #include "plc.hpp"
 
 namespace WarGrey::DTPM {
@@ -24,7 +26,7 @@ namespace WarGrey::DTPM {
 		, public virtual WarGrey::GYDM::SlangLocalPeer<WarGrey::DTPM::MetricsBlock> {
 	public:
 		virtual ~DTPMonitor() noexcept;
-		DTPMonitor(WarGrey::DTPM::Compass* compass, WarGrey::DTPM::Transponder* ais, WarGrey::SCADA::MRMaster* plc);
+		DTPMonitor(WarGrey::DTPM::Compass* compass, WarGrey::DTPM::Transponder* ais, WarGrey::SCADA::PLCMaster* plc);
 
 	public:
 		void load(Microsoft::Graphics::Canvas::UI::CanvasCreateResourcesReason reason, float width, float height) override;
@@ -68,10 +70,13 @@ namespace WarGrey::DTPM {
 		
 	private:
 		void on_gps_message(long long timepoint_ms, WarGrey::DTPM::DGPS& dgps);
+		bool ais_target_visible(WarGrey::DTPM::AISTarget* target);
+		void check_encounters(Windows::Foundation::Numerics::double2& vessel_pos);
 
 	private: // never deletes these graphlets manually
 		WarGrey::DTPM::TrailingSuctionDredgerlet* vessel;
 		WarGrey::DTPM::ITrackDataSource* track_source;
+		WarGrey::DTPM::AISTargetTable* targets;
 		WarGrey::DTPM::DredgeTracklet* track;
 		WarGrey::SCADA::Planetlet* metrics;
 		WarGrey::SCADA::Planetlet* times;
@@ -83,10 +88,15 @@ namespace WarGrey::DTPM {
 		WarGrey::SCADA::Planetlet* drags;
 		WarGrey::SCADA::Planetlet* status;
 
+	private:
+		WarGrey::DTPM::Snapshotlet* thumbnail;
+		double self_speed;
+		double self_course;
+
 	private: // never deletes these shared objects
 		WarGrey::DTPM::Compass* compass;
 		WarGrey::DTPM::Transponder* transponder;
-		WarGrey::SCADA::MRMaster* plc;
+		WarGrey::SCADA::PLCMaster* plc;
 
 	private: // never deletes these global objects
 		WarGrey::DTPM::ResidentMetrics* memory;
@@ -1,7 +1,16 @@
-﻿#include "schema/datalet/track_ds.hpp"
+﻿#include <algorithm>
+#include <vector>
+
+#include "schema/datalet/track_ds.hpp"
 #include "schema/track.hpp"
+#include "configuration.hpp"
+#include "durability.hpp"
+#include "archive.hpp"
+#include "resultset.hpp"
 #include "dbmisc.hpp"
 
+#include "datum/enum.hpp"
+
 using namespace WarGrey::SCADA;
 using namespace WarGrey::DTPM;
 using namespace WarGrey::GYDM;
@@ -42,7 +51,7 @@ namespace {
 		}
 
 	public:
-		unsigned int count;
+		unsigned int count = 0U;
 
 	private:
 		double3 dot;
@@ -52,20 +61,134 @@ namespace {
 		long long close_timepoint;
 		long long open_s;
 	};
+
+	private enum class TrackColumn { Type, X, Y, Z, _ };
+
+	private class TrackArchiver : public ITrackCursor {
+	public:
+		TrackArchiver(ColumnarArchiveWriter* writer) : writer(writer) {}
+
+	public:
+		bool step(Track& track, bool asc, int code) override {
+			this->tempdata[_I(TrackColumn::Type)] = double(track.type);
+			this->tempdata[_I(TrackColumn::X)] = track.x;
+			this->tempdata[_I(TrackColumn::Y)] = track.y;
+			this->tempdata[_I(TrackColumn::Z)] = track.z;
+
+			this->writer->append(track.timestamp, this->tempdata);
+
+			return true;
+		}
+
+	private:
+		double tempdata[_N(TrackColumn)];
+		ColumnarArchiveWriter* writer;
+	};
+}
+
+namespace {
+	private class TrackExporter : public ITrackCursor {
+	public:
+		TrackExporter(IHistoryExportSink* sink, long long open_ms, long long close_ms)
+			: sink(sink), open_timepoint(open_ms), close_timepoint(close_ms) {}
+
+	public:
+		bool step(Track& track, bool asc, int code) override {
+			long long ts = track.timestamp;
+			bool go_on = true;
+
+			if ((ts >= this->open_timepoint) && (ts <= this->close_timepoint)) {
+				this->tempdata[_I(TrackColumn::Type)] = double(track.type);
+				this->tempdata[_I(TrackColumn::X)] = track.x;
+				this->tempdata[_I(TrackColumn::Y)] = track.y;
+				this->tempdata[_I(TrackColumn::Z)] = track.z;
+
+				go_on = this->sink->push(ts, this->tempdata);
+			}
+
+			return go_on && (ts <= this->close_timepoint);
+		}
+
+	private:
+		double tempdata[_N(TrackColumn)];
+		IHistoryExportSink* sink;
+		long long open_timepoint;
+		long long close_timepoint;
+	};
+}
+
+/** NOTE
+ * Tracks are loaded page by page within a range, the (timestamp, uuid) index keeps each page a seek
+ *   instead of a scan, timestamps are not unique since tracks of different types may share them.
+ */
+static void track_prepare(IDBSystem* dbc) {
+	apply_durability(dbc, DurabilityProfile::Telemetry);
+	create_track(dbc, true);
+	dbc->exec("CREATE INDEX IF NOT EXISTS track_timestamp_uuid ON track (timestamp, uuid);");
 }
 
-static int track_busy_handler(void* args, int count) {
-	// keep trying until it works
-	return 1;
+static void track_restore(Track& track, long long timepoint, const double* values) {
+	track.timestamp = timepoint;
+	track.type = (long long)(values[_I(TrackColumn::Type)]);
+	track.x = values[_I(TrackColumn::X)];
+	track.y = values[_I(TrackColumn::Y)];
+	track.z = values[_I(TrackColumn::Z)];
+}
+
+/*************************************************************************************************/
+size_t WarGrey::SCADA::select_track_into(IDBSystem* dbc, Track* buffer, size_t capacity
+	, long long open_ms, long long close_ms, const Track* last, bool asc) {
+	BufferResultSet<Track, ITrackCursor> rs(buffer, capacity);
+
+	if (capacity > 0U) {
+		IPreparedStatement* stmt = dbc->prepare(asc
+			? "SELECT uuid, type, x, y, z, timestamp FROM track WHERE timestamp >= ? AND timestamp <= ?"
+			  " AND (timestamp > ? OR (timestamp = ? AND uuid > ?)) ORDER BY timestamp ASC, uuid ASC LIMIT ?;"
+			: "SELECT uuid, type, x, y, z, timestamp FROM track WHERE timestamp >= ? AND timestamp <= ?"
+			  " AND (timestamp < ? OR (timestamp = ? AND uuid < ?)) ORDER BY timestamp DESC, uuid DESC LIMIT ?;");
+
+		if (stmt != nullptr) {
+			// the first page starts from just outside the range
+			Integer last_timestamp = ((last != nullptr) ? last->timestamp : (asc ? (open_ms - 1LL) : (close_ms + 1LL)));
+			Integer last_uuid = ((last != nullptr) ? last->uuid : 0LL);
+			Track self;
+
+			stmt->bind_parameter(0U, Integer(open_ms));
+			stmt->bind_parameter(1U, Integer(close_ms));
+			stmt->bind_parameter(2U, last_timestamp);
+			stmt->bind_parameter(3U, last_timestamp);
+			stmt->bind_parameter(4U, last_uuid);
+			stmt->bind_parameter(5U, Integer(capacity));
+
+			while (stmt->step()) {
+				restore_track(self, stmt);
+
+				if (!rs.step(self, asc, dbc->last_errno())) {
+					break;
+				}
+			}
+
+			delete stmt;
+		}
+	}
+
+	return rs.count;
 }
 
 /*************************************************************************************************/
 TrackDataSource::TrackDataSource(Syslog* logger, RotationPeriod period, unsigned int period_count)
-	: RotativeSQLite3("track", logger, period, period_count), open_timepoint(0LL) {}
+	: RotativeSQLite3("track", logger, period, period_count), open_timepoint(0LL) {
+	this->persistence = new PersistenceQueue(this->get_logger(), PersistencePolicy::Lossy,
+		persistence_queue_capacity, persistence_batch_size, track_prepare);
+	this->recent = new HistoryRing<Track>(history_ring_capacity);
+}
 
 TrackDataSource::~TrackDataSource() {
 	this->cancel();
 
+	delete this->persistence; // pending records are written before returning
+	delete this->recent;
+
 	if (this->dbc != nullptr) {
 		delete this->dbc;
 	}
@@ -88,12 +211,44 @@ void TrackDataSource::cancel() {
 void TrackDataSource::on_database_rotated(WarGrey::SCADA::SQLite3* prev_dbc, WarGrey::SCADA::SQLite3* dbc, long long timepoint) {
 	// TODO: move the temporary data from in-memory SQLite3 into the current SQLite3
 
-	create_track(dbc, true);
+	if (prev_dbc != nullptr) {
+		checkpoint_durability(prev_dbc);
+	}
+
+	track_prepare(dbc);
 	this->get_logger()->log_message(Log::Debug, L"current file: %S", dbc->filename().c_str());
+
+	this->do_compacting_async();
+}
+
+void TrackDataSource::do_compacting_async() {
+	long long aged = this->resolve_timepoint(current_seconds()) - this->span_seconds() * history_archive_age;
+	std::vector<Platform::String^> sources;
+	Syslog* logger = this->get_logger();
+
+	for (unsigned int idx = 0; idx < history_archive_sweep; idx++) {
+		sources.push_back(this->resolve_pathname(aged - this->span_seconds() * idx));
+	}
+
+	create_task([=]() {
+		for (auto it = sources.begin(); it != sources.end(); it++) {
+			columnar_archive_compact((*it), columnar_archive_name(*it), _N(TrackColumn),
+				[](IDBSystem* dbc) {
+					return (unsigned long long)(track_count(dbc));
+				},
+				[](IDBSystem* dbc, ColumnarArchiveWriter* writer) {
+					TrackArchiver archiver(writer);
+
+					foreach_track(dbc, &archiver, 0, 0, track::timestamp, true);
+				}, logger);
+		}
+	});
 }
 
 void TrackDataSource::load(ITrackDataReceiver* receiver, uint8 id, long long open_s, long long close_s) {
-	if (!this->loading()) {
+	if (this->recent->covers(open_s * 1000LL, close_s * 1000LL)) {
+		this->do_loading_from_memory(receiver, id, open_s, close_s);
+	} else if (!this->loading()) {
 		long long start = this->resolve_timepoint(open_s);
 		long long end = this->resolve_timepoint(close_s);
 		long long interval = this->span_seconds() * ((open_s < close_s) ? 1LL : -1LL);
@@ -118,7 +273,44 @@ void TrackDataSource::save(long long timepoint, long long type, double3& dot) {
 	track.z = dot.z;
 	track.timestamp = timepoint;
 
-	insert_track(this, track);
+	this->recent->push(timepoint, track);
+	this->persistence->push(this->resolve_pathname(timepoint / 1000LL), [=](IDBSystem* dbc) mutable { insert_track(dbc, track); });
+}
+
+task<unsigned long long> TrackDataSource::export_async(Platform::String^ filename, long long open_s, long long close_s
+	, HistoryExportFormat format, long long bucket_s, cancellation_token token) {
+	std::vector<std::string> columns = { "type", "x", "y", "z" };
+	std::vector<Platform::String^> sources;
+	long long end = this->resolve_timepoint(std::max(open_s, close_s));
+
+	for (long long ts = this->resolve_timepoint(std::min(open_s, close_s)); ts <= end; ts += this->span_seconds()) {
+		sources.push_back(this->resolve_pathname(ts));
+	}
+
+	return history_export_async(filename, format, columns, sources,
+		std::min(open_s, close_s) * 1000LL, std::max(open_s, close_s) * 1000LL, bucket_s * 1000LL,
+		[](IDBSystem* dbc, long long open_ms, long long close_ms, IHistoryExportSink* sink) {
+			TrackExporter exporter(sink, open_ms, close_ms);
+
+			foreach_track(dbc, &exporter, 0, 0, track::timestamp, true);
+		}, token, this->get_logger());
+}
+
+void TrackDataSource::do_loading_from_memory(ITrackDataReceiver* receiver, uint8 id, long long open_s, long long close_s) {
+	TrackCursor tcursor(receiver, id, open_s, close_s);
+	double ms = current_inexact_milliseconds();
+	bool asc = (open_s < close_s);
+
+	receiver->begin_maniplation_sequence(id);
+	this->recent->foreach(open_s * 1000LL, close_s * 1000LL, asc, [&](Track& track) {
+		return tcursor.step(track, asc, 0);
+	});
+	receiver->end_maniplation_sequence(id);
+
+	this->get_logger()->log_message(Log::Debug, L"loaded %d record(s) from memory within %lfms",
+		tcursor.count, current_inexact_milliseconds() - ms);
+
+	receiver->on_maniplation_complete(id, open_s, close_s);
 }
 
 void TrackDataSource::do_loading_async(ITrackDataReceiver* receiver, uint8 id
@@ -136,21 +328,62 @@ void TrackDataSource::do_loading_async(ITrackDataReceiver* receiver, uint8 id
 		this->open_timepoint = 0LL;
 	} else {
 		Platform::String^ dbsource = this->resolve_filename(start);
+		Platform::String^ archive = columnar_archive_name(this->resolve_pathname(start));
 		cancellation_token token = this->watcher.get_token();
 
 		create_task(this->rootdir()->TryGetItemAsync(dbsource), token).then([=](task<IStorageItem^> getting) {
 			IStorageItem^ db = getting.get();
 			long long next_timepoint = start + interval;
+			ColumnarArchiveReader reader(archive->Data());
+
+			if (reader.ready()) { // aged periods are read from their archives
+				TrackCursor tcursor(receiver, id, this->open_timepoint, this->close_timepoint);
+				double ms = current_inexact_milliseconds();
+				Track track;
+
+				receiver->begin_maniplation_sequence(id);
+				reader.foreach(std::min(this->open_timepoint, this->close_timepoint) * 1000LL,
+					std::max(this->open_timepoint, this->close_timepoint) * 1000LL, asc,
+					[&](long long timepoint, const double* values) {
+						track_restore(track, timepoint, values);
+
+						return tcursor.step(track, asc, 0);
+					});
+				receiver->end_maniplation_sequence(id);
 
-			if ((db != nullptr) && (db->IsOfType(StorageItemTypes::File))) {
+				ms = current_inexact_milliseconds() - ms;
+				this->get_logger()->log_message(Log::Debug, L"loaded %d record(s) from[%s] within %lfms",
+					tcursor.count, archive->Data(), ms);
+
+				this->do_loading_async(receiver, id, next_timepoint, end, interval,
+					file_count + 1LL, total + tcursor.count, span_ms + ms);
+			} else if ((db != nullptr) && (db->IsOfType(StorageItemTypes::File))) {
 				TrackCursor tcursor(receiver, id, this->open_timepoint, this->close_timepoint);
+				long long open_ms = std::min(this->open_timepoint, this->close_timepoint) * 1000LL;
+				long long close_ms = std::max(this->open_timepoint, this->close_timepoint) * 1000LL;
+				std::vector<Track> page(history_prefetch_batch);
+				size_t count = page.size();
 				double ms = current_inexact_milliseconds();
+				Track* after = nullptr;
+				Track last;
 				
 				this->dbc = new SQLite3(db->Path->Data(), this->get_logger());
-				this->dbc->set_busy_handler(track_busy_handler);
+				this->dbc->set_busy_handler(durability_busy_handler);
+				apply_durability(this->dbc, DurabilityProfile::Reader);
 
 				receiver->begin_maniplation_sequence(id);
-				foreach_track(this->dbc, &tcursor, 0, 0, track::timestamp, asc);
+				while (count == page.size()) {
+					count = select_track_into(this->dbc, page.data(), page.size(), open_ms, close_ms, after, asc);
+
+					for (size_t idx = 0; idx < count; idx++) {
+						tcursor.step(page[idx], asc, 0);
+					}
+
+					if (count > 0U) {
+						last = page[count - 1U];
+						after = &last;
+					}
+				}
 				receiver->end_maniplation_sequence(id);
 
 				delete this->dbc;
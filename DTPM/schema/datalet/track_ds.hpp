@@ -6,7 +6,21 @@
 
 #include "sqlite3/rotation.hpp"
 
+#include "persistence.hpp"
+#include "hotring.hpp"
+#include "export.hpp"
+
+#include "schema/track.hpp"
+
 namespace WarGrey::SCADA {
+	/**
+	 * restores at most `capacity` tracks within [`open_ms`, `close_ms`] into `buffer`, ordered by (timestamp, uuid),
+	 *   the page starts right after `last`, the last track of the previous page, or `nullptr` for the first page.
+	 * returns the number of tracks restored, the range is exhausted if it is less than `capacity`.
+	 */
+	size_t select_track_into(WarGrey::SCADA::IDBSystem* dbc, WarGrey::SCADA::Track* buffer, size_t capacity,
+		long long open_ms, long long close_ms, const WarGrey::SCADA::Track* last = nullptr, bool asc = true);
+
 	private class TrackDataSource
 		: public WarGrey::DTPM::ITrackDataSource
 		, public WarGrey::SCADA::RotativeSQLite3 {
@@ -24,6 +38,10 @@ namespace WarGrey::SCADA {
 		void load(WarGrey::DTPM::ITrackDataReceiver* receiver, uint8 id, long long open_s, long long close_s) override;
 		void save(long long timepoint, long long type, WarGrey::SCADA::double3& dot) override;
 
+	public:
+		Concurrency::task<unsigned long long> export_async(Platform::String^ filename, long long open_s, long long close_s,
+			WarGrey::SCADA::HistoryExportFormat format, long long bucket_s, Concurrency::cancellation_token token);
+
 	protected:
 		void on_database_rotated(WarGrey::SCADA::SQLite3* prev_dbc, WarGrey::SCADA::SQLite3* current_dbc, long long timepoint) override;
 
@@ -35,11 +53,18 @@ namespace WarGrey::SCADA {
 			long long start, long long end, long long interval,
 			unsigned int file_count, unsigned int total, double span_ms);
 
+		void do_loading_from_memory(WarGrey::DTPM::ITrackDataReceiver* receiver, uint8 id, long long open_s, long long close_s);
+		void do_compacting_async();
+
 	private:
 		Concurrency::cancellation_token_source watcher;
 		WarGrey::SCADA::ISQLite3* dbc;
 		long long open_timepoint;
 		long long close_timepoint;
 		double time0;
+
+	private:
+		WarGrey::SCADA::PersistenceQueue* persistence;
+		WarGrey::SCADA::HistoryRing<WarGrey::SCADA::Track>* recent;
 	};
 }
@@ -0,0 +1,51 @@
+#include "snapshot.hpp"
+
+#include "datum/time.hpp"
+
+using namespace WarGrey::SCADA;
+using namespace WarGrey::DTPM;
+
+using namespace Microsoft::Graphics::Canvas;
+
+/*************************************************************************************************/
+Snapshotlet::Snapshotlet(IGraphlet* target, long long refresh_interval)
+	: target(target), refresh_interval(refresh_interval), last_refresh(0LL), dirty(true) {}
+
+void Snapshotlet::fill_extent(float x, float y, float* w, float* h) {
+	this->target->fill_extent(x, y, w, h);
+}
+
+void Snapshotlet::invalidate() {
+	this->dirty = true;
+}
+
+void Snapshotlet::draw(CanvasDrawingSession^ ds, float x, float y, float Width, float Height) {
+	long long now = current_milliseconds();
+	bool resized = ((this->snapshot == nullptr)
+		|| (this->snapshot->Size.Width != Width)
+		|| (this->snapshot->Size.Height != Height));
+
+	bool refreshing = (resized || ((now - this->last_refresh) >= this->refresh_interval));
+
+	if (refreshing) { // cleared before rerendering, so that the changes reported meanwhile are not lost
+		refreshing = (this->dirty.exchange(false) || resized);
+	}
+
+	if (refreshing) {
+		if (resized) {
+			this->snapshot = ref new CanvasRenderTarget(ds, Width, Height);
+		}
+
+		{ // rerender the target
+			CanvasDrawingSession^ sds = this->snapshot->CreateDrawingSession();
+
+			sds->Clear(Windows::UI::Colors::Transparent);
+			this->target->draw(sds, 0.0F, 0.0F, Width, Height);
+			delete sds;
+		}
+
+		this->last_refresh = now;
+	}
+
+	ds->DrawImage(this->snapshot, x, y);
+}
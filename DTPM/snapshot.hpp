@@ -0,0 +1,32 @@
+#pragma once
+
+#include <atomic>
+
+#include "graphlet/primitive.hpp"
+
+namespace WarGrey::DTPM {
+	/** NOTE
+	 * The navigator draws the thumbnail of a page all the time, even if the operator is working on that page,
+	 *   `Snapshotlet` renders its target into a cached bitmap instead, and only rerenders it
+	 *   after the page has reported changes and at most once per `refresh_interval` milliseconds,
+	 *   otherwise the thumbnail costs nothing but a blit.
+	 */
+	private class Snapshotlet : public WarGrey::SCADA::IGraphlet {
+	public:
+		Snapshotlet(WarGrey::SCADA::IGraphlet* target, long long refresh_interval);
+
+	public:
+		void fill_extent(float x, float y, float* w = nullptr, float* h = nullptr) override;
+		void draw(Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds, float x, float y, float Width, float Height) override;
+
+	public:
+		void invalidate();
+
+	private:
+		WarGrey::SCADA::IGraphlet* target;
+		Microsoft::Graphics::Canvas::CanvasRenderTarget^ snapshot;
+		long long refresh_interval;
+		long long last_refresh;
+		std::atomic<bool> dirty; // invalidated by the threads that update the target
+	};
+}
@@ -0,0 +1,447 @@
+#include <cmath>
+
+#include "traffic.hpp"
+
+#include "datum/flonum.hpp"
+
+#include "math.hpp"
+
+using namespace WarGrey::SCADA;
+using namespace WarGrey::DTPM;
+
+/*************************************************************************************************/
+static const double knot_to_mps = 1852.0 / 3600.0;
+
+static inline size_t smallest_power_of_two(size_t n) {
+	size_t pow2 = 1U;
+
+	while (pow2 < n) {
+		pow2 <<= 1U;
+	}
+
+	return pow2;
+}
+
+static inline size_t mmsi_hash(uint16 mmsi) {
+	return size_t(uint32(mmsi) * 2654435761U);
+}
+
+static inline void fill_velocity(double speed_kn, double course_deg, double* vx, double* vy) {
+	if (flisnan(speed_kn) || flisnan(course_deg)) {
+		(*vx) = 0.0;
+		(*vy) = 0.0;
+	} else {
+		double rad = degrees_to_radians(course_deg);
+		double mps = speed_kn * knot_to_mps;
+
+		(*vx) = mps * std::cos(rad); // northing
+		(*vy) = mps * std::sin(rad); // easting
+	}
+}
+
+/*************************************************************************************************/
+AISTargetTable::AISTargetTable(size_t capacity, double gridsize) : gridsize(gridsize), size(0U), stamp(0U) {
+	size_t pow2 = smallest_power_of_two(capacity);
+
+	this->targets.resize(capacity);
+	this->cells.resize(capacity, pow2);
+	this->prevs.resize(capacity, -1);
+	this->nexts.resize(capacity, -1);
+	this->index.resize(pow2 * 2U, -1);
+	this->buckets.resize(pow2, -1);
+	this->stamps.resize(pow2, 0U);
+
+	for (size_t idx = 0; idx < capacity; idx++) {
+		this->nexts[idx] = int(idx + 1);
+	}
+
+	this->nexts[capacity - 1] = -1;
+	this->free_head = 0;
+}
+
+size_t AISTargetTable::count() {
+	return this->size;
+}
+
+size_t AISTargetTable::capacity() {
+	return this->targets.size();
+}
+
+AISTarget* AISTargetTable::ref(uint16 mmsi) {
+	bool found = false;
+	size_t islot = this->index_slot(mmsi, &found);
+
+	return (found ? &this->targets[this->index[islot]] : nullptr);
+}
+
+AISTarget* AISTargetTable::update_position(long long timepoint_ms, uint16 mmsi, AISPositionReport* pr) {
+	AISTarget* target = nullptr;
+	int tidx = this->intern(mmsi);
+
+	if (tidx >= 0) {
+		size_t bucket = this->resolve_bucket(pr->geo.x, pr->geo.y);
+
+		target = &this->targets[tidx];
+		target->type = pr->type;
+		target->x = pr->geo.x;
+		target->y = pr->geo.y;
+		target->speed = pr->speed;
+		target->course = pr->course;
+		target->heading = pr->heading;
+		target->timepoint = timepoint_ms;
+		target->position = (*pr);
+		target->located = true;
+
+		if (this->cells[tidx] != bucket) {
+			this->cell_unlink(tidx);
+			this->cell_link(tidx, bucket);
+		}
+	}
+
+	return target;
+}
+
+AISTarget* AISTargetTable::update_voyage(long long timepoint_ms, uint16 mmsi, AISVoyageReport* vr) {
+	AISTarget* target = nullptr;
+	int tidx = this->intern(mmsi);
+
+	if (tidx >= 0) {
+		target = &this->targets[tidx];
+		target->voyage = (*vr);
+		target->voyaged = true;
+
+		if (!target->located) { // only voyages keep it alive before its position is known
+			target->timepoint = timepoint_ms;
+		}
+	}
+
+	return target;
+}
+
+bool AISTargetTable::remove(uint16 mmsi) {
+	bool found = false;
+	size_t islot = this->index_slot(mmsi, &found);
+
+	if (found) {
+		int tidx = this->index[islot];
+
+		this->index_remove(islot);
+		this->release(tidx);
+	}
+
+	return found;
+}
+
+size_t AISTargetTable::evict_stale(long long now_ms, long long classA_ttl_ms, long long classB_ttl_ms) {
+	size_t evicted = 0U;
+
+	for (size_t idx = 0; idx < this->targets.size(); idx++) {
+		if (this->occupied(idx)) {
+			AISTarget* target = &this->targets[idx];
+			long long ttl = ((target->type == AISType::A) ? classA_ttl_ms : classB_ttl_ms);
+
+			if ((now_ms - target->timepoint) > ttl) {
+				this->remove(target->mmsi);
+				evicted++;
+			}
+		}
+	}
+
+	return evicted;
+}
+
+/*************************************************************************************************/
+size_t AISTargetTable::foreach_in_viewport(IAISTargetCursor* cursor, double x0, double y0, double x1, double y1) {
+	double xmin = flmin(x0, x1);
+	double xmax = flmax(x0, x1);
+	double ymin = flmin(y0, y1);
+	double ymax = flmax(y0, y1);
+	long long cx0 = (long long)(std::floor(xmin / this->gridsize));
+	long long cx1 = (long long)(std::floor(xmax / this->gridsize));
+	long long cy0 = (long long)(std::floor(ymin / this->gridsize));
+	long long cy1 = (long long)(std::floor(ymax / this->gridsize));
+	double ncells = double(cx1 - cx0 + 1) * double(cy1 - cy0 + 1);
+	size_t found = 0U;
+	bool go_on = true;
+
+	if (ncells >= double(this->buckets.size())) { // zoomed out, the grid does not help
+		for (size_t idx = 0; go_on && (idx < this->targets.size()); idx++) {
+			if (this->cells[idx] < this->buckets.size()) {
+				AISTarget* target = &this->targets[idx];
+
+				if ((target->x >= xmin) && (target->x <= xmax) && (target->y >= ymin) && (target->y <= ymax)) {
+					go_on = cursor->step(*target);
+					found++;
+				}
+			}
+		}
+	} else {
+		// different cells may share the same bucket, stamps prevent visiting it twice
+		this->stamp++;
+
+		for (long long cx = cx0; go_on && (cx <= cx1); cx++) {
+			for (long long cy = cy0; go_on && (cy <= cy1); cy++) {
+				size_t bucket = this->cell_bucket(cx, cy);
+
+				if (this->stamps[bucket] != this->stamp) {
+					this->stamps[bucket] = this->stamp;
+
+					for (int tidx = this->buckets[bucket]; go_on && (tidx >= 0); tidx = this->nexts[tidx]) {
+						AISTarget* target = &this->targets[tidx];
+
+						if ((target->x >= xmin) && (target->x <= xmax) && (target->y >= ymin) && (target->y <= ymax)) {
+							go_on = cursor->step(*target);
+							found++;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	return found;
+}
+
+size_t AISTargetTable::nearest_cpa_candidates(AISEncounter encounters[], size_t n
+	, double x, double y, double speed_kn, double course_deg, double range, double tcpa_max_s) {
+	long long cx0 = (long long)(std::floor((x - range) / this->gridsize));
+	long long cx1 = (long long)(std::floor((x + range) / this->gridsize));
+	long long cy0 = (long long)(std::floor((y - range) / this->gridsize));
+	long long cy1 = (long long)(std::floor((y + range) / this->gridsize));
+	double range2 = range * range;
+	size_t found = 0U;
+	double ovx, ovy;
+
+	fill_velocity(speed_kn, course_deg, &ovx, &ovy);
+	this->stamp++;
+
+	for (long long cx = cx0; cx <= cx1; cx++) {
+		for (long long cy = cy0; cy <= cy1; cy++) {
+			size_t bucket = this->cell_bucket(cx, cy);
+
+			if (this->stamps[bucket] == this->stamp) {
+				continue;
+			}
+
+			this->stamps[bucket] = this->stamp;
+
+			for (int tidx = this->buckets[bucket]; tidx >= 0; tidx = this->nexts[tidx]) {
+				AISTarget* target = &this->targets[tidx];
+				double rx = target->x - x;
+				double ry = target->y - y;
+
+				if ((rx * rx + ry * ry) <= range2) {
+					double tvx, tvy, vx, vy, v2, tcpa, dx, dy;
+					size_t slot = found;
+
+					fill_velocity(target->speed, target->course, &tvx, &tvy);
+					vx = tvx - ovx;
+					vy = tvy - ovy;
+					v2 = vx * vx + vy * vy;
+					tcpa = ((v2 > 0.0) ? -(rx * vx + ry * vy) / v2 : 0.0);
+
+					if (tcpa < 0.0) { // diverging
+						tcpa = 0.0;
+					} else if (tcpa > tcpa_max_s) {
+						tcpa = tcpa_max_s;
+					}
+
+					dx = rx + vx * tcpa;
+					dy = ry + vy * tcpa;
+
+					{ // keep the n closest ones ordered by CPA
+						double cpa = std::sqrt(dx * dx + dy * dy);
+
+						while ((slot > 0) && (encounters[slot - 1].cpa > cpa)) {
+							if (slot < n) {
+								encounters[slot] = encounters[slot - 1];
+							}
+
+							slot--;
+						}
+
+						if (slot < n) {
+							encounters[slot].target = target;
+							encounters[slot].cpa = cpa;
+							encounters[slot].tcpa = tcpa;
+
+							if (found < n) {
+								found++;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	return found;
+}
+
+/*************************************************************************************************/
+int AISTargetTable::intern(uint16 mmsi) {
+	bool found = false;
+	size_t islot = this->index_slot(mmsi, &found);
+	int tidx = -1;
+
+	if (found) {
+		tidx = this->index[islot];
+	} else {
+		tidx = this->allocate();
+
+		if (tidx >= 0) {
+			AISTarget* target = &this->targets[tidx];
+
+			/** NOTE
+			 * `allocate()` may evict the oldest target,
+			 *   and the backward shifting would move the slot this new target supposed to take.
+			 */
+			islot = this->index_slot(mmsi, &found);
+			this->index[islot] = tidx;
+			this->cells[tidx] = this->buckets.size() + 1U;
+			this->size++;
+
+			target->mmsi = mmsi;
+			target->type = AISType::A; // voyages are only reported by class A transponders
+			target->x = flnan;
+			target->y = flnan;
+			target->speed = flnan;
+			target->course = flnan;
+			target->heading = flnan;
+			target->timepoint = 0LL;
+			target->located = false;
+			target->shown = false;
+			target->voyaged = false;
+			target->warned = false;
+		}
+	}
+
+	return tidx;
+}
+
+bool AISTargetTable::occupied(size_t tidx) {
+	return (this->cells[tidx] != this->buckets.size());
+}
+
+size_t AISTargetTable::index_slot(uint16 mmsi, bool* found) {
+	size_t mask = this->index.size() - 1U;
+	size_t islot = mmsi_hash(mmsi) & mask;
+
+	(*found) = false;
+
+	while (this->index[islot] >= 0) {
+		if (this->targets[this->index[islot]].mmsi == mmsi) {
+			(*found) = true;
+			break;
+		}
+
+		islot = (islot + 1U) & mask;
+	}
+
+	return islot;
+}
+
+void AISTargetTable::index_remove(size_t islot) {
+	size_t mask = this->index.size() - 1U;
+	size_t hole = islot;
+	size_t next = islot;
+
+	// backward shifting, no tombstones are left behind
+	while (true) {
+		next = (next + 1U) & mask;
+
+		if (this->index[next] < 0) {
+			break;
+		} else {
+			size_t home = mmsi_hash(this->targets[this->index[next]].mmsi) & mask;
+			bool stays = ((hole <= next) ? ((hole < home) && (home <= next)) : ((hole < home) || (home <= next)));
+
+			if (!stays) {
+				this->index[hole] = this->index[next];
+				hole = next;
+			}
+		}
+	}
+
+	this->index[hole] = -1;
+}
+
+size_t AISTargetTable::cell_bucket(long long cx, long long cy) {
+	uint64 h = (uint64(cx) * 73856093ULL) ^ (uint64(cy) * 19349663ULL);
+
+	return size_t(h ^ (h >> 17U)) & (this->buckets.size() - 1U);
+}
+
+size_t AISTargetTable::resolve_bucket(double x, double y) {
+	long long cx = (long long)(std::floor(x / this->gridsize));
+	long long cy = (long long)(std::floor(y / this->gridsize));
+
+	return this->cell_bucket(cx, cy);
+}
+
+void AISTargetTable::cell_link(int tidx, size_t bucket) {
+	int head = this->buckets[bucket];
+
+	this->prevs[tidx] = -1;
+	this->nexts[tidx] = head;
+
+	if (head >= 0) {
+		this->prevs[head] = tidx;
+	}
+
+	this->buckets[bucket] = tidx;
+	this->cells[tidx] = bucket;
+}
+
+void AISTargetTable::cell_unlink(int tidx) {
+	size_t bucket = this->cells[tidx];
+
+	if (bucket < this->buckets.size()) {
+		int prev = this->prevs[tidx];
+		int next = this->nexts[tidx];
+
+		if (prev >= 0) {
+			this->nexts[prev] = next;
+		} else {
+			this->buckets[bucket] = next;
+		}
+
+		if (next >= 0) {
+			this->prevs[next] = prev;
+		}
+
+		this->cells[tidx] = this->buckets.size();
+	}
+}
+
+int AISTargetTable::allocate() {
+	int tidx = this->free_head;
+
+	if (tidx < 0) { // full, sacrifice the one that has been silent for the longest time
+		long long oldest = 0LL;
+
+		for (size_t idx = 0; idx < this->targets.size(); idx++) {
+			if ((tidx < 0) || (this->targets[idx].timepoint < oldest)) {
+				oldest = this->targets[idx].timepoint;
+				tidx = int(idx);
+			}
+		}
+
+		this->remove(this->targets[tidx].mmsi);
+		tidx = this->free_head;
+	}
+
+	this->free_head = this->nexts[tidx];
+	this->prevs[tidx] = -1;
+	this->nexts[tidx] = -1;
+
+	return tidx;
+}
+
+void AISTargetTable::release(int tidx) {
+	this->cell_unlink(tidx);
+	this->cells[tidx] = this->buckets.size();
+	this->nexts[tidx] = this->free_head;
+	this->free_head = tidx;
+	this->size--;
+}
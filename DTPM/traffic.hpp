@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vector>
+
+#include "graphlet/filesystem/configuration/aislet.hpp"
+
+namespace WarGrey::DTPM {
+	private struct AISTarget {
+		uint16 mmsi;
+		WarGrey::DTPM::AISType type;
+		double x;
+		double y;
+		double speed;   // knots
+		double course;  // degrees
+		double heading; // degrees
+		long long timepoint;
+		bool located;   // `false` if only the voyage has been reported
+		bool shown;     // whether the map is kept updated with it
+		bool voyaged;
+		bool warned;    // whether its close encounter has been reported
+		WarGrey::DTPM::AISPositionReport position; // replayed once the ship comes into view
+		WarGrey::DTPM::AISVoyageReport voyage;
+	};
+
+	private struct AISEncounter {
+		WarGrey::DTPM::AISTarget* target;
+		double cpa;  // meters
+		double tcpa; // seconds
+	};
+
+	private class IAISTargetCursor abstract {
+	public:
+		virtual bool step(WarGrey::DTPM::AISTarget& target) = 0;
+	};
+
+	/** NOTE
+	 * Targets are stored in a fixed pool, indexed by an open-addressing table keyed by MMSI,
+	 *   and chained into a uniform grid on their geo locations,
+	 *   so that the memory is bounded by the `capacity` no matter how long the vessel stays in port.
+	 *
+	 * Geo coordinates follow the surveying convention, `x` is the northing and `y` is the easting.
+	 *
+	 * Voyages reported before positions are kept by targets that are not located in any cell.
+	 */
+	private class AISTargetTable {
+	public:
+		AISTargetTable(size_t capacity, double gridsize);
+
+	public:
+		WarGrey::DTPM::AISTarget* update_position(long long timepoint_ms, uint16 mmsi, WarGrey::DTPM::AISPositionReport* position);
+		WarGrey::DTPM::AISTarget* update_voyage(long long timepoint_ms, uint16 mmsi, WarGrey::DTPM::AISVoyageReport* voyage);
+		WarGrey::DTPM::AISTarget* ref(uint16 mmsi);
+		bool remove(uint16 mmsi);
+		size_t evict_stale(long long now_ms, long long classA_ttl_ms, long long classB_ttl_ms);
+
+	public:
+		size_t count();
+		size_t capacity();
+
+	public:
+		size_t foreach_in_viewport(WarGrey::DTPM::IAISTargetCursor* cursor, double x0, double y0, double x1, double y1);
+		size_t nearest_cpa_candidates(WarGrey::DTPM::AISEncounter encounters[], size_t n,
+			double x, double y, double speed_kn, double course_deg, double range, double tcpa_max_s);
+
+		template<size_t N>
+		size_t nearest_cpa_candidates(WarGrey::DTPM::AISEncounter (&encounters)[N],
+			double x, double y, double speed_kn, double course_deg, double range, double tcpa_max_s) {
+			return this->nearest_cpa_candidates(encounters, N, x, y, speed_kn, course_deg, range, tcpa_max_s);
+		}
+
+	private:
+		int intern(uint16 mmsi);
+		bool occupied(size_t target_idx);
+		size_t index_slot(uint16 mmsi, bool* found);
+		size_t cell_bucket(long long cx, long long cy);
+		size_t resolve_bucket(double x, double y);
+		void index_remove(size_t islot);
+		void cell_link(int target_idx, size_t bucket);
+		void cell_unlink(int target_idx);
+		void release(int target_idx);
+		int allocate();
+
+	private:
+		std::vector<WarGrey::DTPM::AISTarget> targets;
+		std::vector<int> index;    // target pool indices, `-1` for empty slots
+		std::vector<int> buckets;  // heads of cell chains
+		std::vector<size_t> cells; // bucket of each target, `buckets.size()` means the target is free, `+ 1` means it is not located
+		std::vector<int> prevs;
+		std::vector<int> nexts;    // also used as the free list
+		std::vector<unsigned int> stamps;
+
+	private:
+		double gridsize;
+		size_t size;
+		int free_head;
+		unsigned int stamp;
+	};
+}
@@ -1,6 +1,8 @@
 ﻿#include <map>
 
 #include "configuration.hpp"
+#include "intern.hpp"
+#include "capture.hpp"
 
 #include "widget.hxx"
 #include "planet.hpp"
@@ -50,8 +52,8 @@ static ICanvasBrush^ about_fgcolor = Colours::Black;
 
 static const float widget_line_gap = tiny_font_size;
 
-static CanvasTextFormat^ widget_label_font = make_text_format("Microsoft YaHei", large_font_size);
-static CanvasTextFormat^ widget_icon_font = make_text_format("Consolas", 32.0F);
+static CanvasTextFormat^ widget_label_font = intern_text_format("Microsoft YaHei", large_font_size);
+static CanvasTextFormat^ widget_icon_font = intern_text_format("Consolas", 32.0F);
 
 /*************************************************************************************************/
 float WarGrey::DTPM::widget_evaluate_height() {
@@ -81,7 +83,7 @@ public:
 		float button_height, label_width;
 		ButtonStyle button_style;
 
-		button_style.font = make_bold_text_format(tiny_font_size);
+		button_style.font = intern_bold_text_format(tiny_font_size);
 		button_style.corner_radius = 2.0F;
 		button_style.thickness = 1.0F;
 
@@ -189,7 +191,7 @@ public:
 				this->about->show();
 			}; break;
 			case Icon::PrintScreen: {
-				this->master->save(this->master->current_planet->name() + "-"
+				capture_enqueue(this->master->take_snapshot(), this->master->current_planet->name() + "-"
 					+ file_basename_from_second(current_seconds()) + ".png");
 			}; break;
 			case Icon::FullScreen: {
@@ -295,7 +297,7 @@ private: // never delete these graphlets manually.
 };
 
 /*************************************************************************************************/
-UniverseWidget::UniverseWidget(SplitView^ frame, UniverseDisplay^ master, MRMaster* plc)
+UniverseWidget::UniverseWidget(SplitView^ frame, UniverseDisplay^ master, PLCMaster* plc)
 	: UniverseDisplay(master->get_logger()), frame(frame), master(master), plc(plc) {
 	this->use_global_mask_setting(false);
 	this->disable_predefined_shortcuts(true);
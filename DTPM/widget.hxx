@@ -1,7 +1,7 @@
 #pragma once
 
 #include "universe.hxx"
-#include "mrit.hpp"
+#include "plc.hpp"
 
 namespace WarGrey::DTPM {
 	float widget_evaluate_height();
@@ -9,7 +9,7 @@ namespace WarGrey::DTPM {
 	private ref class UniverseWidget : public WarGrey::SCADA::UniverseDisplay {
 	internal:
 		UniverseWidget(Windows::UI::Xaml::Controls::SplitView^ frame, WarGrey::SCADA::UniverseDisplay^ master,
-			WarGrey::SCADA::MRMaster* plc);
+			WarGrey::SCADA::PLCMaster* plc);
 
 	protected:
 		void construct(Microsoft::Graphics::Canvas::UI::CanvasCreateResourcesReason reason) override;
@@ -19,6 +19,6 @@ namespace WarGrey::DTPM {
 		WarGrey::SCADA::UniverseDisplay^ master;
 
 	private:
-		WarGrey::SCADA::MRMaster* plc;
+		WarGrey::SCADA::PLCMaster* plc;
 	};
 }
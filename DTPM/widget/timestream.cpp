@@ -51,11 +51,11 @@ namespace {
 /*************************************************************************************************/
 static TimeStream* the_timemachine = nullptr;
 
-void WarGrey::DTPM::initialize_the_timemachine(MRMaster* plc, long long speed, int frame_rate) {
+void WarGrey::DTPM::initialize_the_timemachine(PLCMaster* plc, long long speed, int frame_rate) {
 	if (the_timemachine == nullptr) {
 		the_timemachine = new TimeStream(speed, frame_rate);
 
-		plc->push_confirmation_receiver(the_timemachine);
+		plc->push_frame_receiver(the_timemachine);
 	}
 }
 
@@ -1,9 +1,9 @@
 #pragma once
 
 #include "timemachine.hpp"
-#include "mrit.hpp"
+#include "plc.hpp"
 
 namespace WarGrey::DTPM {
-	void initialize_the_timemachine(WarGrey::SCADA::MRMaster* plc, long long time_speed, int frame_rate);
+	void initialize_the_timemachine(WarGrey::SCADA::PLCMaster* plc, long long time_speed, int frame_rate);
 	void launch_the_timemachine();
 }
@@ -2,12 +2,17 @@
 #include "widget.hxx"
 
 #include "configuration.hpp"
+#include "capture.hpp"
+#include "persistence.hpp"
 #include "iotables/macro_keys.hpp"
 
 #include "slang/dgps.hpp"
 #include "plc.hpp"
 
+#include "schema/datalet/trend_ts.hpp"
+
 #include "decorator/headsup.hpp"
+#include "decorator/probe.hpp"
 #include "navigator/thumbnail.hpp"
 #include "planet.hpp"
 #include "timer.hxx"
@@ -43,6 +48,8 @@ using namespace Microsoft::Graphics::Canvas;
 using namespace Microsoft::Graphics::Canvas::UI;
 
 /*************************************************************************************************/
+static const int dredger_planet_count = 11;
+
 private class MacroEventListener : public PLCConfirmation {
 public:
 	MacroEventListener(unsigned int brightness_idx, int page_idx)
@@ -83,15 +90,20 @@ public:
 			delete this->device;
 		}
 
+		delete this->historian; // after the device, no more signals arrive
+
 		dgps_slang_teardown();
 	}
 
 internal:
 	DredgerUniverse(Platform::String^ name, PLCMaster* device, IUniverseNavigator* navigator, IHeadUpPlanet* heads_up
 		, unsigned int brightness_idx, int paging_idx = -1)
-		: UniverseDisplay(make_system_logger(default_logging_level, name), name, navigator, heads_up), device(device) {
+		: UniverseDisplay(make_system_logger(default_logging_level, name), name, navigator, heads_up), device(device), constructed(0) {
 		this->macro_event = new MacroEventListener(brightness_idx, paging_idx);
-		this->device->push_confirmation_receiver(this->macro_event);
+		this->device->push_frame_receiver(this->macro_event);
+
+		this->historian = new SignalHistorian(make_system_logger(default_schema_logging_level, "SignalHistory"));
+		this->device->push_frame_receiver(this->historian);
 
 		system_set_subnet_prefix(system_subnet_prefix);
 		ui_thread_initialize();
@@ -102,24 +114,22 @@ public:
 		int page = this->macro_event->get_target_page();
 
 		if (page >= 0) {
-			this->transfer_to(this->macro_event->get_target_page());
+			this->construct_planets(page + 1);
+			this->transfer_to(page);
+		} else {
+			// other pages are constructed in idle frames, one per frame
+			this->construct_planets(this->constructed + 1);
+		}
+
+		if ((count % (frame_per_second * frame_probe_report_interval)) == 0) {
+			frame_probe_report(this->get_logger());
 		}
 	}
 
 protected:
 	void construct(CanvasCreateResourcesReason reason) override {
-		this->push_planet(new HydraulicsPage(this->device)); // 0
-		this->push_planet(new ChargesPage(this->device)); // 1
-		this->push_planet(new DredgesPage(DragView::_, this->device)); // 2
-		this->push_planet(new DischargesPage(this->device)); // 3
-		this->push_planet(new GlandsPage(this->device)); // 4
-		this->push_planet(new FlushsPage(this->device)); // 5
-		this->push_planet(new DredgesPage(DragView::PortSide, this->device)); // 6
-		this->push_planet(new HopperDoorsPage(this->device)); // 7
-		this->push_planet(new LubricatingsPage(this->device)); // 8
-		this->push_planet(new DraughtsPage(this->device)); // 9
-		this->push_planet(new DredgesPage(DragView::Starboard, this->device)); // 10
-		//this->push_planet(new DredgesPage(DragView::Suctions, this->device)); // 11
+		// only the home page is constructed before the first frame
+		this->construct_planets(1);
 	}
 
 	bool on_key(VirtualKey key, bool screen_keyboard) override {
@@ -127,6 +137,8 @@ protected:
 		bool handled = false;
 
 		if (page == -1) { // does not controlled by dashboard macro keys
+			this->construct_planets(dredger_planet_count);
+
 			switch (key) {
 			case VirtualKey::Down: case VirtualKey::PageDown: this->transfer_next(); handled = true; break;
 			case VirtualKey::Up: case VirtualKey::PageUp: this->transfer_previous(); handled = true; break;
@@ -136,9 +148,38 @@ protected:
 		return handled;
 	}
 
+private:
+	void construct_planets(int count) {
+		while ((this->constructed < count) && (this->constructed < dredger_planet_count)) {
+			IPlanet* planet = nullptr;
+
+			switch (this->constructed) {
+			case 0: planet = instrument_planet<HydraulicsPage>(this->device); break;
+			case 1: planet = instrument_planet<ChargesPage>(this->device); break;
+			case 2: planet = instrument_planet<DredgesPage>(DragView::_, this->device); break;
+			case 3: planet = instrument_planet<DischargesPage>(this->device); break;
+			case 4: planet = instrument_planet<GlandsPage>(this->device); break;
+			case 5: planet = instrument_planet<FlushsPage>(this->device); break;
+			case 6: planet = instrument_planet<DredgesPage>(DragView::PortSide, this->device); break;
+			case 7: planet = instrument_planet<HopperDoorsPage>(this->device); break;
+			case 8: planet = instrument_planet<LubricatingsPage>(this->device); break;
+			case 9: planet = instrument_planet<DraughtsPage>(this->device); break;
+			case 10: planet = instrument_planet<DredgesPage>(DragView::Starboard, this->device); break;
+			//case 11: planet = instrument_planet<DredgesPage>(DragView::Suctions, this->device); break;
+			}
+
+			this->push_planet(planet);
+			this->constructed++;
+		}
+	}
+
 internal:
 	PLCMaster* device;
 	MacroEventListener* macro_event;
+	SignalHistorian* historian;
+
+private:
+	int constructed;
 };
 
 /*************************************************************************************************/
@@ -160,7 +201,13 @@ public:
 	void construct(Platform::String^ name, Size region) {
 		Platform::String^ localhost = system_ipv4_address();
 		Syslog* plc_logger = make_system_logger(default_plc_master_logging_level, name + ": PLC");
-		PLCMaster* device = new PLCMaster(plc_logger, plc_hostname, scada_plc_master_port, plc_master_suicide_timeout);
+		PLCMaster* device = new PLCMaster(plc_logger, plc_hostname, scada_plc_master_port, plc_master_suicide_timeout,
+			plc_standby_hostname, plc_standby_promotion_timeout);
+
+		if (plc_relay_over_slang) {
+			device->relay_over_slang(SlangPort::SCADA, plc_relay_silence_timeout, plc_relay_keyframe_interval);
+		}
+
 		IUniverseNavigator* navigator = new ThumbnailNavigator(default_logging_level, name, region.Width / region.Height, 160.0F);
 		HeadsUpPlanet* heads_up = new HeadsUpPlanet(device);
 
@@ -203,7 +250,13 @@ public:
 	void on_entered_background(EnteredBackgroundEventArgs^ args) {}
 	void on_background_activated(IBackgroundTaskInstance^ task) {}
 	void on_leaving_background(LeavingBackgroundEventArgs^ args) {}
-	void on_suspending(SuspendingEventArgs^ args) {}
+	void on_suspending(SuspendingEventArgs^ args) {
+		// pending screenshots are flushed, the pipeline will be restarted on demand
+		capture_pipeline_shutdown();
+
+		// pending records of all datasources are written, destructors are not guaranteed to run after suspending
+		persistence_flush_all();
+	}
 	void on_resuming() {}
 	
 private:
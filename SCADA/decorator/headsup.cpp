@@ -1,9 +1,14 @@
 ﻿#include "decorator/headsup.hpp"
 #include "configuration.hpp"
+#include "intern.hpp"
+#include "capture.hpp"
 
 #include "widget/alarms.hpp"
 
+#include "datum/string.hpp"
+
 #include "module.hpp"
+#include "text.hpp"
 
 #include "brushes.hxx"
 
@@ -12,6 +17,7 @@ using namespace WarGrey::SCADA;
 using namespace Microsoft::Graphics::Canvas;
 using namespace Microsoft::Graphics::Canvas::UI;
 using namespace Microsoft::Graphics::Canvas::Brushes;
+using namespace Microsoft::Graphics::Canvas::Text;
 
 static ICanvasBrush^ brush = Colours::Silver;
 
@@ -32,7 +38,7 @@ protected:
 };
 
 /*************************************************************************************************/
-HeadsUpPlanet::HeadsUpPlanet(PLCMaster* plc) : IHeadUpPlanet(__MODULE__), device(plc), statusbar(nullptr) {
+HeadsUpPlanet::HeadsUpPlanet(PLCMaster* plc) : IHeadUpPlanet(__MODULE__), device(plc), statusbar(nullptr), probe_overlay(nullptr), probe(nullptr) {
 	this->push_decorator(new HeadsUpDecorator());
 }
 
@@ -40,9 +46,16 @@ void HeadsUpPlanet::load(CanvasCreateResourcesReason reason, float width, float
 	if (this->statusbar == nullptr) {
 		this->statusbar = this->insert_one(new Statusbarlet(this->device));
 		this->statusline = this->insert_one(new Statuslinelet(default_logging_level));
+
+		if (frame_probe_overlay) {
+			CanvasTextFormat^ probe_font = intern_bold_text_format("Consolas", tiny_font_size);
+
+			this->probe_overlay = this->insert_one(new Labellet("", probe_font, Colours::GhostWhite));
+		}
 		
 		{ // delayed initializing
 			this->get_logger()->push_log_receiver(this->statusline);
+			capture_logger()->push_log_receiver(this->statusline);
 
 			if (this->device != nullptr) {
 				this->device->get_logger()->push_log_receiver(this->statusline);
@@ -53,6 +66,19 @@ void HeadsUpPlanet::load(CanvasCreateResourcesReason reason, float width, float
 
 void HeadsUpPlanet::reflow(float width, float height) {
 	this->move_to(this->statusline, 0.0F, height, GraphletAnchor::LB);
+
+	if (this->probe_overlay != nullptr) {
+		this->move_to(this->probe_overlay, width, statusbar_height() * 2.0F, GraphletAnchor::RT);
+	}
+}
+
+void HeadsUpPlanet::update(long long count, long long interval, long long uptime) {
+	if ((this->probe_overlay != nullptr) && (this->probe != nullptr) && ((count % frame_per_second) == 0)) {
+		this->probe_overlay->set_text(make_wstring(L"%s: %llu updates, %llu draws(p50: %.2fms, p99: %.2fms)",
+			this->probe->name->Data(), this->probe->counter(FrameCounter::Update), this->probe->counter(FrameCounter::Draw),
+			this->probe->draw_percentile(0.50), this->probe->draw_percentile(0.99)),
+			GraphletAnchor::RT);
+	}
 }
 
 void HeadsUpPlanet::fill_margin(float* top, float* right, float* bottom, float* left) {
@@ -64,6 +90,7 @@ void HeadsUpPlanet::fill_margin(float* top, float* right, float* bottom, float*
 
 void HeadsUpPlanet::on_transfer(IPlanet* from, IPlanet* to) {
 	this->statusbar->set_caption(to->display_name());
+	this->probe = frame_probe(to->name());
 }
 
 void HeadsUpPlanet::on_tap_selected(IGraphlet* g, float local_x, float local_y) {
@@ -4,6 +4,9 @@
 #include "plc.hpp"
 
 #include "graphlet/ui/statuslet.hpp"
+#include "graphlet/ui/textlet.hpp"
+
+#include "instrument.hpp"
 
 namespace WarGrey::SCADA {
 	private class HeadsUpPlanet : public WarGrey::SCADA::IHeadUpPlanet {
@@ -14,6 +17,7 @@ namespace WarGrey::SCADA {
 		void load(Microsoft::Graphics::Canvas::UI::CanvasCreateResourcesReason reason, float width, float height) override;
 		void fill_margin(float* top = nullptr, float* right = nullptr, float* bottom = nullptr, float* left = nullptr) override;
 		void reflow(float width, float height) override;
+		void update(long long count, long long interval, long long uptime) override;
 
 	public:
 		void on_transfer(WarGrey::SCADA::IPlanet* from, WarGrey::SCADA::IPlanet* to) override;
@@ -29,5 +33,9 @@ namespace WarGrey::SCADA {
 	private: // never deletes these graphlets mannually
 		WarGrey::SCADA::Statusbarlet* statusbar;
 		WarGrey::SCADA::Statuslinelet* statusline;
+		WarGrey::SCADA::Labellet* probe_overlay;
+
+	private:
+		WarGrey::SCADA::FrameProbe* probe;
 	};
 }
@@ -0,0 +1,60 @@
+#include "decorator/hull.hpp"
+
+#include "geometry.hpp"
+
+using namespace WarGrey::SCADA;
+
+using namespace Windows::Foundation;
+
+using namespace Microsoft::Graphics::Canvas;
+using namespace Microsoft::Graphics::Canvas::Brushes;
+using namespace Microsoft::Graphics::Canvas::Geometry;
+
+/*************************************************************************************************/
+ScaledHull::ScaledHull(CanvasGeometry^ shape) : shape(shape), width(0.0F), height(0.0F) {}
+
+CanvasGeometry^ ScaledHull::realize(float width, float height) {
+	if ((this->realized == nullptr) || (this->width != width) || (this->height != height)) {
+		this->realized = geometry_scale(this->shape, width, height);
+		this->box = this->realized->ComputeBounds();
+		this->outline = nullptr;
+		this->width = width;
+		this->height = height;
+	}
+
+	return this->realized;
+}
+
+Rect ScaledHull::bounds(float width, float height) {
+	this->realize(width, height);
+
+	return this->box;
+}
+
+void ScaledHull::draw(CanvasDrawingSession^ ds, float x, float y, float width, float height
+	, ICanvasBrush^ color, float thickness, CanvasStrokeStyle^ style) {
+	CanvasGeometry^ hull = this->realize(width, height);
+
+	if (this->outline == nullptr) {
+		this->outline = ref new CanvasCommandList(ds);
+
+		{ // pre-render the outline, the session must be closed before the command list can be drawn
+			CanvasDrawingSession^ cds = this->outline->CreateDrawingSession();
+
+			if (style == nullptr) {
+				cds->DrawGeometry(hull, 0.0F, 0.0F, color, thickness);
+			} else {
+				cds->DrawGeometry(hull, 0.0F, 0.0F, color, thickness, style);
+			}
+
+			delete cds;
+		}
+	}
+
+	ds->DrawImage(this->outline, x, y);
+}
+
+void ScaledHull::invalidate() {
+	this->realized = nullptr;
+	this->outline = nullptr;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * Hull shapes are defined in the unit box and scaled to the decorator every time it is asked,
+	 *   both the scaling and the tessellation behind `ComputeBounds()` and `DrawGeometry()` are not cheap,
+	 *   whereas the size of the decorator only changes on resize.
+	 *
+	 * The realized geometry, its bounds and the pre-rendered outline are cached and keyed by the size,
+	 *   so that drawing a frame is just blitting the command list.
+	 *
+	 * The outline is not keyed by the brush or the stroke style, decorators always draw the hull in the same way.
+	 */
+	private class ScaledHull {
+	public:
+		ScaledHull(Microsoft::Graphics::Canvas::Geometry::CanvasGeometry^ shape);
+
+	public:
+		Microsoft::Graphics::Canvas::Geometry::CanvasGeometry^ realize(float width, float height);
+		Windows::Foundation::Rect bounds(float width, float height);
+
+	public:
+		void draw(Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds, float x, float y, float width, float height,
+			Microsoft::Graphics::Canvas::Brushes::ICanvasBrush^ color, float thickness,
+			Microsoft::Graphics::Canvas::Geometry::CanvasStrokeStyle^ style = nullptr);
+
+	public:
+		void invalidate();
+
+	private:
+		Microsoft::Graphics::Canvas::Geometry::CanvasGeometry^ shape;
+		Microsoft::Graphics::Canvas::Geometry::CanvasGeometry^ realized;
+		Microsoft::Graphics::Canvas::CanvasCommandList^ outline;
+		Windows::Foundation::Rect box;
+		float width;
+		float height;
+	};
+}
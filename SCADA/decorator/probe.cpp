@@ -0,0 +1,50 @@
+#include "decorator/probe.hpp"
+
+#include "datum/time.hpp"
+#include "datum/string.hpp"
+
+using namespace WarGrey::SCADA;
+
+using namespace Microsoft::Graphics::Canvas;
+
+/*************************************************************************************************/
+FrameProbeDecorator::FrameProbeDecorator(Platform::String^ planet_name) : planet_start(0.0), graphlet_start(0.0) {
+	this->planet = frame_probe(planet_name);
+}
+
+void FrameProbeDecorator::draw_before(CanvasDrawingSession^ ds, float X, float Y, float Width, float Height) {
+	this->planet_start = current_inexact_milliseconds();
+}
+
+void FrameProbeDecorator::draw_after(CanvasDrawingSession^ ds, float X, float Y, float Width, float Height) {
+	this->planet->count(FrameCounter::Draw);
+	this->planet->sample_draw(current_inexact_milliseconds() - this->planet_start);
+}
+
+void FrameProbeDecorator::draw_before_graphlet(IGraphlet* g, CanvasDrawingSession^ ds
+	, float x, float y, float width, float height, bool is_selected) {
+	this->graphlet_start = current_inexact_milliseconds();
+}
+
+void FrameProbeDecorator::draw_after_graphlet(IGraphlet* g, CanvasDrawingSession^ ds
+	, float x, float y, float width, float height, bool is_selected) {
+	FrameProbe* probe = this->graphlet_probe(g);
+
+	probe->count(FrameCounter::Draw);
+	probe->sample_draw(current_inexact_milliseconds() - this->graphlet_start);
+}
+
+FrameProbe* FrameProbeDecorator::graphlet_probe(IGraphlet* g) {
+	const std::type_info* type = &typeid(*g);
+	auto maybe_probe = this->graphlets.find(type);
+	FrameProbe* probe = nullptr;
+
+	if (maybe_probe == this->graphlets.end()) {
+		probe = frame_probe(make_wstring(L"%S", type->name()));
+		this->graphlets.insert(std::pair<const std::type_info*, FrameProbe*>(type, probe));
+	} else {
+		probe = maybe_probe->second;
+	}
+
+	return probe;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <map>
+#include <typeinfo>
+
+#include "decorator/decorator.hpp"
+
+#include "instrument.hpp"
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * The probe decorator should be the last one pushed into the planet,
+	 *   so that the draw time of the planet covers the other decorators.
+	 *
+	 * Graphlets are also measured per class, instances of the same class share the probe across planets.
+	 */
+	private class FrameProbeDecorator : public WarGrey::SCADA::IPlanetDecorator {
+	public:
+		FrameProbeDecorator(Platform::String^ planet_name);
+
+	public:
+		void draw_before(Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds, float X, float Y, float Width, float Height) override;
+		void draw_after(Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds, float X, float Y, float Width, float Height) override;
+
+		void draw_before_graphlet(WarGrey::SCADA::IGraphlet* g, Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds
+			, float x, float y, float width, float height, bool is_selected) override;
+
+		void draw_after_graphlet(WarGrey::SCADA::IGraphlet* g, Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds
+			, float x, float y, float width, float height, bool is_selected) override;
+
+	private:
+		WarGrey::SCADA::FrameProbe* graphlet_probe(WarGrey::SCADA::IGraphlet* g);
+
+	private:
+		WarGrey::SCADA::FrameProbe* planet;
+		std::map<const std::type_info*, WarGrey::SCADA::FrameProbe*> graphlets;
+		double planet_start;
+		double graphlet_start;
+	};
+
+	/** NOTE
+	 * Updates are counted here and draws by the decorator, each instance has its own probe,
+	 *   which is named after the planet, and tagged if given, so that copies of the same page
+	 *   (e.g. the ones in the timemachine) are not mixed up with the live one.
+	 *
+	 * The probe decorator is pushed after the decorators pushed by the constructor of `P`.
+	 */
+	template<class P>
+	private class InstrumentedPlanet : public P {
+	public:
+		template<typename... Args>
+		InstrumentedPlanet(Platform::String^ tag, Args... args) : P(args...) {
+			Platform::String^ key = ((tag == nullptr) ? this->name() : (this->name() + "@" + tag));
+
+			this->probe = WarGrey::SCADA::frame_probe(key);
+			this->push_decorator(new WarGrey::SCADA::FrameProbeDecorator(key));
+		}
+
+	public:
+		void update(long long count, long long interval, long long uptime) override {
+			this->probe->count(WarGrey::SCADA::FrameCounter::Update);
+			P::update(count, interval, uptime);
+		}
+
+	private:
+		WarGrey::SCADA::FrameProbe* probe;
+	};
+
+	template<class P, typename... Args>
+	P* instrument_planet(Args... args) {
+		return new WarGrey::SCADA::InstrumentedPlanet<P>(nullptr, args...);
+	}
+}
@@ -1,4 +1,5 @@
 ﻿#include "decorator/ship.hpp"
+#include "intern.hpp"
 
 #include "datum/box.hpp"
 
@@ -29,24 +30,26 @@ ShipDecorator::ShipDecorator() {
 	this->ship_height = height;
 	this->x = (1.0F - this->ship_width - radius) * 0.70F;
 	this->y = 0.5F;
-	this->ship = geometry_union(rectangle(this->ship_width, height),
-		segment(this->ship_width, radius, -90.0, 90.0, radius, radius));
+	this->ship = new ScaledHull(geometry_union(rectangle(this->ship_width, height),
+		segment(this->ship_width, radius, -90.0, 90.0, radius, radius)));
+}
+
+ShipDecorator::~ShipDecorator() {
+	delete this->ship;
 }
 
 void ShipDecorator::draw_before(CanvasDrawingSession^ ds, float X, float Y, float Width, float Height) {
-	auto real_ship = geometry_scale(this->ship, Width, Height);
-	Rect ship_box = real_ship->ComputeBounds();
 	float thickness = 2.0F;
 	float sx = this->x * Width + X;
 	float sy = this->y * Height + Y;
 
-	ds->DrawGeometry(real_ship, sx, sy, Colours::Silver, thickness);
+	this->ship->draw(ds, sx, sy, Width, Height, Colours::Silver, thickness);
 }
 
 void ShipDecorator::fill_ship_extent(float* x, float* y, float* width, float* height, bool full) {
 	float awidth = this->actual_width();
 	float aheight = this->actual_height();
-	auto abox = this->ship->ComputeBounds(make_scale_matrix(awidth, aheight));
+	Rect abox = this->ship->bounds(awidth, aheight);
 
 	SET_VALUES(x, this->x * awidth, y, this->y * aheight);
 	SET_BOX(width, (full ? abox.Width : this->ship_width * awidth));
@@ -56,18 +59,16 @@ void ShipDecorator::fill_ship_extent(float* x, float* y, float* width, float* he
 void ShipDecorator::fill_ship_anchor(float fx, float fy, float* x, float *y, bool full) {
 	float awidth = this->actual_width();
 	float aheight = this->actual_height();
-	auto abox = this->ship->ComputeBounds(make_scale_matrix(awidth, aheight));
+	Rect abox = this->ship->bounds(awidth, aheight);
 	float width = (full ? abox.Width : this->ship_width * awidth);
 
 	SET_BOX(x, this->x * awidth + width * fx);
 	SET_BOX(y, this->y * aheight + abox.Height * fy);
 }
 
-
 void ShipDecorator::fill_ascent_anchor(float fx, float fy, float* x, float *y) {
 	float awidth = this->actual_width();
 	float aheight = this->actual_height();
-	auto abox = this->ship->ComputeBounds(make_scale_matrix(awidth, aheight));
 
 	SET_BOX(x, this->x * awidth + this->ship_width * awidth * fx);
 	SET_BOX(y, this->y * aheight * fy);
@@ -76,7 +77,7 @@ void ShipDecorator::fill_ascent_anchor(float fx, float fy, float* x, float *y) {
 void ShipDecorator::fill_descent_anchor(float fx, float fy, float* x, float *y) {
 	float awidth = this->actual_width();
 	float aheight = this->actual_height();
-	auto abox = this->ship->ComputeBounds(make_scale_matrix(awidth, aheight));
+	Rect abox = this->ship->bounds(awidth, aheight);
 
 	SET_BOX(x, this->x * awidth + this->ship_width * awidth * fx);
 	SET_BOX(y, aheight * fy + (this->y * aheight + abox.Height) * (1.0F - fy));
@@ -87,7 +88,7 @@ BottomDoorDecorator::BottomDoorDecorator() {
 	this->y = (0.618F - this->ship_height) * 0.5F;
 	
 	{ // initializing sequence labels
-		CanvasTextFormat^ cpt_font = make_bold_text_format("Microsoft YaHei", large_font_size);
+		CanvasTextFormat^ cpt_font = intern_bold_text_format("Microsoft YaHei", large_font_size);
 
 		this->seq_color = Colours::Tomato;
 
@@ -101,8 +102,7 @@ BottomDoorDecorator::BottomDoorDecorator() {
 }
 
 void BottomDoorDecorator::draw_before(CanvasDrawingSession^ ds, float X, float Y, float Width, float Height) {
-	auto real_ship = geometry_scale(this->ship, Width, Height);
-	Rect ship_box = real_ship->ComputeBounds();
+	Rect ship_box = this->ship->bounds(Width, Height);
 	float thickness = 2.0F;
 	float sx = this->x * Width + X;
 	float sy = this->y * Height + Y;
@@ -110,7 +110,7 @@ void BottomDoorDecorator::draw_before(CanvasDrawingSession^ ds, float X, float Y
 	float ps_y = sy + (ship_box.Height - this->ps_seqs[0]->LayoutBounds.Height) * 0.4F;
 	float sb_y = sy + (ship_box.Height - this->sb_seqs[0]->LayoutBounds.Height) * 0.6F;
 
-	ds->DrawGeometry(real_ship, sx, sy, Colours::Silver, thickness);
+	this->ship->draw(ds, sx, sy, Width, Height, Colours::Silver, thickness);
 
 	for (size_t idx = 0; idx < hopper_count; idx++) {
 		float cell_x = sx + cell_width * float(idx);
@@ -125,7 +125,7 @@ void BottomDoorDecorator::draw_before(CanvasDrawingSession^ ds, float X, float Y
 void BottomDoorDecorator::fill_door_cell_extent(float* x, float* y, float* width, float* height, size_t idx, float side_hint) {
 	float awidth = this->actual_width();
 	float aheight = this->actual_height();
-	auto abox = this->ship->ComputeBounds(make_scale_matrix(awidth, aheight));
+	Rect abox = this->ship->bounds(awidth, aheight);
 	float cell_width = this->ship_width * awidth / float(hopper_count);
 	float cell_height = abox.Height * 0.25F;
 
@@ -3,10 +3,12 @@
 #include "configuration.hpp"
 
 #include "decorator/decorator.hpp"
+#include "decorator/hull.hpp"
 
 namespace WarGrey::SCADA {
 	private class ShipDecorator : public IPlanetDecorator {
 	public:
+		virtual ~ShipDecorator() noexcept;
 		ShipDecorator();
 
 	public:
@@ -21,7 +23,7 @@ namespace WarGrey::SCADA {
 		void fill_descent_anchor(float fx, float fy, float* x, float *y);
 
 	protected:
-		Microsoft::Graphics::Canvas::Geometry::CanvasGeometry^ ship;
+		WarGrey::SCADA::ScaledHull* ship;
 
 	protected:
 		float x;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "decorator/decorator.hpp"
+#include "decorator/hull.hpp"
 
 #include "datum/flonum.hpp"
 
@@ -8,14 +9,18 @@ namespace WarGrey::SCADA {
 	template<class V, typename E>
 	private class TVesselDecorator : public WarGrey::SCADA::IPlanetDecorator {
 	public:
+		virtual ~TVesselDecorator() noexcept {
+			delete this->ship;
+		}
+
 		TVesselDecorator(V* master) : master(master) {
 			float height = 1.0F;
 			float xradius = height * 0.10F;
 			float yradius = height * 0.50F;
 
 			this->ship_width = 1.0F - xradius;
-			this->ship = geometry_union(rectangle(this->ship_width, height),
-				segment(this->ship_width, yradius, -90.0, 90.0, xradius, yradius));
+			this->ship = new WarGrey::SCADA::ScaledHull(geometry_union(rectangle(this->ship_width, height),
+				segment(this->ship_width, yradius, -90.0, 90.0, xradius, yradius)));
 
 			this->ship_style = make_dash_stroke(CanvasDashStyle::Dash);
 		}
@@ -43,12 +48,10 @@ namespace WarGrey::SCADA {
 				{ // draw ship
 					float ship_width = this->actual_width();
 					float ship_height = flabs(sb_y - ps_y);
-					auto real_ship = geometry_scale(this->ship, ship_width, ship_height);
-					Rect ship_box = real_ship->ComputeBounds();
 					float sx = 0.0F;
 					float sy = y + std::fminf(sb_y, ps_y);
 
-					ds->DrawGeometry(real_ship, sx, sy, Colours::SeaGreen, 1.0F, this->ship_style);
+					this->ship->draw(ds, sx, sy, ship_width, ship_height, Colours::SeaGreen, 1.0F, this->ship_style);
 				}
 
 				{ // draw deck region
@@ -70,7 +73,7 @@ namespace WarGrey::SCADA {
 			Microsoft::Graphics::Canvas::Geometry::CanvasStrokeStyle^ style) {}
 
 	private:
-		Microsoft::Graphics::Canvas::Geometry::CanvasGeometry^ ship;
+		WarGrey::SCADA::ScaledHull* ship;
 		Microsoft::Graphics::Canvas::Geometry::CanvasStrokeStyle^ ship_style;
 
 	private:
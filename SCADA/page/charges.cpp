@@ -1,10 +1,12 @@
 ﻿#include <map>
 
 #include "page/charges.hpp"
+#include "page/flowgraph.hpp"
 #include "page/diagnostics/hopper_pump_dx.hpp"
 #include "page/subpage/underwater_pump_motor.hpp"
 
 #include "configuration.hpp"
+#include "intern.hpp"
 #include "menu.hpp"
 
 #include "module.hpp"
@@ -108,14 +110,14 @@ public:
 		MenuFlyout^ ps_hmenu = nullptr, MenuFlyout^ sb_hmenu = nullptr,
 		MenuFlyout^ ps_uwmenu = nullptr, MenuFlyout^ sb_uwmenu = nullptr)
 		: master(master), ps_hopper_menu(ps_hmenu), sb_hopper_menu(sb_hmenu),
-		ps_underwater_menu(ps_uwmenu), sb_underwater_menu(sb_uwmenu) {}
+		ps_underwater_menu(ps_uwmenu), sb_underwater_menu(sb_uwmenu) {
+		this->declare_pipelines();
+	}
 
 public:
 	void pre_read_data(Syslog* logger) override {
 		this->master->enter_critical_section();
 		this->master->begin_update_sequence();
-
-		this->station->clear_subtacks();
 	}
 
 	void on_analog_input(long long timepoint_ms, const uint8* DB2, size_t count2, const uint8* DB203, size_t count203, Syslog* logger) override {
@@ -212,69 +214,17 @@ public:
 	}
 
 	void on_signals_updated(long long timepoint_ms, Syslog* logger) override {
-		{ // flow PS water
-			CS c0910[] = { CS::I0923, CS::D010 };
-
-			this->try_flow_water(CS::D004, CS::Port, water_color);
-			this->try_flow_water(CS::D006, CS::D004, CS::D009, water_color);
-			this->try_flow_water(CS::D009, c0910, water_color);
-			this->try_flow_water(CS::D017, CS::D010, water_color);
-
-			if (this->valve_open(CS::D005)) {
-				CS c0517[] = { CS::D004, CS::D005, CS::d0205, CS::PSHPump, CS::D017 };
-
-				this->station->push_subtrack(c0517, water_color);
-				this->nintercs[CS::n0405]->set_color(water_color);
-			} else {
-				this->nintercs[CS::n0405]->set_color(default_pipe_color);
-			}
-
-			this->try_flow_water(CS::D010, CS::D016, water_color);
-			this->try_flow_water(CS::D012, CS::e12, water_color);
-			this->try_flow_water(CS::D014, CS::e14, water_color);
-			this->try_flow_water(CS::D016, CS::e16, water_color);
-		}
-
-		{ // flow SB water
-			CS c0708[] = { CS::I0723, CS::D008 };
-
-			this->try_flow_water(CS::D003, CS::Starboard, water_color);
-			this->try_flow_water(CS::D026, CS::D003, CS::D007, water_color);
-			this->try_flow_water(CS::D007, c0708, water_color);
-			this->try_flow_water(CS::D018, CS::D008, water_color);
-
-			if (this->valve_open(CS::D025)) {
-				CS c0318[] = { CS::D003, CS::D025, CS::d0225, CS::SBHPump, CS::D018 };
-
-				this->station->push_subtrack(c0318, water_color);
-				this->nintercs[CS::n0325]->set_color(water_color);
-			} else {
-				this->nintercs[CS::n0325]->set_color(default_pipe_color);
-			}
-
-			this->try_flow_water(CS::D008, CS::D015, water_color);
-			this->try_flow_water(CS::D011, CS::e11, water_color);
-			this->try_flow_water(CS::D013, CS::e13, water_color);
-			this->try_flow_water(CS::D015, CS::e15, water_color);
+		for (auto it = this->gvalves.begin(); it != this->gvalves.end(); it++) {
+			this->flow.gate(it->first, (it->second->get_state() == GateValveState::Open));
 		}
 
-		if (this->valve_open(CS::D023)) {
-			CS d0810[] = { CS::D008, CS::I0723, CS::I0923, CS::D010 };
+		this->flow.flow(this->station);
 
-			this->station->push_subtrack(d0810, water_color);
-			this->nintercs[CS::n0723]->set_color(water_color);
-			this->nintercs[CS::n0923]->set_color(water_color);
-		} else {
-			this->nintercs[CS::n0723]->set_color(default_pipe_color);
-			this->nintercs[CS::n0923]->set_color(default_pipe_color);
-		}
-
-		if (this->valve_open(CS::D024)) {
-			this->station->push_subtrack(CS::d24, CS::egantry, water_color);
-			this->gantry_pipe->set_color(water_color);
-		} else {
-			this->gantry_pipe->set_color(default_pipe_color);
-		}
+		this->nintercs[CS::n0405]->set_color(this->valve_open(CS::D005) ? water_color : default_pipe_color);
+		this->nintercs[CS::n0325]->set_color(this->valve_open(CS::D025) ? water_color : default_pipe_color);
+		this->nintercs[CS::n0723]->set_color(this->valve_open(CS::D023) ? water_color : default_pipe_color);
+		this->nintercs[CS::n0923]->set_color(this->valve_open(CS::D023) ? water_color : default_pipe_color);
+		this->gantry_pipe->set_color(this->valve_open(CS::D024) ? water_color : default_pipe_color);
 	}
 
 	void post_read_data(Syslog* logger) override {
@@ -284,9 +234,9 @@ public:
 
 public:
 	void construct(float gwidth, float gheight) {
-		this->caption_font = make_bold_text_format("Microsoft YaHei", normal_font_size);
-		this->label_font = make_bold_text_format("Microsoft YaHei", small_font_size);
-		this->special_font = make_text_format(tiny_font_size);
+		this->caption_font = intern_bold_text_format("Microsoft YaHei", normal_font_size);
+		this->label_font = intern_bold_text_format("Microsoft YaHei", small_font_size);
+		this->special_font = intern_text_format(tiny_font_size);
 
 		this->pump_style = make_highlight_dimension_style(large_metrics_font_size, 6U, 0, Colours::Background);
 		this->highlight_style = make_highlight_dimension_style(large_metrics_font_size, 6U, 0, Colours::Green);
@@ -294,8 +244,8 @@ public:
 		this->relationship_style = make_dash_stroke(CanvasDashStyle::DashDot);
 		this->relationship_color = Colours::DarkGray;
 
-		this->hopper_style.number_font = make_bold_text_format("Cambria Math", large_metrics_font_size);
-		this->hopper_style.unit_font = make_bold_text_format("Cambria", normal_font_size);
+		this->hopper_style.number_font = intern_bold_text_format("Cambria Math", large_metrics_font_size);
+		this->hopper_style.unit_font = intern_bold_text_format("Cambria", normal_font_size);
 
 		this->percentage_style.precision = 1;
 	}
@@ -341,6 +291,7 @@ public:
 		pTurtle->jump_back(CS::d1819)->move_right(5, CS::deck_lx)->move_right(2, CS::D019)->move_right(2)->move_to(CS::d1920);
 		
 		this->station = this->master->insert_one(new Tracklet<CS>(pTurtle, default_pipe_thickness, default_pipe_color));
+		this->flow.invalidate(); // the new track has nothing drawn yet
 		this->load_buttons(this->functions);
 
 		{ // load gantry pipe segement
@@ -696,31 +647,57 @@ private:
 		return (this->gvalves[vid]->get_state() == GateValveState::Open);
 	}
 
-	void try_flow_water(CS vid, CS eid1, CS eid2, CanvasSolidColorBrush^ color) {
-		if (this->valve_open(vid)) {
-			this->station->push_subtrack(vid, eid1, color);
+	void declare_pipelines() {
+		CS c0910[] = { CS::I0923, CS::D010 };
+		CS c0517[] = { CS::D004, CS::D005, CS::d0205, CS::PSHPump, CS::D017 };
+		CS c0708[] = { CS::I0723, CS::D008 };
+		CS c0318[] = { CS::D003, CS::D025, CS::d0225, CS::SBHPump, CS::D018 };
+		CS d0810[] = { CS::D008, CS::I0723, CS::I0923, CS::D010 };
+
+		{ // PS water
+			this->push_water_path(CS::D004, CS::Port);
+			this->push_water_path(CS::D006, CS::D004, CS::D009);
+			this->push_water_path(CS::D009, c0910);
+			this->push_water_path(CS::D017, CS::D010);
+			this->flow.push_path(water_color, c0517, { CS::D005 });
+			this->push_water_path(CS::D010, CS::D016);
+			this->push_water_path(CS::D012, CS::e12);
+			this->push_water_path(CS::D014, CS::e14);
+			this->push_water_path(CS::D016, CS::e16);
+		}
 
-			if (eid2 != CS::_) {
-				this->station->push_subtrack(vid, eid2, color);
-			}
+		{ // SB water
+			this->push_water_path(CS::D003, CS::Starboard);
+			this->push_water_path(CS::D026, CS::D003, CS::D007);
+			this->push_water_path(CS::D007, c0708);
+			this->push_water_path(CS::D018, CS::D008);
+			this->flow.push_path(water_color, c0318, { CS::D025 });
+			this->push_water_path(CS::D008, CS::D015);
+			this->push_water_path(CS::D011, CS::e11);
+			this->push_water_path(CS::D013, CS::e13);
+			this->push_water_path(CS::D015, CS::e15);
 		}
+
+		this->flow.push_path(water_color, d0810, { CS::D023 });
+		this->flow.push_path(water_color, CS::d24, CS::egantry, { CS::D024 });
 	}
 
-	void try_flow_water(CS vid, CS* path, unsigned int count, CanvasSolidColorBrush^ color) {
-		if (this->valve_open(vid)) {
-			this->station->push_subtrack(vid, path[0], color);
-			this->station->push_subtrack(path, count, color);
+	void push_water_path(CS vid, CS eid1, CS eid2 = CS::_) {
+		this->flow.push_path(water_color, vid, eid1, { vid });
+
+		if (eid2 != CS::_) {
+			this->flow.push_path(water_color, vid, eid2, { vid });
 		}
 	}
 
 	template<unsigned int N>
-	void try_flow_water(CS vid, CS(&path)[N], CanvasSolidColorBrush^ color) {
-		this->try_flow_water(vid, path, N, color);
+	void push_water_path(CS vid, CS (&path)[N]) {
+		this->flow.push_path(water_color, vid, path[0], { vid });
+		this->flow.push_path(water_color, path, N, { vid });
 	}
 
-	void try_flow_water(CS vid, CS eid, CanvasSolidColorBrush^ color) {
-		this->try_flow_water(vid, eid, CS::_, color);
-	}
+private:
+	FlowGraph<CS> flow;
 
 // never deletes these graphlets mannually
 private:
@@ -806,7 +783,7 @@ ChargesPage::ChargesPage(PLCMaster* plc) : Planet(__MODULE__), device(plc) {
 
 		{ // only highlight menu items of these four menus
 			dashboard = new Vessel(this, this->ps_hopper_op, this->sb_hopper_op, this->ps_underwater_op, this->sb_underwater_op);
-			this->device->push_confirmation_receiver(dashboard);
+			this->device->push_frame_receiver(dashboard);
 		}
 	} else {
 		dashboard = new Vessel(this);
@@ -2,6 +2,8 @@
 
 #include "page/diagnostics/dredges_dx.hpp"
 #include "configuration.hpp"
+#include "intern.hpp"
+#include "readout.hpp"
 
 #include "datum/string.hpp"
 
@@ -29,8 +31,8 @@ using namespace Microsoft::Graphics::Canvas::UI;
 using namespace Microsoft::Graphics::Canvas::Text;
 using namespace Microsoft::Graphics::Canvas::Brushes;
 
-static CanvasSolidColorBrush^ region_background = Colours::make(diagnostics_region_background);
-static CanvasSolidColorBrush^ diagnosis_background = Colours::make(diagnostics_alarm_background);
+static CanvasSolidColorBrush^ region_background = intern_brush(diagnostics_region_background);
+static CanvasSolidColorBrush^ diagnosis_background = intern_brush(diagnostics_alarm_background);
 
 static CanvasSolidColorBrush^ subcolor = Colours::DimGray;
 static CanvasSolidColorBrush^ subcolor_highlight = Colours::DodgerBlue;
@@ -75,16 +77,16 @@ private enum class WG : unsigned int {
 private class DredgesDx final : public PLCConfirmation {
 public:
 	DredgesDx(DredgesDiagnostics* master, DX side) : master(master), side(side) {
-		this->region_font = make_bold_text_format("Microsoft YaHei", normal_font_size);
-		this->diagnosis_font = make_bold_text_format("Microsoft YaHei", small_font_size);
+		this->region_font = intern_bold_text_format("Microsoft YaHei", normal_font_size);
+		this->diagnosis_font = intern_bold_text_format("Microsoft YaHei", small_font_size);
 
-		this->plain_style.number_font = make_bold_text_format("Microsoft YaHei", tiny_font_size);
+		this->plain_style.number_font = intern_bold_text_format("Microsoft YaHei", tiny_font_size);
 		this->plain_style.unit_font = this->plain_style.number_font;
 		this->plain_style.precision = 1U;
 
 		this->btn_style.font = this->plain_style.unit_font;
 
-		this->color = Colours::make((side == DX::PS) ? default_ps_color : default_sb_color);
+		this->color = intern_brush((side == DX::PS) ? default_ps_color : default_sb_color);
 		this->inset_ratio = 1.618F;
 
 		this->misc_start = WG::PumpsRunning;
@@ -205,10 +207,10 @@ public:
 	}
 
 	void on_analog_input(long long timepoint_ms, const uint8* DB2, size_t count2, const uint8* DB203, size_t count203, Syslog* logger) override {
-		this->metrics[WG::CurrentPulse]->set_text(flstring(DBD(DB2, this->pulses + 16U), 0));
-		this->metrics[WG::UpperPulse]->set_text(flstring(DBD(DB2, this->pulses + 0U), 0));
-		this->metrics[WG::LowerPulse]->set_text(flstring(DBD(DB2, this->pulses + 4U), 0));
-		this->metrics[WG::SaddlePulse]->set_text(flstring(DBD(DB2, this->pulses + 8U), 0));
+		this->set_pulse(WG::CurrentPulse, DBD(DB2, this->pulses + 16U));
+		this->set_pulse(WG::UpperPulse, DBD(DB2, this->pulses + 0U));
+		this->set_pulse(WG::LowerPulse, DBD(DB2, this->pulses + 4U));
+		this->set_pulse(WG::SaddlePulse, DBD(DB2, this->pulses + 8U));
 
 		this->backoil->set_value(RealData(DB203, master_back_oil_pressure));
 	}
@@ -509,6 +511,12 @@ private:
 		return okay;
 	}
 
+	void set_pulse(WG id, float pulse) {
+		if (this->readouts.changed(id, pulse, 0U)) {
+			this->metrics[id]->set_text(flstring(pulse, 0));
+		}
+	}
+
 	void reset_captions(WG prefix) {
 		for (WG id = WG::WinchCondition; id <= WG::WinchMetrics; id++) {
 			this->labels[id]->set_text(_speak(prefix.ToString() + id.ToString()));
@@ -522,6 +530,7 @@ private: // never delete these graphlets mannually
 	std::map<WG, Credit<Labellet, WG>*> subwinches;
 	std::map<WG, Credit<Labellet, WG>*> subgantries;
 	std::map<WG, Credit<Labellet, WG>*> metrics;
+	ReadoutCache<WG> readouts;
 	std::map<WGFunction, Credit<Buttonlet, WGFunction>*> buttons;
 	Dimensionlet* backoil;
 	RoundedRectanglet* misc_region;
@@ -573,7 +582,7 @@ DredgesDiagnostics::DredgesDiagnostics(DX side, PLCMaster* plc)
 	
 	this->dashboard = dashboard;
 	
-	this->device->push_confirmation_receiver(dashboard);
+	this->device->push_frame_receiver(dashboard);
 }
 
 DredgesDiagnostics::~DredgesDiagnostics() {
@@ -602,11 +611,11 @@ void DredgesDiagnostics::load(CanvasCreateResourcesReason reason, float width, f
 	auto dashboard = dynamic_cast<DredgesDx*>(this->dashboard);
 	
 	if (dashboard != nullptr) {
-		auto caption_font = make_bold_text_format("Microsoft YaHei", large_font_size);
+		auto caption_font = intern_bold_text_format("Microsoft YaHei", large_font_size);
 		
 		dashboard->load(width, height, this->title_height, this->vgapsize);
 		
-		this->titlebar = this->insert_one(new Rectanglet(width, this->title_height, Colours::make(diagnostics_caption_background)));
+		this->titlebar = this->insert_one(new Rectanglet(width, this->title_height, intern_brush(diagnostics_caption_background)));
 		this->title = this->insert_one(new Labellet(this->display_name(), caption_font, diagnostics_caption_foreground));
 	}
 }
@@ -3,6 +3,7 @@
 #include "page/diagnostics/gland_pump_dx.hpp"
 #include "decorator/decorator.hpp"
 #include "configuration.hpp"
+#include "intern.hpp"
 
 #include "module.hpp"
 #include "brushes.hxx"
@@ -21,11 +22,11 @@ using namespace Microsoft::Graphics::Canvas::UI;
 using namespace Microsoft::Graphics::Canvas::Text;
 using namespace Microsoft::Graphics::Canvas::Brushes;
 
-static CanvasSolidColorBrush^ region_background = Colours::make(diagnostics_region_background);
-static CanvasSolidColorBrush^ diagnosis_background = Colours::make(diagnostics_alarm_background);
+static CanvasSolidColorBrush^ region_background = intern_brush(diagnostics_region_background);
+static CanvasSolidColorBrush^ diagnosis_background = intern_brush(diagnostics_alarm_background);
 static CanvasSolidColorBrush^ diagnosis_foreground = Colours::Silver;
 
-static CanvasTextFormat^ diagnosis_font = make_bold_text_format("Microsoft YaHei", normal_font_size);
+static CanvasTextFormat^ diagnosis_font = intern_bold_text_format("Microsoft YaHei", normal_font_size);
 
 // WARNING: order matters
 private enum class FP : unsigned int {
@@ -211,7 +212,7 @@ GlandPumpDiagnostics::GlandPumpDiagnostics(PLCMaster* plc) : ICreditSatellite(pl
 	this->decorator = decorator;
 
 	this->push_decorator(decorator);
-	this->device->push_confirmation_receiver(dashboard);
+	this->device->push_frame_receiver(dashboard);
 }
 
 GlandPumpDiagnostics::~GlandPumpDiagnostics() {
@@ -239,11 +240,11 @@ void GlandPumpDiagnostics::load(CanvasCreateResourcesReason reason, float width,
 	auto db = dynamic_cast<GlandPumpDx*>(this->dashboard);
 	
 	if (db != nullptr) {
-		auto caption_font = make_bold_text_format("Microsoft YaHei", large_font_size);
+		auto caption_font = intern_bold_text_format("Microsoft YaHei", large_font_size);
 		
 		db->load(width, height, this->title_height);
 		
-		this->titlebar = this->insert_one(new Rectanglet(width, this->title_height, Colours::make(diagnostics_caption_background)));
+		this->titlebar = this->insert_one(new Rectanglet(width, this->title_height, intern_brush(diagnostics_caption_background)));
 		this->title = this->insert_one(new Labellet(this->display_name(), caption_font, diagnostics_caption_foreground));
 	}
 }
@@ -2,6 +2,7 @@
 
 #include "page/diagnostics/hopper_pump_dx.hpp"
 #include "configuration.hpp"
+#include "intern.hpp"
 
 #include "module.hpp"
 #include "brushes.hxx"
@@ -23,8 +24,8 @@ using namespace Microsoft::Graphics::Canvas::UI;
 using namespace Microsoft::Graphics::Canvas::Text;
 using namespace Microsoft::Graphics::Canvas::Brushes;
 
-static CanvasSolidColorBrush^ region_background = Colours::make(diagnostics_region_background);
-static CanvasSolidColorBrush^ diagnosis_background = Colours::make(diagnostics_alarm_background);
+static CanvasSolidColorBrush^ region_background = intern_brush(diagnostics_region_background);
+static CanvasSolidColorBrush^ diagnosis_background = intern_brush(diagnostics_alarm_background);
 
 // WARNING: order matters
 private enum class HP : unsigned int {
@@ -48,10 +49,10 @@ private enum class HP : unsigned int {
 private class HopperPumpDx final : public PLCConfirmation {
 public:
 	HopperPumpDx(HopperPumpDiagnostics* master, bool ps, unsigned int color) : master(master), ps(ps) {
-		this->region_font = make_bold_text_format("Microsoft YaHei", normal_font_size);
-		this->diagnosis_font = make_bold_text_format("Microsoft YaHei", small_font_size);
+		this->region_font = intern_bold_text_format("Microsoft YaHei", normal_font_size);
+		this->diagnosis_font = intern_bold_text_format("Microsoft YaHei", small_font_size);
 
-		this->color = Colours::make(color);
+		this->color = intern_brush(color);
 
 		this->hp_start = HP::HPRemoteControl;
 		this->hp_end = HP::HPSpeedKnobMoved;
@@ -281,8 +282,8 @@ HopperPumpDiagnostics::HopperPumpDiagnostics(PLCMaster* plc) : ISatellite(plc->g
 	this->ps_dashboard = ps_dashboard;
 	this->sb_dashboard = sb_dashboard;
 	
-	this->device->push_confirmation_receiver(ps_dashboard);
-	this->device->push_confirmation_receiver(sb_dashboard);
+	this->device->push_frame_receiver(ps_dashboard);
+	this->device->push_frame_receiver(sb_dashboard);
 }
 
 HopperPumpDiagnostics::~HopperPumpDiagnostics() {
@@ -320,13 +321,13 @@ void HopperPumpDiagnostics::load(CanvasCreateResourcesReason reason, float width
 	auto sb_dashboard = dynamic_cast<HopperPumpDx*>(this->sb_dashboard);
 	
 	if ((ps_dashboard != nullptr) && (sb_dashboard)) {
-		auto caption_font = make_bold_text_format("Microsoft YaHei", large_font_size);
+		auto caption_font = intern_bold_text_format("Microsoft YaHei", large_font_size);
 		float half_width = width * 0.5F;
 
 		ps_dashboard->load(0.0F, half_width, height, this->title_height, this->vgapsize);
 		sb_dashboard->load(half_width, half_width, height, this->title_height, this->vgapsize);
 
-		this->titlebar = this->insert_one(new Rectanglet(width, this->title_height, Colours::make(diagnostics_caption_background)));
+		this->titlebar = this->insert_one(new Rectanglet(width, this->title_height, intern_brush(diagnostics_caption_background)));
 		this->title = this->insert_one(new Labellet(this->display_name(), caption_font, diagnostics_caption_foreground));
 	}
 }
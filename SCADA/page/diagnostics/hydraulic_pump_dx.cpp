@@ -2,6 +2,7 @@
 
 #include "page/diagnostics/hydraulic_pump_dx.hpp"
 #include "configuration.hpp"
+#include "intern.hpp"
 
 #include "datum/string.hpp"
 
@@ -25,8 +26,8 @@ using namespace Microsoft::Graphics::Canvas::UI;
 using namespace Microsoft::Graphics::Canvas::Text;
 using namespace Microsoft::Graphics::Canvas::Brushes;
 
-static CanvasSolidColorBrush^ region_background = Colours::make(diagnostics_region_background);
-static CanvasSolidColorBrush^ diagnosis_background = Colours::make(diagnostics_alarm_background);
+static CanvasSolidColorBrush^ region_background = intern_brush(diagnostics_region_background);
+static CanvasSolidColorBrush^ diagnosis_background = intern_brush(diagnostics_alarm_background);
 
 static CanvasSolidColorBrush^ subcolor = Colours::DimGray;
 static CanvasSolidColorBrush^ subcolor_highlight = Colours::DodgerBlue;
@@ -127,9 +128,9 @@ static const P* select_pump_conditions(unsigned int id, unsigned int* count) {
 private class PumpDx final : public PLCConfirmation {
 public:
 	PumpDx(HydraulicPumpDiagnostics* master) : master(master) {
-		this->region_font = make_bold_text_format("Microsoft YaHei", normal_font_size);
-		this->diagnosis_font = make_bold_text_format("Microsoft YaHei", small_font_size);
-		this->subfont = make_bold_text_format("Microsoft YaHei", tiny_font_size);
+		this->region_font = intern_bold_text_format("Microsoft YaHei", normal_font_size);
+		this->diagnosis_font = intern_bold_text_format("Microsoft YaHei", small_font_size);
+		this->subfont = intern_bold_text_format("Microsoft YaHei", tiny_font_size);
 	}
 
 public:
@@ -377,7 +378,7 @@ HydraulicPumpDiagnostics::HydraulicPumpDiagnostics(PLCMaster* plc) : ICreditSate
 	
 	this->dashboard = dashboard;
 	
-	this->device->push_confirmation_receiver(dashboard);
+	this->device->push_frame_receiver(dashboard);
 }
 
 HydraulicPumpDiagnostics::~HydraulicPumpDiagnostics() {
@@ -406,11 +407,11 @@ void HydraulicPumpDiagnostics::load(CanvasCreateResourcesReason reason, float wi
 	auto dashboard = dynamic_cast<PumpDx*>(this->dashboard);
 	
 	if (dashboard != nullptr) {
-		auto caption_font = make_bold_text_format("Microsoft YaHei", large_font_size);
+		auto caption_font = intern_bold_text_format("Microsoft YaHei", large_font_size);
 		
 		dashboard->load(width, height, this->title_height, this->vgapsize);
 		
-		this->titlebar = this->insert_one(new Rectanglet(width, this->title_height, Colours::make(diagnostics_caption_background)));
+		this->titlebar = this->insert_one(new Rectanglet(width, this->title_height, intern_brush(diagnostics_caption_background)));
 		this->title = this->insert_one(new Labellet(this->display_name(), caption_font, diagnostics_caption_foreground));
 	}
 }
@@ -2,6 +2,7 @@
 
 #include "page/diagnostics/water_pump_dx.hpp"
 #include "configuration.hpp"
+#include "intern.hpp"
 
 #include "module.hpp"
 #include "brushes.hxx"
@@ -23,8 +24,8 @@ using namespace Microsoft::Graphics::Canvas::UI;
 using namespace Microsoft::Graphics::Canvas::Text;
 using namespace Microsoft::Graphics::Canvas::Brushes;
 
-static CanvasSolidColorBrush^ region_background = Colours::make(diagnostics_region_background);
-static CanvasSolidColorBrush^ diagnosis_background = Colours::make(diagnostics_alarm_background);
+static CanvasSolidColorBrush^ region_background = intern_brush(diagnostics_region_background);
+static CanvasSolidColorBrush^ diagnosis_background = intern_brush(diagnostics_alarm_background);
 
 // WARNING: order matters
 private enum class WP : unsigned int {
@@ -46,10 +47,10 @@ private enum class WP : unsigned int {
 private class WaterPumpDx final : public PLCConfirmation {
 public:
 	WaterPumpDx(WaterPumpDiagnostics* master, bool ps, unsigned int color) : master(master), ps(ps) {
-		this->region_font = make_bold_text_format("Microsoft YaHei", large_font_size);
-		this->diagnosis_font = make_bold_text_format("Microsoft YaHei", normal_font_size);
+		this->region_font = intern_bold_text_format("Microsoft YaHei", large_font_size);
+		this->diagnosis_font = intern_bold_text_format("Microsoft YaHei", normal_font_size);
 
-		this->color = Colours::make(color);
+		this->color = intern_brush(color);
 
 		this->sc_start = WP::RemoteControl;
 		this->sc_end = WP::SpeedKnobMoved;
@@ -220,8 +221,8 @@ WaterPumpDiagnostics::WaterPumpDiagnostics(PLCMaster* plc) : ISatellite(plc->get
 	this->ps_dashboard = ps_dashboard;
 	this->sb_dashboard = sb_dashboard;
 	
-	this->device->push_confirmation_receiver(ps_dashboard);
-	this->device->push_confirmation_receiver(sb_dashboard);
+	this->device->push_frame_receiver(ps_dashboard);
+	this->device->push_frame_receiver(sb_dashboard);
 }
 
 WaterPumpDiagnostics::~WaterPumpDiagnostics() {
@@ -259,13 +260,13 @@ void WaterPumpDiagnostics::load(CanvasCreateResourcesReason reason, float width,
 	auto sb_dashboard = dynamic_cast<WaterPumpDx*>(this->sb_dashboard);
 	
 	if ((ps_dashboard != nullptr) && (sb_dashboard)) {
-		auto caption_font = make_bold_text_format("Microsoft YaHei", large_font_size);
+		auto caption_font = intern_bold_text_format("Microsoft YaHei", large_font_size);
 		float half_width = width * 0.5F;
 
 		ps_dashboard->load(0.0F, half_width, height, this->title_height, this->vgapsize);
 		sb_dashboard->load(half_width, half_width, height, this->title_height, this->vgapsize);
 
-		this->titlebar = this->insert_one(new Rectanglet(width, this->title_height, Colours::make(diagnostics_caption_background)));
+		this->titlebar = this->insert_one(new Rectanglet(width, this->title_height, intern_brush(diagnostics_caption_background)));
 		this->title = this->insert_one(new Labellet(this->display_name(), caption_font, diagnostics_caption_foreground));
 	}
 }
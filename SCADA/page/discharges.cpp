@@ -1,7 +1,9 @@
 ﻿#include <map>
 
 #include "page/discharges.hpp"
+#include "page/flowgraph.hpp"
 #include "configuration.hpp"
+#include "intern.hpp"
 #include "menu.hpp"
 
 #include "module.hpp"
@@ -111,14 +113,14 @@ public:
 	Rainbows(DischargesPage* master
 		, MenuFlyout^ ps_menu = nullptr, MenuFlyout^ sb_menu = nullptr
 		, MenuFlyout^ bow_winch_menu = nullptr, MenuFlyout^ stern_winch_menu = nullptr)
-		: master(master), ps_menu(ps_menu), sb_menu(sb_menu), bow_menu(bow_winch_menu), stern_menu(stern_winch_menu) {}
+		: master(master), ps_menu(ps_menu), sb_menu(sb_menu), bow_menu(bow_winch_menu), stern_menu(stern_winch_menu) {
+		this->declare_pipelines();
+	}
 
 public:
 	void pre_read_data(Syslog* logger) override {
 		this->master->enter_critical_section();
 		this->master->begin_update_sequence();
-
-		this->station->clear_subtacks();
 	}
 
 	void on_analog_input(long long timepoint_ms, const uint8* DB2, size_t count2, const uint8* DB203, size_t count203, Syslog* logger) override {
@@ -255,71 +257,42 @@ public:
 	}
 
 	void on_signals_updated(long long timepoint_ms, Syslog* logger) override {
-		RS rsb19[] = { RS::d0225, RS::SBHPump, RS::D018, RS::D019 };
-		RS r19[] = { RS::d019, RS::D021 };
-		RS r20[] = { RS::d2122, RS::D022 };
-
-		this->station->push_subtrack(RS::D001, RS::Hatch, water_color);
+		for (auto it = this->gvalves.begin(); it != this->gvalves.end(); it++) {
+			this->flow.gate(it->first, (it->second->get_state() == GateValveState::Open));
+		}
 
-		this->try_flow_water(RS::D001, RS::D002, water_color);
-		this->try_flow_water(RS::D019, RS::D021, water_color);
-		this->try_flow_water(RS::D020, r20, water_color);
-		this->try_flow_water(RS::D021, RS::shd_joint, water_color);
-		this->try_flow_water(RS::D022, RS::rainbowing, water_color);
+		this->flow.flow(this->station);
 
 		if (this->valve_open(RS::D002)) {
-			this->station->push_subtrack(RS::D002, RS::manual, water_color);
-			this->station->push_subtrack(rsb19, water_color);
 			this->manual_pipe->set_color(water_color);
 		} else {
 			this->manual_pipe->set_color(default_pipe_color);
 		}
 
 		if (this->valve_open(RS::D023)) {
-			RS d0810[] = { RS::D018, RS::I0723, RS::D009 };
-			RS rps20[] = { RS::d0205, RS::PSHPump, RS::D020 };
-
-			this->station->push_subtrack(d0810, water_color);
 			this->nintercs[RS::n0723]->set_color(water_color);
 			this->nintercs[RS::n0923]->set_color(water_color);
 
-			this->try_flow_water(RS::D009, RS::D006, water_color);
-
 			if (this->valve_open(RS::D006)) {
-				this->station->push_subtrack(RS::d0406, RS::D006, water_color);
-				this->station->push_subtrack(RS::d0406, RS::D005, water_color);
 				this->nintercs[RS::n0405]->set_color(water_color);
 			} else {
 				this->nintercs[RS::n0405]->set_color(default_pipe_color);
 			}
-
-			this->try_flow_water(RS::D005, rps20, water_color);
 		} else {
 			this->nintercs[RS::n0723]->set_color(default_pipe_color);
 			this->nintercs[RS::n0923]->set_color(default_pipe_color);
 		}
 
-		{ // flow SB water
-			RS r0824[] = { RS::D008, RS::gantry, RS::d024, RS::D024 };
-
-			this->station->push_subtrack(RS::D003, RS::Starboard, water_color);
-			this->try_flow_water(RS::D025, rsb19, water_color);
-			this->try_flow_water(RS::D018, RS::D008, water_color);
-			this->try_flow_water(RS::D024, RS::barge, water_color);
-
-			if (this->valve_open(RS::D003)) {
-				this->station->push_subtrack(RS::D003, RS::D025, water_color);
-				this->nintercs[RS::n0325]->set_color(water_color);
-			} else {
-				this->nintercs[RS::n0325]->set_color(default_pipe_color);
-			}
+		if (this->valve_open(RS::D003)) {
+			this->nintercs[RS::n0325]->set_color(water_color);
+		} else {
+			this->nintercs[RS::n0325]->set_color(default_pipe_color);
+		}
 
-			if (this->valve_open(RS::D008)) {
-				this->station->push_subtrack(r0824, water_color);
-				this->nintercs[RS::n24]->set_color(water_color);
-			} else {
-				this->nintercs[RS::n24]->set_color(default_pipe_color);
-			}
+		if (this->valve_open(RS::D008)) {
+			this->nintercs[RS::n24]->set_color(water_color);
+		} else {
+			this->nintercs[RS::n24]->set_color(default_pipe_color);
 		}
 	}
 
@@ -330,16 +303,16 @@ public:
 
 public:
 	void construct(float gwidth, float gheight) {
-		this->caption_font = make_bold_text_format("Microsoft YaHei", normal_font_size);
-		this->label_font = make_bold_text_format("Microsoft YaHei", small_font_size);
+		this->caption_font = intern_bold_text_format("Microsoft YaHei", normal_font_size);
+		this->label_font = intern_bold_text_format("Microsoft YaHei", small_font_size);
 		this->pump_style = make_highlight_dimension_style(large_metrics_font_size, 6U, 0U, Colours::Background);
 		this->highlight_style = make_highlight_dimension_style(large_metrics_font_size, 6U, 0U, Colours::Green);
 		this->relationship_style = make_dash_stroke(CanvasDashStyle::DashDot);
 		this->relationship_color = Colours::DarkGray;
 		this->door_paired_color = this->relationship_color;
 
-		this->metrics_style.number_font = make_bold_text_format("Cambria Math", large_metrics_font_size);
-		this->metrics_style.unit_font = make_bold_text_format("Cambria", normal_font_size);
+		this->metrics_style.number_font = intern_bold_text_format("Cambria Math", large_metrics_font_size);
+		this->metrics_style.unit_font = intern_bold_text_format("Cambria", normal_font_size);
 
 		this->percentage_style.precision = 1;
 	}
@@ -378,6 +351,7 @@ public:
 		pTurtle->jump_back(RS::d1819)->move_right(5, RS::deck_lx)->move_right(2, RS::D019)->move_right(2, RS::d019)->move_to(RS::d1920);
 		
 		this->station = this->master->insert_one(new Tracklet<RS>(pTurtle, default_pipe_thickness, default_pipe_color));
+		this->flow.invalidate(); // the new track has nothing drawn yet
 		
 		{ // load winches and cylinders
 			this->load_winches(this->winches, this->winch_labels, radius * 3.2F);
@@ -767,32 +741,56 @@ private:
 		return (this->gvalves[vid]->get_state() == GateValveState::Open);
 	}
 
-	void try_flow_water(RS vid, RS eid1, RS eid2, CanvasSolidColorBrush^ color) {
-		if (this->valve_open(vid)) {
-			this->station->push_subtrack(vid, eid1, color);
+	void declare_pipelines() {
+		RS rsb19[] = { RS::d0225, RS::SBHPump, RS::D018, RS::D019 };
+		RS r20[] = { RS::d2122, RS::D022 };
+		RS d0810[] = { RS::D018, RS::I0723, RS::D009 };
+		RS rps20[] = { RS::d0205, RS::PSHPump, RS::D020 };
+		RS r0824[] = { RS::D008, RS::gantry, RS::d024, RS::D024 };
 
-			if (eid2 != RS::_) {
-				this->station->push_subtrack(vid, eid2, color);
-			}
+		this->flow.push_path(water_color, RS::D001, RS::Hatch);
+
+		this->push_water_path(RS::D001, RS::D002);
+		this->push_water_path(RS::D019, RS::D021);
+		this->push_water_path(RS::D020, r20);
+		this->push_water_path(RS::D021, RS::shd_joint);
+		this->push_water_path(RS::D022, RS::rainbowing);
+
+		this->flow.push_path(water_color, RS::D002, RS::manual, { RS::D002 });
+		this->flow.push_path(water_color, rsb19, { RS::D002 });
+
+		{ // through the intercommunicating valve
+			this->flow.push_path(water_color, d0810, { RS::D023 });
+			this->flow.push_path(water_color, RS::D009, RS::D006, { RS::D023, RS::D009 });
+			this->flow.push_path(water_color, RS::d0406, RS::D006, { RS::D023, RS::D006 });
+			this->flow.push_path(water_color, RS::d0406, RS::D005, { RS::D023, RS::D006 });
+			this->flow.push_path(water_color, RS::D005, rps20[0], { RS::D023, RS::D005 });
+			this->flow.push_path(water_color, rps20, { RS::D023, RS::D005 });
 		}
-	}
 
-	void try_flow_water(RS vid, RS* path, unsigned int count, CanvasSolidColorBrush^ color) {
-		if (this->valve_open(vid)) {
-			this->station->push_subtrack(vid, path[0], color);
-			this->station->push_subtrack(path, count, color);
+		{ // SB water
+			this->flow.push_path(water_color, RS::D003, RS::Starboard);
+			this->push_water_path(RS::D025, rsb19);
+			this->push_water_path(RS::D018, RS::D008);
+			this->push_water_path(RS::D024, RS::barge);
+			this->flow.push_path(water_color, RS::D003, RS::D025, { RS::D003 });
+			this->flow.push_path(water_color, r0824, { RS::D008 });
 		}
 	}
 
-	template<unsigned int N>
-	void try_flow_water(RS vid, RS(&path)[N], CanvasSolidColorBrush^ color) {
-		this->try_flow_water(vid, path, N, color);
+	void push_water_path(RS vid, RS eid) {
+		this->flow.push_path(water_color, vid, eid, { vid });
 	}
 
-	void try_flow_water(RS vid, RS eid, CanvasSolidColorBrush^ color) {
-		this->try_flow_water(vid, eid, RS::_, color);
+	template<unsigned int N>
+	void push_water_path(RS vid, RS (&path)[N]) {
+		this->flow.push_path(water_color, vid, path[0], { vid });
+		this->flow.push_path(water_color, path, N, { vid });
 	}
 
+private:
+	FlowGraph<RS> flow;
+
 // never deletes these graphlets mannually
 private:
 	Tracklet<RS>* station;
@@ -889,7 +887,7 @@ DischargesPage::DischargesPage(PLCMaster* plc) : Planet(__MODULE__), device(plc)
 		this->gdischarge_op = make_discharge_condition_menu(plc);
 
 		dashboard = new Rainbows(this, this->ps_hopper_op, this->sb_hopper_op, this->bow_winch_op, this->stern_winch_op);
-		this->device->push_confirmation_receiver(dashboard);
+		this->device->push_frame_receiver(dashboard);
 	} else {
 		dashboard = new Rainbows(this);
 	}
@@ -2,6 +2,8 @@
 
 #include "page/draughts.hpp"
 #include "configuration.hpp"
+#include "intern.hpp"
+#include "capture.hpp"
 #include "menu.hpp"
 
 #include "schema/datalet/earthwork_ts.hpp"
@@ -69,7 +71,7 @@ public:
 		this->datasource = new EarthWorkDataSource(logger, RotationPeriod::Daily);
 		this->datasource->reference();
 
-		this->label_font = make_bold_text_format(large_font_size);
+		this->label_font = intern_bold_text_format(large_font_size);
 		this->plain_style = make_plain_dimension_style(small_metrics_font_size, 5U, 2U);
 		this->flonum_style = make_plain_dimension_style(small_metrics_font_size, normal_font_size, 2U);
 		this->fixnum_style = make_plain_dimension_style(small_metrics_font_size, normal_font_size, 0U);
@@ -184,8 +186,8 @@ public:
 		
 		overflow_height = ship_height * 0.382F;
 		this->overflowpipe = this->master->insert_one(new OverflowPipelet(hopper_height_range, overflow_height));
-		this->ps_radar = this->master->insert_one(new Radarlet<SM>(__MODULE__, overflow_height * 0.5F, Colours::make(default_ps_color)));
-		this->sb_radar = this->master->insert_one(new Radarlet<SM>(__MODULE__, overflow_height * 0.5F, Colours::make(default_sb_color)));
+		this->ps_radar = this->master->insert_one(new Radarlet<SM>(__MODULE__, overflow_height * 0.5F, intern_brush(default_ps_color)));
+		this->sb_radar = this->master->insert_one(new Radarlet<SM>(__MODULE__, overflow_height * 0.5F, intern_brush(default_sb_color)));
 
 		cylinder_height = ship_height * 0.42F;
 		this->load_cylinder(this->cylinders, EWTS::EarthWork, cylinder_height, earthwork_range, 0U, "meter3");
@@ -457,7 +459,7 @@ DraughtsPage::DraughtsPage(PLCMaster* plc) : Planet(__MODULE__), device(plc) {
 	if (this->device != nullptr) {
 		this->overflow_op = make_overflow_menu(plc);
 
-		this->device->push_confirmation_receiver(dashboard);
+		this->device->push_frame_receiver(dashboard);
 	}
 }
 
@@ -519,8 +521,8 @@ bool DraughtsPage::on_key(VirtualKey key, bool wargrey_keyboard) {
 				this->hide_virtual_keyboard();
 			}
 
-			this->save(this->name() + "-" + file_basename_from_second(current_seconds()) + ".png",
-				this->actual_width(), this->actual_height(), Colours::Background);
+			capture_enqueue(this->take_snapshot(this->actual_width(), this->actual_height(), Colours::Background),
+				this->name() + "-" + file_basename_from_second(current_seconds()) + ".png");
 
 			if (wargrey_keyboard) {
 				this->show_virtual_keyboard(ScreenKeyboard::Affinepad, this->get_focus_graphlet(), GraphletAnchor::CB, 0.0F, 4.0F);
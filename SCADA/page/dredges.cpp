@@ -1,9 +1,11 @@
 ﻿#include <map>
 
 #include "page/dredges.hpp"
+#include "page/flowgraph.hpp"
 #include "page/diagnostics/dredges_dx.hpp"
 
 #include "configuration.hpp"
+#include "intern.hpp"
 #include "drag_info.hpp"
 #include "menu.hpp"
 
@@ -112,13 +114,13 @@ static void dredges_diagnostics(DredgesPosition position, PLCMaster* plc) {
 private class IDredgingSystem : virtual public PLCConfirmation, virtual public SlangLocalPeer<uint8> {
 public:
 	IDredgingSystem(DredgesPage* master) : master(master) {
-		this->label_font = make_bold_text_format("Microsoft YaHei", normal_font_size);
-		this->station_font = make_bold_text_format("Microsoft YaHei", tiny_font_size);
-		this->caption_font = make_bold_text_format("Microsoft YaHei", large_font_size);
+		this->label_font = intern_bold_text_format("Microsoft YaHei", normal_font_size);
+		this->station_font = intern_bold_text_format("Microsoft YaHei", tiny_font_size);
+		this->caption_font = intern_bold_text_format("Microsoft YaHei", large_font_size);
 		this->caption_color = Colours::Salmon;
 
-		this->plain_style.number_font = make_bold_text_format("Cambria Math", large_metrics_font_size);
-		this->plain_style.unit_font = make_bold_text_format("Cambria", normal_font_size);
+		this->plain_style.number_font = intern_bold_text_format("Cambria Math", large_metrics_font_size);
+		this->plain_style.unit_font = intern_bold_text_format("Cambria", normal_font_size);
 		this->plain_style.minimize_number_width = 5U;
 		this->plain_style.precision = 1U;
 
@@ -488,13 +490,13 @@ public:
 	Dredges(DredgesPage* master) : IDredgingSystem(master) {
 		this->ps_address = make_ps_dredging_system_schema();
 		this->sb_address = make_sb_dredging_system_schema();
+
+		this->declare_pipelines();
 	}
 
 public:
 	void pre_read_data(Syslog* logger) override {
 		IDredgingSystem::pre_read_data(logger);
-
-		this->station->clear_subtacks();
 	}
 
 	void on_analog_input(long long timepoint_ms, const uint8* DB2, size_t count2, const uint8* DB203, size_t count203, Syslog* logger) override {
@@ -612,28 +614,11 @@ public:
 	}
 
 	void on_signals_updated(long long timepoint_ms, Syslog* logger) override {
-		this->station->push_subtrack(DS::D003, DS::SB, water_color);
-		this->station->push_subtrack(DS::D004, DS::PS, water_color);
-
-		if (this->valves[DS::D003]->get_state() == GateValveState::Open) {
-			DS d11[] = { DS::LMOD, DS::sb, DS::SBHP, DS::D003 };
-			DS d13[] = { DS::d013, DS::d13, DS::SBHP, DS::D003 };
-			DS d15[] = { DS::d15, DS::d1315, DS::SBHP, DS::D003 };
-
-			this->try_flow_water(DS::D011, d11, water_color);
-			this->try_flow_water(DS::D013, d13, water_color);
-			this->try_flow_water(DS::D015, d15, water_color);
+		for (auto it = this->valves.begin(); it != this->valves.end(); it++) {
+			this->flow.gate(it->first, (it->second->get_state() == GateValveState::Open));
 		}
 
-		if (this->valves[DS::D004]->get_state() == GateValveState::Open) {
-			DS d12[] = { DS::LMOD, DS::ps, DS::PSHP, DS::D004 };
-			DS d14[] = { DS::d014, DS::d14, DS::PSHP, DS::D004 };
-			DS d16[] = { DS::d16, DS::d1416, DS::PSHP, DS::D004 };
-
-			this->try_flow_water(DS::D012, d12, water_color);
-			this->try_flow_water(DS::D014, d14, water_color);
-			this->try_flow_water(DS::D016, d16, water_color);
-		}
+		this->flow.flow(this->station);
 	}
 
 	void post_read_data(Syslog* logger) override {
@@ -671,6 +656,7 @@ public:
 		pTurtle->move_down(4, DS::d16)->move_right(3)->move_down(2, DS::D016);
 
 		this->station = this->master->insert_one(new Tracklet<DS>(pTurtle, default_pipe_thickness, default_pipe_color));
+		this->flow.invalidate(); // the new track has nothing drawn yet
 
 		this->load_percentage(this->progresses, DS::D003);
 		this->load_percentage(this->progresses, DS::D004);
@@ -992,28 +978,35 @@ private:
 	}
 
 private:
-	void try_flow_water(DS vid, DS eid, CanvasSolidColorBrush^ color) {
-		switch (this->valves[vid]->get_state()) {
-		case GateValveState::Open: {
-			this->station->push_subtrack(vid, eid, color);
-		}
-		}
-	}
+	void declare_pipelines() {
+		DS d11[] = { DS::LMOD, DS::sb, DS::SBHP, DS::D003 };
+		DS d13[] = { DS::d013, DS::d13, DS::SBHP, DS::D003 };
+		DS d15[] = { DS::d15, DS::d1315, DS::SBHP, DS::D003 };
+		DS d12[] = { DS::LMOD, DS::ps, DS::PSHP, DS::D004 };
+		DS d14[] = { DS::d014, DS::d14, DS::PSHP, DS::D004 };
+		DS d16[] = { DS::d16, DS::d1416, DS::PSHP, DS::D004 };
 
-	void try_flow_water(DS vid, DS* path, unsigned int count, CanvasSolidColorBrush^ color) {
-		switch (this->valves[vid]->get_state()) {
-		case GateValveState::Open: {
-			this->station->push_subtrack(vid, path[0], color);
-			this->station->push_subtrack(path, count, color);
-		}
-		}
+		this->flow.push_path(water_color, DS::D003, DS::SB);
+		this->flow.push_path(water_color, DS::D004, DS::PS);
+
+		this->push_water_path(DS::D011, d11, { DS::D003, DS::D011 });
+		this->push_water_path(DS::D013, d13, { DS::D003, DS::D013 });
+		this->push_water_path(DS::D015, d15, { DS::D003, DS::D015 });
+
+		this->push_water_path(DS::D012, d12, { DS::D004, DS::D012 });
+		this->push_water_path(DS::D014, d14, { DS::D004, DS::D014 });
+		this->push_water_path(DS::D016, d16, { DS::D004, DS::D016 });
 	}
 
 	template<unsigned int N>
-	void try_flow_water(DS vid, DS (&path)[N], CanvasSolidColorBrush^ color) {
-		this->try_flow_water(vid, path, N, color);
+	void push_water_path(DS vid, DS (&path)[N], std::initializer_list<DS> gates) {
+		this->flow.push_path(water_color, vid, path[0], gates);
+		this->flow.push_path(water_color, path, N, gates);
 	}
 
+private:
+	FlowGraph<DS> flow;
+
 private: // never delete these graphlets manually.
 	Tracklet<DS>* station;
 	std::map<DS, Credit<GateValvelet, DS>*> valves;
@@ -1051,7 +1044,7 @@ public:
 		this->button_style.thickness = 2.0F;
 		this->button_style.corner_radius = 1.0F;
 		this->button_style.foreground_color = Colours::CornflowerBlue;
-		this->button_style.font = make_bold_text_format(tiny_font_size);
+		this->button_style.font = intern_bold_text_format(tiny_font_size);
 
 		if (plc != nullptr) {
 			this->winch_op = make_dredging_winch_menu(dredges_diagnostics, plc);
@@ -1842,7 +1835,7 @@ DredgesPage::DredgesPage(DragView type, PLCMaster* plc)
 	this->dashboard = dashboard;
 
 	if (this->device != nullptr) {
-		this->device->push_confirmation_receiver(dashboard);
+		this->device->push_frame_receiver(dashboard);
 	}
 
 	this->push_decorator(new DragCableDecorator(dashboard));
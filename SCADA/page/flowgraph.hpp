@@ -0,0 +1,136 @@
+#pragma once
+
+#include <vector>
+#include <initializer_list>
+
+#include "datum/enum.hpp"
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * Pipelines are declared once as paths of track nodes, each of which is gated by zero or more gates,
+	 *   a gate is whatever the page considers as a switch of the flow, usually a valve, sometimes a pump.
+	 *
+	 * Pages feed gate states every frame, they are packed into a bitset,
+	 *   paths are reevaluated only when the bitset changes,
+	 *   and the track is only rebuilt when the set of flowing paths changes.
+	 */
+	template<typename E>
+	private class FlowGraph {
+	public:
+		FlowGraph() : gates(words_for(_N(E)), 0ULL), staging(words_for(_N(E)), 0ULL), evaluated(false) {}
+
+	public:
+		void push_path(Microsoft::Graphics::Canvas::Brushes::CanvasSolidColorBrush^ color, E start, E end, std::initializer_list<E> gates = {}) {
+			E path[] = { start, end };
+
+			this->push_path(color, path, 2U, gates);
+		}
+
+		void push_path(Microsoft::Graphics::Canvas::Brushes::CanvasSolidColorBrush^ color, const E* path, unsigned int count, std::initializer_list<E> gates = {}) {
+			FlowPath fp;
+
+			fp.color = color;
+			fp.nodes.assign(path, path + count);
+
+			for (E g : gates) {
+				fp.gates.push_back(_I(g));
+			}
+
+			this->paths.push_back(fp);
+			this->flowing.resize(words_for(this->paths.size()), 0ULL);
+			this->evaluated = false;
+		}
+
+		template<unsigned int N>
+		void push_path(Microsoft::Graphics::Canvas::Brushes::CanvasSolidColorBrush^ color, const E (&path)[N], std::initializer_list<E> gates = {}) {
+			this->push_path(color, path, N, gates);
+		}
+
+	public:
+		void gate(E id, bool open) {
+			size_t idx = _I(id);
+			unsigned long long bit = 1ULL << (idx % 64U);
+
+			if (open) {
+				this->staging[idx / 64U] |= bit;
+			} else {
+				this->staging[idx / 64U] &= ~bit;
+			}
+		}
+
+		/**
+		 * the track is rebuilt by the next `flow()` even if no gate changes,
+		 *   pages invoke it whenever the track is (re)created.
+		 */
+		void invalidate() {
+			this->evaluated = false;
+		}
+
+		/**
+		 * returns `true` if the track is rebuilt.
+		 */
+		template<class Track>
+		bool flow(Track* track) {
+			bool rebuilt = false;
+
+			if ((!this->evaluated) || (this->staging != this->gates)) {
+				std::vector<unsigned long long> flows(this->flowing.size(), 0ULL);
+
+				this->gates = this->staging;
+
+				for (size_t pidx = 0; pidx < this->paths.size(); pidx++) {
+					bool open = true;
+
+					for (size_t gidx : this->paths[pidx].gates) {
+						if ((this->gates[gidx / 64U] & (1ULL << (gidx % 64U))) == 0ULL) {
+							open = false;
+							break;
+						}
+					}
+
+					if (open) {
+						flows[pidx / 64U] |= (1ULL << (pidx % 64U));
+					}
+				}
+
+				if ((!this->evaluated) || (flows != this->flowing)) {
+					this->flowing = flows;
+					track->clear_subtacks();
+
+					for (size_t pidx = 0; pidx < this->paths.size(); pidx++) {
+						if ((this->flowing[pidx / 64U] & (1ULL << (pidx % 64U))) != 0ULL) {
+							FlowPath& fp = this->paths[pidx];
+
+							track->push_subtrack(fp.nodes.data(), (unsigned int)(fp.nodes.size()), fp.color);
+						}
+					}
+
+					rebuilt = true;
+				}
+
+				this->evaluated = true;
+			}
+
+			return rebuilt;
+		}
+
+	private:
+		static size_t words_for(size_t bits) {
+			return (bits + 63U) / 64U;
+		}
+
+	private:
+		struct FlowPath {
+			Microsoft::Graphics::Canvas::Brushes::CanvasSolidColorBrush^ color;
+			std::vector<E> nodes;
+			std::vector<size_t> gates;
+		};
+
+	private:
+		std::vector<FlowPath> paths;
+		std::vector<unsigned long long> gates;
+		std::vector<unsigned long long> staging;
+		std::vector<unsigned long long> flowing;
+		bool evaluated;
+	};
+}
@@ -1,9 +1,11 @@
 ﻿#include <map>
 
 #include "page/flushs.hpp"
+#include "page/flowgraph.hpp"
 #include "page/diagnostics/water_pump_dx.hpp"
 
 #include "configuration.hpp"
+#include "intern.hpp"
 #include "menu.hpp"
 
 #include "module.hpp"
@@ -104,14 +106,14 @@ static uint16 DO_butterfly_valve_action(ButterflyValveAction cmd, GateValvelet*
 private class Flush final : public PLCConfirmation {
 public:
 	Flush(FlushsPage* master, MenuFlyout^ ps_menu = nullptr, MenuFlyout^ sb_menu = nullptr)
-		: master(master), ps_menu(ps_menu), sb_menu(sb_menu) {}
+		: master(master), ps_menu(ps_menu), sb_menu(sb_menu) {
+		this->declare_pipelines();
+	}
 
 public:
 	void pre_read_data(Syslog* logger) override {
 		this->master->enter_critical_section();
 		this->master->begin_update_sequence();
-
-		this->station->clear_subtacks();
 	}
 
 	void on_analog_input(long long timepoint_ms, const uint8* DB2, size_t count2, const uint8* DB203, size_t count203, Syslog* logger) override {
@@ -222,51 +224,24 @@ public:
 	}
 
 	void on_signals_updated(long long timepoint_ms, Syslog* logger) override {
-		FS h14[] = { FS::HBV01, FS::h1sb, FS::SBPump, FS::h4sb, FS::HBV04 };
-		FS h24[] = { FS::h3ps, FS::HBV03, FS::h3sb, FS::SBPump, FS::h4sb, FS::HBV04 };
-		FS h25[] = { FS::HBV02, FS::h3ps, FS::h5ps, FS::HBV05 };
-
-		this->station->push_subtrack(FS::HBV01, FS::SBSea, water_color);
-		this->station->push_subtrack(FS::HBV02, FS::PSSea, water_color);
-
-		if (this->bfvalves[FS::HBV01]->get_state() == GateValveState::Open) {
-			this->station->push_subtrack(h14, water_color);
+		for (auto it = this->bfvalves.begin(); it != this->bfvalves.end(); it++) {
+			this->flow.gate(it->first, (it->second->get_state() == GateValveState::Open));
 		}
 
+		this->flow.gate(FS::HBV02, (this->bfvalves[FS::HBV02]->get_state() != GateValveState::Closed));
+		this->flow.flow(this->station);
+
 		if (this->bfvalves[FS::HBV02]->get_state() == GateValveState::Closed) {
 			this->nintercs[FS::nic]->set_color(default_pipe_color);
 		} else {
 			this->nintercs[FS::nic]->set_color(water_color);
-			this->station->push_subtrack(h25, water_color);
-
-			if (this->bfvalves[FS::HBV03]->get_state() == GateValveState::Open) {
-				this->station->push_subtrack(h24, water_color);
-			}
 		}
 
-		this->try_flow_water(FS::HBV05, FS::HBV07, FS::HBV08, water_color);
-		this->try_flow_water(FS::HBV07, FS::Port, water_color);
-		this->try_flow_water(FS::HBV08, FS::HBV10, water_color);
-
-		this->try_flow_water(FS::HBV04, FS::HBV06, FS::HBV09, water_color);
-		this->try_flow_water(FS::HBV06, FS::Starboard, water_color);
-		this->try_flow_water(FS::HBV09, FS::HBV10, water_color);
-		this->try_flow_water(FS::HBV10, FS::water, water_color);
-
 		if (this->bfvalves[FS::HBV18]->get_state() == GateValveState::Open) {
 			this->pipeline18->set_color(water_color);
-			this->station->push_subtrack(FS::HBV10, FS::water, water_color);
 		} else {
 			this->pipeline18->set_color(default_pipe_color);
 		}
-
-		for (FS HBV = FS::HBV11; HBV <= FS::HBV17; HBV++) {
-			unsigned int distance = _I(HBV) - _I(FS::HBV11);
-			FS lb = _E(FS, _I(FS::lb11) + distance);
-			FS rb = _E(FS, _I(FS::rb11) + distance);
-
-			this->try_flow_water(HBV, rb, lb, water_color);
-		}
 	}
 
 	void post_read_data(Syslog* logger) override {
@@ -276,13 +251,13 @@ public:
 
 public:
 	void construct(float gwidth, float gheight) {
-		this->caption_font = make_bold_text_format("Microsoft YaHei", normal_font_size);
-		this->label_font = make_bold_text_format("Microsoft YaHei", small_font_size);
+		this->caption_font = intern_bold_text_format("Microsoft YaHei", normal_font_size);
+		this->label_font = intern_bold_text_format("Microsoft YaHei", small_font_size);
 		this->pump_style = make_highlight_dimension_style(large_metrics_font_size, 6U, 0, Colours::Background);
 		this->highlight_style = make_highlight_dimension_style(large_metrics_font_size, 6U, 0, Colours::Green);
 
-		this->metrics_style.number_font = make_bold_text_format("Cambria Math", large_metrics_font_size);
-		this->metrics_style.unit_font = make_bold_text_format("Cambria", normal_font_size);
+		this->metrics_style.number_font = intern_bold_text_format("Cambria Math", large_metrics_font_size);
+		this->metrics_style.unit_font = intern_bold_text_format("Cambria", normal_font_size);
 
 		this->percentage_style.precision = 1;
 	}
@@ -364,6 +339,7 @@ public:
 		this->hopper_room = this->master->insert_one(new Tracklet<FS>(rTurtle, default_pipe_thickness, Colours::DimGray, hstyle));
 		this->hopper_water = this->master->insert_one(new Tracklet<FS>(wTurtle, default_pipe_thickness, Colours::DimGray, hstyle));
 		this->station = this->master->insert_one(new Tracklet<FS>(pTurtle, default_pipe_thickness, default_pipe_color));
+		this->flow.invalidate(); // the new track has nothing drawn yet
 		this->pipeline18 = this->master->insert_one(new Tracklet<FS>(vTurtle, default_pipe_thickness, default_pipe_color));
 
 		this->load_buttons(this->functions);
@@ -382,8 +358,8 @@ public:
 		}
 
 		{ // load special nodes
-			auto pscolor = Colours::make(default_ps_color);
-			auto sbcolor = Colours::make(default_sb_color);
+			auto pscolor = intern_brush(default_ps_color);
+			auto sbcolor = intern_brush(default_sb_color);
 			float dh_radius = gwidth * 2.0F;
 			float nic_radius = radius * 0.25F;
 
@@ -669,22 +645,47 @@ private:
 	}
 
 private:
-	void try_flow_water(FS vid, FS eid1, FS eid2, CanvasSolidColorBrush^ color) {
-		switch (this->bfvalves[vid]->get_state()) {
-		case GateValveState::Open: {
-			this->station->push_subtrack(vid, eid1, color);
+	void declare_pipelines() {
+		FS h14[] = { FS::HBV01, FS::h1sb, FS::SBPump, FS::h4sb, FS::HBV04 };
+		FS h24[] = { FS::h3ps, FS::HBV03, FS::h3sb, FS::SBPump, FS::h4sb, FS::HBV04 };
+		FS h25[] = { FS::HBV02, FS::h3ps, FS::h5ps, FS::HBV05 };
 
-			if (eid2 != FS::_) {
-				this->station->push_subtrack(vid, eid2, color);
-			}
-		}
+		this->flow.push_path(water_color, FS::HBV01, FS::SBSea);
+		this->flow.push_path(water_color, FS::HBV02, FS::PSSea);
+		this->flow.push_path(water_color, h14, { FS::HBV01 });
+		this->flow.push_path(water_color, h25, { FS::HBV02 });
+		this->flow.push_path(water_color, h24, { FS::HBV02, FS::HBV03 });
+
+		this->push_water_path(FS::HBV05, FS::HBV07, FS::HBV08);
+		this->push_water_path(FS::HBV07, FS::Port);
+		this->push_water_path(FS::HBV08, FS::HBV10);
+
+		this->push_water_path(FS::HBV04, FS::HBV06, FS::HBV09);
+		this->push_water_path(FS::HBV06, FS::Starboard);
+		this->push_water_path(FS::HBV09, FS::HBV10);
+		this->push_water_path(FS::HBV10, FS::water);
+		this->flow.push_path(water_color, FS::HBV10, FS::water, { FS::HBV18 });
+
+		for (FS HBV = FS::HBV11; HBV <= FS::HBV17; HBV++) {
+			unsigned int distance = _I(HBV) - _I(FS::HBV11);
+			FS lb = _E(FS, _I(FS::lb11) + distance);
+			FS rb = _E(FS, _I(FS::rb11) + distance);
+
+			this->push_water_path(HBV, rb, lb);
 		}
 	}
 
-	void try_flow_water(FS vid, FS eid, CanvasSolidColorBrush^ color) {
-		this->try_flow_water(vid, eid, FS::_, color);
+	void push_water_path(FS vid, FS eid1, FS eid2 = FS::_) {
+		this->flow.push_path(water_color, vid, eid1, { vid });
+
+		if (eid2 != FS::_) {
+			this->flow.push_path(water_color, vid, eid2, { vid });
+		}
 	}
 
+private:
+	FlowGraph<FS> flow;
+
 // never deletes these graphlets mannually
 private:
 	Tracklet<FS>* station;
@@ -756,7 +757,7 @@ FlushsPage::FlushsPage(PLCMaster* plc) : Planet(__MODULE__), device(plc) {
 			Flush* dashboard = new Flush(this, this->ps_pump_op, this->sb_pump_op);
 			
 			this->dashboard = dashboard;
-			this->device->push_confirmation_receiver(dashboard);
+			this->device->push_frame_receiver(dashboard);
 		}
 	} else {
 		this->dashboard = new Flush(this);
@@ -1,9 +1,11 @@
 ﻿#include <map>
 
 #include "page/glands.hpp"
+#include "page/flowgraph.hpp"
 #include "page/diagnostics/gland_pump_dx.hpp"
 
 #include "configuration.hpp"
+#include "intern.hpp"
 #include "menu.hpp"
 
 #include "module.hpp"
@@ -120,17 +122,17 @@ static void gland_pump_diagnostics(HydraulicPumplet* pump, PLCMaster* plc) {
 private class GlandPumps final : public PLCConfirmation {
 public:
 	GlandPumps(GlandsPage* master) : master(master), sea_oscillation(1.0F) {
-		this->label_font = make_bold_text_format("Microsoft YaHei", small_font_size);
+		this->label_font = intern_bold_text_format("Microsoft YaHei", small_font_size);
 		this->dimension_style = make_highlight_dimension_style(large_metrics_font_size, 6U, 1U);
 		this->setting_style = make_highlight_dimension_style(large_metrics_font_size, 6U, 0, Colours::GhostWhite, Colours::RoyalBlue);
+
+		this->declare_pipelines();
 	}
 
 public:
 	void pre_read_data(Syslog* logger) override {
 		this->master->enter_critical_section();
 		this->master->begin_update_sequence();
-
-		this->station->clear_subtacks();
 	}
 
 	void on_analog_input(long long timepoint_ms, const uint8* DB2, size_t count2, const uint8* DB203, size_t count203, Syslog* logger) override {
@@ -182,27 +184,11 @@ public:
 	}
 
 	void on_signals_updated(long long timepoint_ms, Syslog* logger) override {
-		GP ps_hopper_long_path[] = { GP::DGV13, GP::pshp, GP::d44, GP::DGV8, GP::PSHP };
-		GP ps_hopper_short_path[] = { GP::DGV14, GP::d44, GP::DGV8, GP::PSHP };
-		GP sb_hopper_short_path[] = { GP::DGV15, GP::d45, GP::DGV7, GP::SBHP };
-		GP sb_hopper_long_path[] = { GP::DGV16, GP::sbhp, GP::d45, GP::DGV7, GP::SBHP };
-		GP ps_underwater_path[] = { GP::PSUWP1, GP::psuwp, GP::d46, GP::PSUWP };
-		GP sb_underwater_path[] = { GP::SBUWP2, GP::sbuwp, GP::d47, GP::SBUWP };
-
-		this->station->push_subtrack(GP::Hatch, GP::DGV16, water_color);
-		this->station->push_subtrack(GP::Sea, GP::SBUWP2, water_color);
-
-		this->try_flow_water(GP::PSFP, GP::DGV12, GP::flushs, water_color);
-		this->try_flow_water(GP::SBFP, GP::DGV11, GP::flushs, water_color);
-		this->try_flow_water(GP::PSHPa, ps_hopper_long_path, water_color);
-		this->try_flow_water(GP::PSHPb, ps_hopper_short_path, water_color);
-		this->try_flow_water(GP::SBHPa, sb_hopper_short_path, water_color);
-		this->try_flow_water(GP::SBHPb, sb_hopper_long_path, water_color);
+		for (auto it = this->pumps.begin(); it != this->pumps.end(); it++) {
+			this->flow.gate(it->first, (it->second->get_state() == HydraulicPumpState::Running));
+		}
 
-		this->try_flow_water(GP::PSUWP1, ps_underwater_path, water_color);
-		this->try_flow_water(GP::PSUWP2, GP::PSUWP2, GP::PSUWP, water_color);
-		this->try_flow_water(GP::SBUWP1, GP::SBUWP1, GP::SBUWP, water_color);
-		this->try_flow_water(GP::SBUWP2, sb_underwater_path, water_color);
+		this->flow.flow(this->station);
 	}
 
 	void post_read_data(Syslog* logger) override {
@@ -272,6 +258,7 @@ public:
 		pTurtle->move_right(10)->turn_right_up(GP::sbuwp)->move_up(3)->turn_up_right();
 
 		this->station = this->master->insert_one(new Tracklet<GP>(pTurtle, default_pipe_thickness, default_pipe_color));
+		this->flow.invalidate(); // the new track has nothing drawn yet
 		this->to_flushs = this->master->insert_one(new ArrowHeadlet(gheight, 0.0, Colours::Silver));
 		this->sea = this->master->insert_one(new VLinelet(gheight * 2.0F, default_pipe_thickness,
 			water_color, make_dash_stroke(CanvasDashStyle::Dash)));
@@ -454,27 +441,33 @@ private:
 	}
 
 private:
-	void try_flow_water(GP pid, GP start, GP end, CanvasSolidColorBrush^ color) {
-		switch (this->pumps[pid]->get_state()) {
-		case HydraulicPumpState::Running: {
-			this->station->push_subtrack(start, end, color);
-		}
-		}
-	}
+	void declare_pipelines() {
+		GP ps_hopper_long_path[] = { GP::DGV13, GP::pshp, GP::d44, GP::DGV8, GP::PSHP };
+		GP ps_hopper_short_path[] = { GP::DGV14, GP::d44, GP::DGV8, GP::PSHP };
+		GP sb_hopper_short_path[] = { GP::DGV15, GP::d45, GP::DGV7, GP::SBHP };
+		GP sb_hopper_long_path[] = { GP::DGV16, GP::sbhp, GP::d45, GP::DGV7, GP::SBHP };
+		GP ps_underwater_path[] = { GP::PSUWP1, GP::psuwp, GP::d46, GP::PSUWP };
+		GP sb_underwater_path[] = { GP::SBUWP2, GP::sbuwp, GP::d47, GP::SBUWP };
 
-	void try_flow_water(GP pid, GP* path, unsigned int count, CanvasSolidColorBrush^ color) {
-		switch (this->pumps[pid]->get_state()) {
-		case HydraulicPumpState::Running: {
-			this->station->push_subtrack(path, count, color);
-		}
-		}
-	}
+		this->flow.push_path(water_color, GP::Hatch, GP::DGV16);
+		this->flow.push_path(water_color, GP::Sea, GP::SBUWP2);
 
-	template<unsigned int N>
-	void try_flow_water(GP pid, GP (&path)[N], CanvasSolidColorBrush^ color) {
-		this->try_flow_water(pid, path, N, color);
+		this->flow.push_path(water_color, GP::DGV12, GP::flushs, { GP::PSFP });
+		this->flow.push_path(water_color, GP::DGV11, GP::flushs, { GP::SBFP });
+		this->flow.push_path(water_color, ps_hopper_long_path, { GP::PSHPa });
+		this->flow.push_path(water_color, ps_hopper_short_path, { GP::PSHPb });
+		this->flow.push_path(water_color, sb_hopper_short_path, { GP::SBHPa });
+		this->flow.push_path(water_color, sb_hopper_long_path, { GP::SBHPb });
+
+		this->flow.push_path(water_color, ps_underwater_path, { GP::PSUWP1 });
+		this->flow.push_path(water_color, GP::PSUWP2, GP::PSUWP, { GP::PSUWP2 });
+		this->flow.push_path(water_color, GP::SBUWP1, GP::SBUWP, { GP::SBUWP1 });
+		this->flow.push_path(water_color, sb_underwater_path, { GP::SBUWP2 });
 	}
 
+private:
+	FlowGraph<GP> flow;
+
 // never deletes these graphlets mannually
 private:
 	Tracklet<GP>* station;
@@ -509,7 +502,7 @@ GlandsPage::GlandsPage(PLCMaster* plc) : Planet(__MODULE__), device(plc) {
 	if (this->device != nullptr) {
 		this->pump_op = make_gland_pump_menu(DO_glands_action, gland_pump_diagnostics, plc);
 	
-		this->device->push_confirmation_receiver(dashboard);
+		this->device->push_frame_receiver(dashboard);
 	}
 
 	{ // load decorators
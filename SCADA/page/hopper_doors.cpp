@@ -2,6 +2,7 @@
 
 #include "page/hopper_doors.hpp"
 #include "configuration.hpp"
+#include "intern.hpp"
 #include "menu.hpp"
 
 #include "graphlet/symbol/door/hopper_doorlet.hpp"
@@ -57,7 +58,7 @@ private enum class HD : unsigned int {
 private class Doors final : public PLCConfirmation {
 public:
 	Doors(HopperDoorsPage* master, BottomDoorDecorator* ship) : master(master), decorator(ship) {
-		this->label_font = make_bold_text_format(large_font_size);
+		this->label_font = intern_bold_text_format(large_font_size);
 		this->metrics_style = make_plain_dimension_style(small_metrics_font_size, normal_font_size);
 		this->plain_style = make_plain_dimension_style(small_metrics_font_size, 5U, 2);
 		this->pump_style = make_highlight_dimension_style(large_metrics_font_size, 6U, 0, Colours::Background);
@@ -165,10 +166,10 @@ public:
 		this->load_alarms(this->lockers, BottomDoorCommand::AutoLock, BottomDoorCommand::Locked, vinset * 2.0F);
 		
 		{ // load captions
-			CanvasTextFormat^ cpt_font = make_bold_text_format("Microsoft YaHei", large_font_size);
+			CanvasTextFormat^ cpt_font = intern_bold_text_format("Microsoft YaHei", large_font_size);
 
-			this->load_label(this->labels, HD::Port, Colours::make(default_ps_color), cpt_font);
-			this->load_label(this->labels, HD::Starboard, Colours::make(default_sb_color), cpt_font);
+			this->load_label(this->labels, HD::Port, intern_brush(default_ps_color), cpt_font);
+			this->load_label(this->labels, HD::Starboard, intern_brush(default_sb_color), cpt_font);
 		}
 	}
 
@@ -406,7 +407,7 @@ HopperDoorsPage::HopperDoorsPage(PLCMaster* plc) : Planet(__MODULE__), device(pl
 		this->gdoors67_op = make_bottom_doors_group_menu(BottomDoorsGroup::HDoor67, plc);
 		this->gdoors17_op = make_bottom_doors_group_menu(BottomDoorsGroup::HDoor17, plc);
 
-		this->device->push_confirmation_receiver(dashboard);
+		this->device->push_frame_receiver(dashboard);
 	}
 }
 
@@ -1,9 +1,11 @@
 ﻿#include <map>
 
 #include "page/hydraulics.hpp"
+#include "page/flowgraph.hpp"
 #include "page/diagnostics/hydraulic_pump_dx.hpp"
 
 #include "configuration.hpp"
+#include "intern.hpp"
 #include "menu.hpp"
 
 #include "module.hpp"
@@ -184,14 +186,14 @@ static const HS* select_captions(HS pid, unsigned int* count) {
 /*************************************************************************************************/
 private class Hydraulics final : public PLCConfirmation {
 public:
-	Hydraulics(HydraulicsPage* master, MenuFlyout^ heater_menu = nullptr) : master(master), heater_menu(heater_menu) {}
+	Hydraulics(HydraulicsPage* master, MenuFlyout^ heater_menu = nullptr) : master(master), heater_menu(heater_menu) {
+		this->declare_pipelines();
+	}
 
 public:
 	void pre_read_data(Syslog* logger) override {
 		this->master->enter_critical_section();
 		this->master->begin_update_sequence();
-
-		this->station->clear_subtacks();
 	}
 
 	void on_analog_input(long long timepoint_ms, const uint8* DB2, size_t count2, const uint8* DB203, size_t count203, Syslog* logger) override {
@@ -381,39 +383,18 @@ public:
 	}
 
 	void on_signals_updated(long long timepoint_ms, Syslog* logger) override {
-		HS ps_path[] = { HS::lt, HS::tl, HS::cl, HS::Master };
-		HS sb_path[] = { HS::rt, HS::tr, HS::cr, HS::Master };
-		HS mt_path[] = { HS::f02, HS::master };
+		for (auto it = this->valves.begin(); it != this->valves.end(); it++) {
+			this->flow.gate(it->first, (it->second->get_state() == ManualValveState::Open));
+		}
+
+		for (auto it = this->pumps.begin(); it != this->pumps.end(); it++) {
+			switch (it->second->get_state()) {
+			case HydraulicPumpState::Running: case HydraulicPumpState::StopReady: this->flow.gate(it->first, true); break;
+			default: this->flow.gate(it->first, false);
+			}
+		}
 
-		this->station->push_subtrack(HS::Master, HS::SQ1, oil_color);
-		this->station->push_subtrack(HS::Master, HS::SQ2, oil_color);
-		this->station->push_subtrack(HS::Visor, HS::SQi, oil_color);
-		this->station->push_subtrack(HS::Visor, HS::SQj, oil_color);
-		this->station->push_subtrack(HS::Storage, HS::SQk1, oil_color);
-
-		this->try_flow_oil(HS::SQi, HS::I, HS::i, nullptr, 0, oil_color);
-		this->try_flow_oil(HS::SQj, HS::J, HS::j, nullptr, 0, oil_color);
-
-		this->try_flow_oil(HS::SQc, HS::C, HS::c, ps_path, oil_color);
-		this->try_flow_oil(HS::SQd, HS::D, HS::d, ps_path, oil_color);
-		this->try_flow_oil(HS::SQe, HS::E, HS::e, ps_path, oil_color);
-		this->try_flow_oil(HS::SQf, HS::F, HS::f, ps_path, oil_color);
-
-		this->try_flow_oil(HS::SQa, HS::A, HS::a, sb_path, oil_color);
-		this->try_flow_oil(HS::SQb, HS::B, HS::b, sb_path, oil_color);
-		this->try_flow_oil(HS::SQg, HS::G, HS::g, sb_path, oil_color);
-		this->try_flow_oil(HS::SQh, HS::H, HS::h, sb_path, oil_color);
-
-		this->try_flow_oil(HS::SQy, HS::Y, HS::y, mt_path, oil_color);
-		this->try_flow_oil(HS::SQl, HS::L, HS::l, mt_path, oil_color);
-		this->try_flow_oil(HS::SQm, HS::M, HS::m, mt_path, oil_color);
-		this->try_flow_oil(HS::SQk1, HS::K, HS::k, mt_path, oil_color);
-		this->try_flow_oil(HS::SQk2, HS::K /* , HS::k, mt_path */, oil_color);
-
-		this->try_flow_oil(HS::SQ2, HS::Port, HS::SQe, oil_color);
-		this->try_flow_oil(HS::SQ1, HS::sb, HS::SQh, oil_color);
-		this->try_flow_oil(HS::SQ1, HS::SQk2, oil_color);
-		this->try_flow_oil(HS::SQ1, HS::SQm, oil_color);
+		this->flow.flow(this->station);
 	}
 
 	void post_read_data(Syslog* logger) override {
@@ -423,15 +404,15 @@ public:
 
 public:
 	void construct(float gwidth, float gheight) {
-		this->caption_font = make_bold_text_format("Microsoft YaHei", large_font_size);
-		this->label_font = make_bold_text_format("Microsoft YaHei", normal_font_size);
+		this->caption_font = intern_bold_text_format("Microsoft YaHei", large_font_size);
+		this->label_font = intern_bold_text_format("Microsoft YaHei", normal_font_size);
 
-		this->button_style.font = make_bold_text_format("Consolas", small_font_size);
+		this->button_style.font = intern_bold_text_format("Consolas", small_font_size);
 		this->button_style.corner_radius = 2.0F;
 		this->button_style.thickness = 2.0F;
 
-		this->fixnum_style.number_font = make_bold_text_format("Cambria Math", large_metrics_font_size);
-		this->fixnum_style.unit_font = make_bold_text_format("Cambria", normal_font_size);
+		this->fixnum_style.number_font = intern_bold_text_format("Cambria Math", large_metrics_font_size);
+		this->fixnum_style.unit_font = intern_bold_text_format("Cambria", normal_font_size);
 		this->flonum_style = this->fixnum_style;
 
 		this->fixnum_style.precision = 0;
@@ -474,6 +455,7 @@ public:
 		pTurtle->jump_left(4, HS::j)->move_up(3, HS::J)->move_up(3, HS::SQj)->move_up(5)->move_right(2 /* HS::Visor */);
 		
 		this->station = this->master->insert_one(new Tracklet<HS>(pTurtle, default_pipe_thickness, default_pipe_color));
+		this->flow.invalidate(); // the new track has nothing drawn yet
 		
 		this->load_label(this->captions, HS::Port, Colours::DarkKhaki, this->caption_font);
 		this->load_label(this->captions, HS::Starboard, Colours::DarkKhaki, this->caption_font);
@@ -841,43 +823,69 @@ private:
 	}
 
 private:
-	void try_flow_oil(HS vid, HS pid, CanvasSolidColorBrush^ color) {
-		switch (this->valves[vid]->get_state()) {
-		case ManualValveState::Open: {
-			this->station->push_subtrack(vid, pid, color);
-		}
-		}
+	void declare_pipelines() {
+		HS ps_path[] = { HS::lt, HS::tl, HS::cl, HS::Master };
+		HS sb_path[] = { HS::rt, HS::tr, HS::cr, HS::Master };
+		HS mt_path[] = { HS::f02, HS::master };
+
+		this->flow.push_path(oil_color, HS::Master, HS::SQ1);
+		this->flow.push_path(oil_color, HS::Master, HS::SQ2);
+		this->flow.push_path(oil_color, HS::Visor, HS::SQi);
+		this->flow.push_path(oil_color, HS::Visor, HS::SQj);
+		this->flow.push_path(oil_color, HS::Storage, HS::SQk1);
+
+		this->push_oil_path(HS::SQi, HS::I, HS::i, nullptr, 0);
+		this->push_oil_path(HS::SQj, HS::J, HS::j, nullptr, 0);
+
+		this->push_oil_path(HS::SQc, HS::C, HS::c, ps_path);
+		this->push_oil_path(HS::SQd, HS::D, HS::d, ps_path);
+		this->push_oil_path(HS::SQe, HS::E, HS::e, ps_path);
+		this->push_oil_path(HS::SQf, HS::F, HS::f, ps_path);
+
+		this->push_oil_path(HS::SQa, HS::A, HS::a, sb_path);
+		this->push_oil_path(HS::SQb, HS::B, HS::b, sb_path);
+		this->push_oil_path(HS::SQg, HS::G, HS::g, sb_path);
+		this->push_oil_path(HS::SQh, HS::H, HS::h, sb_path);
+
+		this->push_oil_path(HS::SQy, HS::Y, HS::y, mt_path);
+		this->push_oil_path(HS::SQl, HS::L, HS::l, mt_path);
+		this->push_oil_path(HS::SQm, HS::M, HS::m, mt_path);
+		this->push_oil_path(HS::SQk1, HS::K, HS::k, mt_path);
+		this->push_oil_path(HS::SQk2, HS::K /* , HS::k, mt_path */);
+
+		this->push_oil_path(HS::SQ2, HS::Port, HS::SQe);
+		this->push_oil_path(HS::SQ1, HS::sb, HS::SQh);
+		this->push_oil_path(HS::SQ1, HS::SQk2);
+		this->push_oil_path(HS::SQ1, HS::SQm);
 	}
 
-	void try_flow_oil(HS vid, HS mid, HS eid, CanvasSolidColorBrush^ color) {
-		switch (this->valves[vid]->get_state()) {
-		case ManualValveState::Open: {
-			this->station->push_subtrack(vid, mid, color);
-			this->station->push_subtrack(mid, eid, color);
-		}
-		}
+	void push_oil_path(HS vid, HS pid) {
+		this->flow.push_path(oil_color, vid, pid, { vid });
 	}
 
-	void try_flow_oil(HS vid, HS pid, HS _id, HS* path, unsigned int count, CanvasSolidColorBrush^ color) {
-		this->try_flow_oil(vid, pid, color);
+	void push_oil_path(HS vid, HS mid, HS eid) {
+		this->flow.push_path(oil_color, vid, mid, { vid });
+		this->flow.push_path(oil_color, mid, eid, { vid });
+	}
 
-		switch (this->pumps[pid]->get_state()) {
-		case HydraulicPumpState::Running: case HydraulicPumpState::StopReady: {
-			this->station->push_subtrack(pid, _id, oil_color);
+	void push_oil_path(HS vid, HS pid, HS _id, HS* path, unsigned int count) {
+		this->push_oil_path(vid, pid);
+		this->flow.push_path(oil_color, pid, _id, { pid });
 
-			if (path != nullptr) {
-				this->station->push_subtrack(_id, path[0], oil_color);
-				this->station->push_subtrack(path, count, color);
-			}
-		}
+		if (path != nullptr) {
+			this->flow.push_path(oil_color, _id, path[0], { pid });
+			this->flow.push_path(oil_color, path, count, { pid });
 		}
 	}
 
 	template<unsigned int N>
-	void try_flow_oil(HS vid, HS pid, HS _id, HS (&path)[N], CanvasSolidColorBrush^ color) {
-		this->try_flow_oil(vid, pid, _id, path, N, color);
+	void push_oil_path(HS vid, HS pid, HS _id, HS (&path)[N]) {
+		this->push_oil_path(vid, pid, _id, path, N);
 	}
 
+private:
+	FlowGraph<HS> flow;
+
 private: // never deletes these graphlets mannually
 	Tracklet<HS>* station;
 	Heaterlet* heater;
@@ -921,7 +929,7 @@ HydraulicsPage::HydraulicsPage(PLCMaster* plc) : Planet(__MODULE__), device(plc)
 		this->heater_op = make_tank_heater_menu(plc);
 
 		dashboard = new Hydraulics(this, this->heater_op);
-		this->device->push_confirmation_receiver(dashboard);
+		this->device->push_frame_receiver(dashboard);
 	} else {
 		dashboard = new Hydraulics(this);
 	}
@@ -2,6 +2,7 @@
 
 #include "page/lubrications.hpp"
 #include "configuration.hpp"
+#include "intern.hpp"
 #include "menu.hpp"
 
 #include "module.hpp"
@@ -36,8 +37,8 @@ using namespace Microsoft::Graphics::Canvas::Brushes;
 private enum class LUOperation { Start, Stop, _ };
 private enum class LUGBOperation { Start, Stop, Auto, _ };
 
-static CanvasSolidColorBrush^ region_background = Colours::make(diagnostics_region_background);
-static CanvasSolidColorBrush^ alarm_background = Colours::make(diagnostics_alarm_background);
+static CanvasSolidColorBrush^ region_background = intern_brush(diagnostics_region_background);
+static CanvasSolidColorBrush^ alarm_background = intern_brush(diagnostics_alarm_background);
 
 // WARNING: order matters
 private enum class LU : unsigned int {
@@ -55,11 +56,11 @@ private enum class LU : unsigned int {
 private class Lubricatings final : public PLCConfirmation {
 public:
 	Lubricatings(LubricatingsPage* master, bool ps, unsigned int color) : master(master), ps(ps) {
-		this->caption_font = make_bold_text_format("Microsoft YaHei", large_font_size);
-		this->alarm_font = make_bold_text_format("Microsoft YaHei", normal_font_size);
-		this->label_font = make_bold_text_format("Microsoft YaHei", small_font_size);
+		this->caption_font = intern_bold_text_format("Microsoft YaHei", large_font_size);
+		this->alarm_font = intern_bold_text_format("Microsoft YaHei", normal_font_size);
+		this->label_font = intern_bold_text_format("Microsoft YaHei", small_font_size);
 
-		this->color = Colours::make(color);
+		this->color = intern_brush(color);
 	}
 
 public:
@@ -243,8 +244,8 @@ LubricatingsPage::LubricatingsPage(PLCMaster* plc) : Planet(__MODULE__), device(
 		this->unit_op = make_lubrication_unit_menu(plc);
 		this->gearbox_op = make_gearbox_lubricator_menu(plc);
 
-		this->device->push_confirmation_receiver(ps_dashboard);
-		this->device->push_confirmation_receiver(sb_dashboard);
+		this->device->push_frame_receiver(ps_dashboard);
+		this->device->push_frame_receiver(sb_dashboard);
 	}
 }
 
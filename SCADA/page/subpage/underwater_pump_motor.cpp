@@ -2,6 +2,7 @@
 
 #include "page/subpage/underwater_pump_motor.hpp"
 #include "configuration.hpp"
+#include "intern.hpp"
 
 #include "module.hpp"
 #include "brushes.hxx"
@@ -22,8 +23,8 @@ using namespace Microsoft::Graphics::Canvas::UI;
 using namespace Microsoft::Graphics::Canvas::Text;
 using namespace Microsoft::Graphics::Canvas::Brushes;
 
-static CanvasSolidColorBrush^ region_background = Colours::make(diagnostics_region_background);
-static CanvasSolidColorBrush^ title_background = Colours::make(diagnostics_alarm_background);
+static CanvasSolidColorBrush^ region_background = intern_brush(diagnostics_region_background);
+static CanvasSolidColorBrush^ title_background = intern_brush(diagnostics_alarm_background);
 
 // WARNING: order matters
 private enum class UWM : unsigned int {
@@ -37,10 +38,10 @@ private enum class UWM : unsigned int {
 private class Motor final : public PLCConfirmation {
 public:
 	Motor(UnderwaterPumpMotorMetrics* master, bool ps, unsigned int color) : master(master), ps(ps) {
-		this->region_font = make_bold_text_format("Microsoft YaHei", large_font_size);
+		this->region_font = intern_bold_text_format("Microsoft YaHei", large_font_size);
 		this->motor_style = make_highlight_dimension_style(normal_font_size, 6U, 4U, 0);
 
-		this->color = Colours::make(color);
+		this->color = intern_brush(color);
 	}
 
 public:
@@ -189,8 +190,8 @@ UnderwaterPumpMotorMetrics::UnderwaterPumpMotorMetrics(PLCMaster* plc) : ISatell
 	this->ps_dashboard = ps_dashboard;
 	this->sb_dashboard = sb_dashboard;
 	
-	this->device->push_confirmation_receiver(ps_dashboard);
-	this->device->push_confirmation_receiver(sb_dashboard);
+	this->device->push_frame_receiver(ps_dashboard);
+	this->device->push_frame_receiver(sb_dashboard);
 }
 
 UnderwaterPumpMotorMetrics::~UnderwaterPumpMotorMetrics() {
@@ -228,13 +229,13 @@ void UnderwaterPumpMotorMetrics::load(CanvasCreateResourcesReason reason, float
 	auto sb_dashboard = dynamic_cast<Motor*>(this->sb_dashboard);
 	
 	if ((ps_dashboard != nullptr) && (sb_dashboard)) {
-		auto caption_font = make_bold_text_format("Microsoft YaHei", large_font_size);
+		auto caption_font = intern_bold_text_format("Microsoft YaHei", large_font_size);
 		float half_width = width * 0.5F;
 
 		ps_dashboard->load(0.0F, half_width, height, this->title_height, this->vgapsize);
 		sb_dashboard->load(half_width, half_width, height, this->title_height, this->vgapsize);
 
-		this->titlebar = this->insert_one(new Rectanglet(width, this->title_height, Colours::make(diagnostics_caption_background)));
+		this->titlebar = this->insert_one(new Rectanglet(width, this->title_height, intern_brush(diagnostics_caption_background)));
 		this->title = this->insert_one(new Labellet(this->display_name(), caption_font, diagnostics_caption_foreground));
 	}
 }
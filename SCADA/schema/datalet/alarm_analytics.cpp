@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <cstring>
+
+#include "schema/datalet/alarm_analytics.hpp"
+
+#include "datum/enum.hpp"
+
+using namespace WarGrey::SCADA;
+
+/*************************************************************************************************/
+static const long long day_span_ms = 86400LL * 1000LL;
+static const long long ring_days = 31LL;
+
+static long long window_days(unsigned int window) {
+	long long days = 1LL;
+
+	switch (_E(AlarmWindow, window)) {
+	case AlarmWindow::Week: days = 7LL; break;
+	case AlarmWindow::Month: days = 30LL; break;
+	}
+
+	return days;
+}
+
+static inline long long day_of(long long timepoint_ms) {
+	return timepoint_ms / day_span_ms;
+}
+
+/*************************************************************************************************/
+AlarmAnalytics::AlarmAnalytics() : today(0LL) {}
+
+void AlarmAnalytics::alert(unsigned int code, Alarm& alarm) {
+	std::unique_lock<std::mutex> lock(this->section);
+	AlarmAnalytics::Ledger& ledger = this->ledger_ref(code);
+	AlarmStatistics& total = ledger.total;
+
+	if (total.occurrences == 0LL) {
+		total.first_alarmtime = alarm.alarmtime;
+		total.last_alarmtime = alarm.alarmtime;
+	} else {
+		total.first_alarmtime = std::min(total.first_alarmtime, alarm.alarmtime);
+		total.last_alarmtime = std::max(total.last_alarmtime, alarm.alarmtime);
+	}
+
+	total.occurrences++;
+
+	if (total.occurrences > 1LL) {
+		total.mtbf_ms = double(total.last_alarmtime - total.first_alarmtime) / double(total.occurrences - 1LL);
+	}
+
+	this->accumulate(code, ledger, day_of(alarm.alarmtime), 1LL, 0LL);
+}
+
+void AlarmAnalytics::fix(unsigned int code, Alarm& alerting_alarm) {
+	std::unique_lock<std::mutex> lock(this->section);
+	AlarmAnalytics::Ledger& ledger = this->ledger_ref(code);
+	long long fixedtime = alerting_alarm.fixedtime.value_or(alerting_alarm.alarmtime);
+	long long active_ms = std::max(fixedtime - alerting_alarm.alarmtime, 0LL);
+
+	ledger.total.fixed++;
+	ledger.total.active_ms += active_ms;
+
+	this->accumulate(code, ledger, day_of(fixedtime), 0LL, active_ms);
+}
+
+void AlarmAnalytics::reset() {
+	std::unique_lock<std::mutex> lock(this->section);
+
+	this->ledgers.clear();
+	this->today = 0LL;
+
+	for (unsigned int w = 0; w < _N(AlarmWindow); w++) {
+		this->rankings[w].clear();
+	}
+}
+
+/*************************************************************************************************/
+bool AlarmAnalytics::statistics(unsigned int code, AlarmStatistics* stats) {
+	std::unique_lock<std::mutex> lock(this->section);
+	auto it = this->ledgers.find(code);
+	bool found = (it != this->ledgers.end());
+
+	if (found) {
+		(*stats) = it->second.total;
+	}
+
+	return found;
+}
+
+bool AlarmAnalytics::statistics(unsigned int code, AlarmWindow window, long long now_ms, AlarmWindowStatistics* stats) {
+	std::unique_lock<std::mutex> lock(this->section);
+	auto it = this->ledgers.find(code);
+	bool found = (it != this->ledgers.end());
+
+	this->advance(day_of(now_ms));
+
+	if (found) {
+		(*stats) = it->second.windows[_I(window)];
+	}
+
+	return found;
+}
+
+size_t AlarmAnalytics::chattering(AlarmWindow window, long long now_ms, size_t n, std::vector<std::pair<unsigned int, long long>>& top) {
+	std::unique_lock<std::mutex> lock(this->section);
+	std::set<std::pair<long long, unsigned int>>& ranking = this->rankings[_I(window)];
+
+	this->advance(day_of(now_ms));
+	top.clear();
+
+	for (auto it = ranking.rbegin(); (it != ranking.rend()) && (top.size() < n); it++) {
+		top.push_back(std::pair<unsigned int, long long>(it->second, it->first));
+	}
+
+	return top.size();
+}
+
+/*************************************************************************************************/
+AlarmAnalytics::Ledger& AlarmAnalytics::ledger_ref(unsigned int code) {
+	auto it = this->ledgers.find(code);
+
+	if (it == this->ledgers.end()) {
+		AlarmAnalytics::Ledger ledger;
+
+		memset(&ledger, 0, sizeof(AlarmAnalytics::Ledger));
+		it = this->ledgers.insert(std::pair<unsigned int, AlarmAnalytics::Ledger>(code, ledger)).first;
+	}
+
+	return it->second;
+}
+
+void AlarmAnalytics::accumulate(unsigned int code, AlarmAnalytics::Ledger& ledger, long long day, long long occurrences, long long active_ms) {
+	this->advance(day);
+
+	// events older than the ring only contribute to the totals
+	if (day > this->today - ring_days) {
+		AlarmWindowStatistics& bucket = ledger.days[day % ring_days];
+
+		bucket.occurrences += occurrences;
+		bucket.active_ms += active_ms;
+
+		for (unsigned int w = 0; w < _N(AlarmWindow); w++) {
+			if (day > this->today - window_days(w)) {
+				AlarmWindowStatistics& self = ledger.windows[w];
+				long long previous = self.occurrences;
+
+				self.occurrences += occurrences;
+				self.active_ms += active_ms;
+				this->rerank(w, code, previous, self.occurrences);
+			}
+		}
+	}
+}
+
+void AlarmAnalytics::advance(long long day) {
+	if (day > this->today) {
+		if (day - this->today >= ring_days) {
+			for (auto it = this->ledgers.begin(); it != this->ledgers.end(); it++) {
+				memset(it->second.windows, 0, sizeof(it->second.windows));
+				memset(it->second.days, 0, sizeof(it->second.days));
+			}
+
+			for (unsigned int w = 0; w < _N(AlarmWindow); w++) {
+				this->rankings[w].clear();
+			}
+		} else {
+			for (long long d = this->today + 1LL; d <= day; d++) {
+				for (auto it = this->ledgers.begin(); it != this->ledgers.end(); it++) {
+					AlarmAnalytics::Ledger& ledger = it->second;
+
+					for (unsigned int w = 0; w < _N(AlarmWindow); w++) {
+						AlarmWindowStatistics& expired = ledger.days[(d - window_days(w)) % ring_days];
+						AlarmWindowStatistics& self = ledger.windows[w];
+						long long previous = self.occurrences;
+
+						self.occurrences -= expired.occurrences;
+						self.active_ms -= expired.active_ms;
+						this->rerank(w, it->first, previous, self.occurrences);
+					}
+
+					// the slot of the new day holds the day that has left all windows
+					ledger.days[d % ring_days] = { 0LL, 0LL };
+				}
+			}
+		}
+
+		this->today = day;
+	}
+}
+
+void AlarmAnalytics::rerank(unsigned int window, unsigned int code, long long previous, long long current) {
+	if (previous != current) {
+		if (previous > 0LL) {
+			this->rankings[window].erase(std::pair<long long, unsigned int>(previous, code));
+		}
+
+		if (current > 0LL) {
+			this->rankings[window].insert(std::pair<long long, unsigned int>(current, code));
+		}
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include <mutex>
+#include <set>
+
+#include "schema/alarm.hpp"
+
+namespace WarGrey::SCADA {
+	// windows of whole UTC calendar days ending with the day of `now`: today, the last 7 days and the last 30 days
+	private enum class AlarmWindow { Day, Week, Month, _ };
+
+	private struct AlarmStatistics {
+		long long occurrences;
+		long long fixed;
+		long long active_ms;
+		long long first_alarmtime;
+		long long last_alarmtime;
+		double mtbf_ms; // mean time between alerts, 0.0 if the alarm has occurred less than twice
+	};
+
+	private struct AlarmWindowStatistics {
+		long long occurrences;
+		long long active_ms;
+	};
+
+	/** NOTE
+	 * Statistics of alarm codes are updated on each alert or fix, queries never touch the history files.
+	 *
+	 * Rolling windows are made of daily buckets (UTC days of alarm times), the oldest bucket leaves
+	 *   the windows when a newer day is seen, so that window sums are always kept up to date.
+	 * Hence windows roll by calendar days rather than by hours, `AlarmWindow::Day` covers the UTC day
+	 *   of `now` since its midnight, not the last 24 hours, and likewise for weeks and months.
+	 * An alarm occurs in the day it is alerted, its active time is counted in the day it is fixed.
+	 *
+	 * Alarms are fed by the persistence queue after they are committed to the history files.
+	 */
+	private class AlarmAnalytics {
+	public:
+		AlarmAnalytics();
+
+	public:
+		void alert(unsigned int code, WarGrey::SCADA::Alarm& alarm);
+		void fix(unsigned int code, WarGrey::SCADA::Alarm& alerting_alarm);
+		void reset();
+
+	public:
+		bool statistics(unsigned int code, WarGrey::SCADA::AlarmStatistics* stats);
+		bool statistics(unsigned int code, WarGrey::SCADA::AlarmWindow window, long long now_ms, WarGrey::SCADA::AlarmWindowStatistics* stats);
+
+		/**
+		 * fills `top` with the codes that have occurred most in the window, the most chattering first.
+		 */
+		size_t chattering(WarGrey::SCADA::AlarmWindow window, long long now_ms, size_t n, std::vector<std::pair<unsigned int, long long>>& top);
+
+	private:
+		struct Ledger {
+			WarGrey::SCADA::AlarmStatistics total;
+			WarGrey::SCADA::AlarmWindowStatistics windows[static_cast<unsigned int>(AlarmWindow::_)];
+			WarGrey::SCADA::AlarmWindowStatistics days[31];
+		};
+
+	private:
+		WarGrey::SCADA::AlarmAnalytics::Ledger& ledger_ref(unsigned int code);
+		void accumulate(unsigned int code, WarGrey::SCADA::AlarmAnalytics::Ledger& ledger, long long day,
+			long long occurrences, long long active_ms);
+		void advance(long long day);
+		void rerank(unsigned int window, unsigned int code, long long previous, long long current);
+
+	private:
+		std::unordered_map<unsigned int, WarGrey::SCADA::AlarmAnalytics::Ledger> ledgers;
+		std::set<std::pair<long long, unsigned int>> rankings[static_cast<unsigned int>(AlarmWindow::_)];
+		std::mutex section;
+		long long today;
+	};
+}
@@ -0,0 +1,144 @@
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+
+#include "schema/datalet/alarm_index.hpp"
+
+using namespace WarGrey::SCADA;
+using namespace WarGrey::GYDM;
+
+/*************************************************************************************************/
+AlarmHistoryIndex::AlarmHistoryIndex(Syslog* logger) : logger(logger), loaded(false), dirty(false) {}
+
+bool AlarmHistoryIndex::open(Platform::String^ path) {
+	std::unique_lock<std::mutex> lock(this->section);
+	std::ifstream sidecar(path->Data());
+
+	this->path = path;
+
+	if (sidecar.is_open()) {
+		AlarmHistorySummary summary;
+		long long timepoint;
+
+		while (sidecar >> timepoint >> summary.count >> summary.earliest_alarmtime >> summary.latest_alarmtime) {
+			this->summaries[timepoint] = summary;
+		}
+
+		// a partially written index is never renamed into place, a malformed one is rebuilt
+		this->loaded = sidecar.eof();
+
+		if (!this->loaded) {
+			this->logger->log_message(Log::Warning, L"malformed alarm index: %s", path->Data());
+			this->summaries.clear();
+		}
+	}
+
+	return this->loaded;
+}
+
+bool AlarmHistoryIndex::ready() {
+	return this->loaded;
+}
+
+void AlarmHistoryIndex::record(long long file_timepoint, long long alarmtime_ms) {
+	std::unique_lock<std::mutex> lock(this->section);
+	auto it = this->summaries.find(file_timepoint);
+
+	if (it == this->summaries.end()) {
+		this->summaries[file_timepoint] = { 1LL, alarmtime_ms, alarmtime_ms };
+	} else {
+		it->second.count++;
+		it->second.earliest_alarmtime = std::min(it->second.earliest_alarmtime, alarmtime_ms);
+		it->second.latest_alarmtime = std::max(it->second.latest_alarmtime, alarmtime_ms);
+	}
+
+	this->dirty = true;
+}
+
+void AlarmHistoryIndex::summarize(long long file_timepoint, AlarmHistorySummary& summary) {
+	std::unique_lock<std::mutex> lock(this->section);
+
+	if (summary.count > 0LL) {
+		this->summaries[file_timepoint] = summary;
+	} else {
+		this->summaries.erase(file_timepoint);
+	}
+
+	this->dirty = true;
+}
+
+void AlarmHistoryIndex::flush() {
+	std::unique_lock<std::mutex> lock(this->section);
+
+	// an index that is not loaded yet is written even if it is empty, so that it becomes ready
+	if ((this->path != nullptr) && (this->dirty || (!this->loaded))) {
+		std::wstring tmp = std::wstring(this->path->Data()) + L".tmp";
+		std::ofstream sidecar(tmp, std::ios::trunc);
+		std::error_code ec;
+
+		for (auto it = this->summaries.begin(); it != this->summaries.end(); it++) {
+			sidecar << it->first << " " << it->second.count << " "
+				<< it->second.earliest_alarmtime << " " << it->second.latest_alarmtime << "\n";
+		}
+
+		sidecar.close();
+
+		if (!sidecar.fail()) {
+			std::filesystem::rename(tmp, std::filesystem::path(this->path->Data()), ec);
+		}
+
+		if (sidecar.fail() || ec) {
+			this->logger->log_message(Log::Warning, L"failed to update the alarm index: %s", this->path->Data());
+		} else {
+			this->loaded = true;
+			this->dirty = false;
+		}
+	}
+}
+
+bool AlarmHistoryIndex::seek(long long timepoint, bool asc, long long* file_timepoint) {
+	std::unique_lock<std::mutex> lock(this->section);
+	bool found = false;
+
+	if (asc) {
+		auto it = this->summaries.lower_bound(timepoint);
+
+		if (it != this->summaries.end()) {
+			(*file_timepoint) = it->first;
+			found = true;
+		}
+	} else {
+		auto it = this->summaries.upper_bound(timepoint);
+
+		if (it != this->summaries.begin()) {
+			it--;
+			(*file_timepoint) = it->first;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+bool AlarmHistoryIndex::lookup(long long file_timepoint, AlarmHistorySummary* summary) {
+	std::unique_lock<std::mutex> lock(this->section);
+	auto it = this->summaries.find(file_timepoint);
+	bool found = (it != this->summaries.end());
+
+	if (found) {
+		(*summary) = it->second;
+	}
+
+	return found;
+}
+
+long long AlarmHistoryIndex::total() {
+	std::unique_lock<std::mutex> lock(this->section);
+	long long count = 0LL;
+
+	for (auto it = this->summaries.begin(); it != this->summaries.end(); it++) {
+		count += it->second.count;
+	}
+
+	return count;
+}
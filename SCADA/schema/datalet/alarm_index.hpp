@@ -0,0 +1,53 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <atomic>
+
+#include "syslog.hpp"
+
+namespace WarGrey::SCADA {
+	private struct AlarmHistorySummary {
+		long long count;
+		long long earliest_alarmtime;
+		long long latest_alarmtime;
+	};
+
+	/** NOTE
+	 * The sidecar index summarizes rotated alarm files, one entry per file, keyed by the timepoint of the file.
+	 * It is updated after alarms are committed, so that the loader goes straight to the files that hold
+	 *   the latest alarms instead of probing every period backwards.
+	 *
+	 * The index is rewritten as a whole (it is small and alarms are rare), at most once per persistence batch,
+	 *   if it is missing or unreadable, it is rebuilt from the existing files.
+	 */
+	private class AlarmHistoryIndex {
+	public:
+		AlarmHistoryIndex(WarGrey::GYDM::Syslog* logger);
+
+	public:
+		bool open(Platform::String^ path);
+		bool ready();
+
+	public:
+		void record(long long file_timepoint, long long alarmtime_ms);
+		void summarize(long long file_timepoint, WarGrey::SCADA::AlarmHistorySummary& summary);
+		void flush();
+
+	public:
+		/**
+		 * finds the nearest indexed file at or before (`asc` is `false`) or at or after `timepoint`.
+		 */
+		bool seek(long long timepoint, bool asc, long long* file_timepoint);
+		bool lookup(long long file_timepoint, WarGrey::SCADA::AlarmHistorySummary* summary);
+		long long total();
+
+	private:
+		WarGrey::GYDM::Syslog* logger;
+		std::map<long long, WarGrey::SCADA::AlarmHistorySummary> summaries;
+		Platform::String^ path;
+		std::mutex section;
+		std::atomic<bool> loaded; // read by the loader without the lock
+		bool dirty;
+	};
+}
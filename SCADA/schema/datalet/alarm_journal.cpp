@@ -0,0 +1,351 @@
+#include <filesystem>
+#include <cstring>
+#include <io.h>
+
+#include "schema/datalet/alarm_journal.hpp"
+
+using namespace WarGrey::SCADA;
+using namespace WarGrey::GYDM;
+
+/*************************************************************************************************/
+static const unsigned char journal_alert = 'A';
+static const unsigned char journal_fix = 'F';
+
+static const unsigned char journal_has_type = 0b01;
+static const unsigned char journal_has_fixedtime = 0b10;
+
+#pragma pack(push, 1)
+private struct JournalRecord {
+	unsigned char event;
+	unsigned char flags;
+	unsigned char reserved[2];
+	long long uuid;
+	long long index;
+	long long type;
+	long long alarmtime;
+	long long fixedtime;
+	unsigned int checksum;
+};
+#pragma pack(pop)
+
+static unsigned int journal_crc32(const unsigned char* octets, size_t size) {
+	static unsigned int table[256];
+	static bool initialized = false;
+	unsigned int crc = 0xFFFFFFFFU;
+
+	if (!initialized) {
+		for (unsigned int n = 0; n < 256; n++) {
+			unsigned int c = n;
+
+			for (unsigned int k = 0; k < 8; k++) {
+				c = ((c & 1U) ? (0xEDB88320U ^ (c >> 1)) : (c >> 1));
+			}
+
+			table[n] = c;
+		}
+
+		initialized = true;
+	}
+
+	for (size_t i = 0; i < size; i++) {
+		crc = table[(crc ^ octets[i]) & 0xFFU] ^ (crc >> 8);
+	}
+
+	return crc ^ 0xFFFFFFFFU;
+}
+
+static unsigned int journal_record_checksum(JournalRecord& record) {
+	return journal_crc32(reinterpret_cast<const unsigned char*>(&record), sizeof(JournalRecord) - sizeof(unsigned int));
+}
+
+static void journal_record_from_alarm(JournalRecord& record, unsigned char event, Alarm& alarm) {
+	memset(&record, 0, sizeof(JournalRecord));
+
+	record.event = event;
+	record.uuid = alarm.uuid;
+	record.index = alarm.index;
+	record.alarmtime = alarm.alarmtime;
+
+	if (alarm.type.has_value()) {
+		record.flags |= journal_has_type;
+		record.type = alarm.type.value();
+	}
+
+	if (alarm.fixedtime.has_value()) {
+		record.flags |= journal_has_fixedtime;
+		record.fixedtime = alarm.fixedtime.value();
+	}
+
+	record.checksum = journal_record_checksum(record);
+}
+
+static void journal_record_to_alarm(JournalRecord& record, Alarm& alarm) {
+	alarm.uuid = record.uuid;
+	alarm.index = record.index;
+	alarm.alarmtime = record.alarmtime;
+	alarm.type = (((record.flags & journal_has_type) != 0) ? std::optional<Integer>(record.type) : std::nullopt);
+	alarm.fixedtime = (((record.flags & journal_has_fixedtime) != 0) ? std::optional<Integer>(record.fixedtime) : std::nullopt);
+}
+
+static bool journal_write(FILE* journal, JournalRecord& record) {
+	return (fwrite(&record, sizeof(JournalRecord), 1, journal) == 1);
+}
+
+static bool journal_commit(FILE* journal) {
+	// records are not taken as saved until they reach the disk
+	return ((fflush(journal) == 0) && (_commit(_fileno(journal)) == 0));
+}
+
+/*************************************************************************************************/
+AlarmJournal::AlarmJournal(Syslog* logger)
+	: logger(logger), journal(nullptr), queued(0ULL), durable(0ULL), unavailable(false), healthy(true), terminated(false) {}
+
+AlarmJournal::~AlarmJournal() {
+	{ std::unique_lock<std::mutex> lock(this->section);
+		this->terminated = true;
+	}
+
+	this->available.notify_one();
+
+	if (this->writer.joinable()) { // queued records are committed before exiting
+		this->writer.join();
+	}
+
+	if (this->journal != nullptr) {
+		fclose(this->journal);
+	}
+}
+
+bool AlarmJournal::open(Platform::String^ path) {
+	std::unique_lock<std::mutex> lock(this->section);
+
+	if (this->journal == nullptr) {
+		unsigned long long intact_size = this->replay(path);
+		bool compacted = this->compact(path);
+
+		if (compacted) {
+			this->journal = _wfopen(path->Data(), L"ab");
+		} else {
+			this->journal = this->reopen(path, intact_size);
+		}
+
+		this->unavailable = (this->journal == nullptr);
+
+		if (this->unavailable) {
+			this->logger->log_message(Log::Error, L"failed to open the alarm journal: %s", path->Data());
+		} else {
+			if (!compacted) {
+				// alarms raised before opening are not in the file, alerting ones are journaled again, which is idempotent
+				for (auto it = this->alerting.begin(); it != this->alerting.end(); it++) {
+					this->pending.push_back(std::pair<unsigned char, Alarm>(journal_alert, it->second));
+					this->queued += 1U;
+				}
+			}
+
+			this->writer = std::thread([this]() { this->run(); });
+
+			this->logger->log_message(Log::Info, L"alarm journal: %s, %u alarm(s) alerting",
+				path->Data(), (unsigned int)(this->alerting.size()));
+		}
+	}
+
+	return (this->journal != nullptr);
+}
+
+bool AlarmJournal::opened() {
+	return (this->journal != nullptr);
+}
+
+bool AlarmJournal::alert(Alarm& alarm, bool durable) {
+	std::unique_lock<std::mutex> lock(this->section);
+
+	this->alerting[alarm.index] = alarm;
+
+	return this->append(journal_alert, alarm, durable, lock);
+}
+
+bool AlarmJournal::fix(Alarm& alerting_alarm, bool durable) {
+	std::unique_lock<std::mutex> lock(this->section);
+
+	this->alerting.erase(alerting_alarm.index);
+
+	return this->append(journal_fix, alerting_alarm, durable, lock);
+}
+
+void AlarmJournal::sync() {
+	std::unique_lock<std::mutex> lock(this->section);
+	unsigned long long sequence = this->queued;
+
+	if (this->writer.joinable()) {
+		this->committed.wait(lock, [=]() { return (this->durable >= sequence); });
+	}
+}
+
+void AlarmJournal::foreach_alerting(IAlarmCursor* cursor) {
+	std::unique_lock<std::mutex> lock(this->section);
+
+	for (auto it = this->alerting.begin(); it != this->alerting.end(); it++) {
+		if (!cursor->step(it->second, true, 0)) break;
+	}
+}
+
+size_t AlarmJournal::alerting_count() {
+	std::unique_lock<std::mutex> lock(this->section);
+
+	return this->alerting.size();
+}
+
+/*************************************************************************************************/
+unsigned long long AlarmJournal::replay(Platform::String^ path) {
+	FILE* journal = _wfopen(path->Data(), L"rb");
+	unsigned long long intact_size = 0ULL;
+
+	if (journal != nullptr) {
+		unsigned long long count = 0ULL;
+		JournalRecord record;
+		Alarm alarm;
+
+		while (fread(&record, sizeof(JournalRecord), 1, journal) == 1) {
+			if (record.checksum != journal_record_checksum(record)) {
+				this->logger->log_message(Log::Warning, L"alarm journal is corrupted after %llu record(s), the rest is discarded", count);
+				break;
+			}
+
+			journal_record_to_alarm(record, alarm);
+
+			if (record.event == journal_alert) {
+				this->alerting[alarm.index] = alarm;
+			} else {
+				this->alerting.erase(alarm.index);
+			}
+
+			count++;
+		}
+
+		fclose(journal);
+		intact_size = count * sizeof(JournalRecord);
+	}
+
+	return intact_size;
+}
+
+bool AlarmJournal::compact(Platform::String^ path) {
+	std::wstring tmp = std::wstring(path->Data()) + L".tmp";
+	FILE* journal = _wfopen(tmp.c_str(), L"wb");
+	bool okay = (journal != nullptr);
+
+	if (okay) {
+		JournalRecord record;
+
+		for (auto it = this->alerting.begin(); okay && (it != this->alerting.end()); it++) {
+			journal_record_from_alarm(record, journal_alert, it->second);
+			okay = journal_write(journal, record);
+		}
+
+		okay = (okay && journal_commit(journal));
+
+		fclose(journal);
+
+		if (okay) {
+			std::error_code ec;
+
+			std::filesystem::rename(tmp, std::filesystem::path(path->Data()), ec);
+			okay = !ec;
+		}
+	}
+
+	if (!okay) {
+		this->logger->log_message(Log::Warning, L"failed to compact the alarm journal: %s", path->Data());
+	}
+
+	return okay;
+}
+
+FILE* AlarmJournal::reopen(Platform::String^ path, unsigned long long intact_size) {
+	std::filesystem::path journal_path(path->Data());
+	FILE* journal = nullptr;
+	std::error_code ec;
+
+	// records appended after a torn record would never be replayed
+	if (std::filesystem::exists(journal_path, ec) && (std::filesystem::file_size(journal_path, ec) > intact_size)) {
+		std::filesystem::resize_file(journal_path, intact_size, ec);
+	}
+
+	if (ec) {
+		this->logger->log_message(Log::Error, L"failed to cut off the torn tail of the alarm journal: %s", path->Data());
+	} else {
+		journal = _wfopen(path->Data(), L"ab");
+
+		if (journal != nullptr) {
+			this->logger->log_message(Log::Warning, L"the alarm journal is appended without compacting: %s", path->Data());
+		}
+	}
+
+	return journal;
+}
+
+bool AlarmJournal::append(unsigned char event, Alarm& alarm, bool durable, std::unique_lock<std::mutex>& lock) {
+	bool okay = true;
+
+	// alarms raised before opening are only in memory, they will be written when the journal is opened
+	if (this->writer.joinable()) {
+		unsigned long long sequence = ++this->queued;
+
+		this->pending.push_back(std::pair<unsigned char, Alarm>(event, alarm));
+		this->available.notify_one();
+
+		if (durable) {
+			this->committed.wait(lock, [=]() { return (this->durable >= sequence); });
+			okay = this->healthy;
+		}
+	} else if (this->unavailable) {
+		this->logger->log_message(Log::Error, L"the alarm journal is unavailable, dropped the %s record of alarm %lld",
+			((event == journal_alert) ? L"alert" : L"fix"), alarm.index);
+		okay = false;
+	}
+
+	return okay;
+}
+
+void AlarmJournal::run() {
+	std::deque<std::pair<unsigned char, Alarm>> group;
+	JournalRecord record;
+	unsigned long long sequence = 0ULL;
+	bool terminated = false;
+
+	while (!terminated) {
+		bool okay = true;
+
+		{ std::unique_lock<std::mutex> lock(this->section);
+			this->available.wait(lock, [this]() { return (this->terminated || (!this->pending.empty())); });
+
+			group.swap(this->pending);
+			sequence = this->queued;
+			terminated = (this->terminated && group.empty());
+		}
+
+		if (!group.empty()) {
+			for (auto it = group.begin(); okay && (it != group.end()); it++) {
+				journal_record_from_alarm(record, it->first, it->second);
+				okay = journal_write(this->journal, record);
+			}
+
+			// records queued in the meantime share the same commit next time
+			okay = (okay && journal_commit(this->journal));
+
+			if (!okay) {
+				this->logger->log_message(Log::Error, L"failed to journal %u alarm(s)", (unsigned int)(group.size()));
+			}
+
+			group.clear();
+		}
+
+		{ std::unique_lock<std::mutex> lock(this->section);
+			// callers are released even if the commit fails, the failure is logged and reported to durable callers
+			this->durable = sequence;
+			this->healthy = okay;
+		}
+
+		this->committed.notify_all();
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <map>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>
+
+#include "schema/alarm.hpp"
+
+#include "syslog.hpp"
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * The journal is the source of truth of alerting alarms, every transition is appended as a fixed-size,
+	 *   checksummed record by a writer thread, which commits all records queued since its last commit at once,
+	 *   so that the PLC thread never waits for the disk.
+	 * `alert()` and `fix()` return once the record is queued, unless `durable` is requested,
+	 *   in which case they return after the record reaches the disk, so does `sync()` for all queued records.
+	 *
+	 * On opening, records are replayed until the end or the first torn (or corrupted) record,
+	 *   then the journal is rewritten with alerting alarms only, so that its size is bounded
+	 *   by the number of transitions since the last startup.
+	 * If the rewriting fails, the torn tail is cut off and the existing journal is appended instead.
+	 *
+	 * `alert()` and `fix()` return `false` if the record is not journaled, either because the journal is unavailable,
+	 *   in which case every dropped record is logged, or because the durable commit fails.
+	 * Records before opening are not dropped, they are in memory and written by the rewriting.
+	 */
+	private class AlarmJournal {
+	public:
+		AlarmJournal(WarGrey::GYDM::Syslog* logger);
+		~AlarmJournal() noexcept;
+
+	public:
+		bool open(Platform::String^ path);
+		bool opened();
+
+	public:
+		bool alert(WarGrey::SCADA::Alarm& alarm, bool durable = false);
+		bool fix(WarGrey::SCADA::Alarm& alerting_alarm, bool durable = false);
+		void sync();
+
+	public:
+		void foreach_alerting(WarGrey::SCADA::IAlarmCursor* cursor);
+		size_t alerting_count();
+
+	private:
+		unsigned long long replay(Platform::String^ path);
+		bool compact(Platform::String^ path);
+		FILE* reopen(Platform::String^ path, unsigned long long intact_size);
+		bool append(unsigned char event, WarGrey::SCADA::Alarm& alarm, bool durable, std::unique_lock<std::mutex>& lock);
+		void run();
+
+	private:
+		WarGrey::GYDM::Syslog* logger;
+		std::map<long long, WarGrey::SCADA::Alarm> alerting;
+		std::deque<std::pair<unsigned char, WarGrey::SCADA::Alarm>> pending;
+		std::mutex section;
+		std::condition_variable available;
+		std::condition_variable committed;
+		std::thread writer;
+		FILE* journal;
+		unsigned long long queued;
+		unsigned long long durable;
+		bool unavailable; // failed to open
+		bool healthy;     // the latest commit succeeded
+		bool terminated;
+	};
+}
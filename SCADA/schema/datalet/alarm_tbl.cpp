@@ -1,5 +1,11 @@
-﻿#include "schema/datalet/alarm_tbl.hpp"
+﻿#include <filesystem>
+#include <algorithm>
+#include <vector>
+
+#include "schema/datalet/alarm_tbl.hpp"
 #include "stone/tongue/alarm.hpp"
+#include "configuration.hpp"
+#include "durability.hpp"
 #include "dbmisc.hpp"
 
 using namespace WarGrey::SCADA;
@@ -15,11 +21,6 @@ using namespace Microsoft::Graphics::Canvas::Brushes;
 
 #define IS_Alert(salt) (((salt >> 62U) & 0b1) == 0b1)
 
-static int alarm_busy_handler(void* args, int count) {
-	// keep trying until it works
-	return 1;
-}
-
 /*************************************************************************************************/
 float WarGrey::SCADA::alarm_column_width_configure(unsigned int idx, unsigned int total) {
 	float percentage = 1.0F / float(total);
@@ -94,6 +95,11 @@ unsigned int WarGrey::SCADA::alarm_index_to_code(unsigned int index) {
 }
 
 /*************************************************************************************************/
+static void alarm_prepare(IDBSystem* dbc) {
+	apply_durability(dbc, DurabilityProfile::Journal);
+	create_alarm(dbc, true);
+}
+
 private class AlarmCursor : public IAlarmCursor {
 public:
 	AlarmCursor(ITableDataReceiver* receiver, long long request_count, long long loaded_count)
@@ -122,20 +128,107 @@ private:
 	long long request_count;
 };
 
+private class AlarmExporter : public IAlarmCursor {
+public:
+	AlarmExporter(IHistoryExportSink* sink, long long open_ms, long long close_ms)
+		: sink(sink), open_timepoint(open_ms), close_timepoint(close_ms) {}
+
+public:
+	bool step(Alarm& alarm, bool asc, int code) override {
+		long long ts = alarm.alarmtime;
+		bool go_on = true;
+
+		if ((ts >= this->open_timepoint) && (ts <= this->close_timepoint)) {
+			this->tempdata[0] = double(alarm_index_to_code((unsigned int)alarm.index));
+			this->tempdata[1] = double(alarm.type.value_or(1000LL));
+			this->tempdata[2] = double(alarm.fixedtime.value_or(0LL));
+
+			go_on = this->sink->push(ts, this->tempdata);
+		}
+
+		return go_on && (ts <= this->close_timepoint);
+	}
+
+private:
+	double tempdata[3];
+	IHistoryExportSink* sink;
+	long long open_timepoint;
+	long long close_timepoint;
+};
+
+private class AlarmJournalImporter : public IAlarmCursor {
+public:
+	AlarmJournalImporter(AlarmJournal* journal) : journal(journal), count(0U) {}
+
+public:
+	bool step(Alarm& alarm, bool asc, int code) override {
+		this->journal->alert(alarm);
+		this->count++;
+
+		return true;
+	}
+
+public:
+	unsigned int count;
+
+private:
+	AlarmJournal* journal;
+};
+
+private class AlarmReplayer : public IAlarmCursor {
+public:
+	AlarmReplayer(AlarmAnalytics* analytics) : analytics(analytics), count(0U) {}
+
+public:
+	bool step(Alarm& alarm, bool asc, int code) override {
+		if (alarm.fixedtime != alarm.alarmtime) { // responses are not occurrences
+			unsigned int alarm_code = alarm_index_to_code((unsigned int)alarm.index);
+
+			this->analytics->alert(alarm_code, alarm);
+
+			if (alarm.fixedtime.value_or(0LL) > 0LL) {
+				this->analytics->fix(alarm_code, alarm);
+			}
+
+			this->count++;
+		}
+
+		return true;
+	}
+
+public:
+	unsigned int count;
+
+private:
+	AlarmAnalytics* analytics;
+};
+
 /*************************************************************************************************/
 AlarmDataSource::AlarmDataSource(IAlarmCursor* cursor, Syslog* logger, RotationPeriod period, unsigned int period_count, unsigned int search_max)
-	: RotativeSQLite3("alarm", logger, period, period_count), alerts_cursor(cursor), search_file_count_max(search_max), request_count(0LL) {}
+	: RotativeSQLite3("alarm", logger, period, period_count), alerts_cursor(cursor), search_file_count_max(search_max), request_count(0LL) {
+	this->journal = new AlarmJournal(this->get_logger());
+	this->index = new AlarmHistoryIndex(this->get_logger());
+	this->statistics = new AlarmAnalytics();
+	this->persistence = new PersistenceQueue(this->get_logger(), PersistencePolicy::Lossless,
+		persistence_queue_capacity, persistence_batch_size, alarm_prepare,
+		[this]() { this->index->flush(); });
+}
 
 AlarmDataSource::~AlarmDataSource() {
 	this->cancel();
 
+	delete this->persistence; // pending alarms are written into their history files before closing
+	delete this->journal;
+	delete this->index;
+	delete this->statistics;
+
 	if (this->dbc != nullptr) {
 		delete this->dbc;
 	}
+}
 
-	if (this->alerts_dbc != nullptr) {
-		delete this->alerts_dbc;
-	}
+AlarmAnalytics* AlarmDataSource::analytics() {
+	return this->statistics;
 }
 
 bool AlarmDataSource::ready() {
@@ -153,19 +246,44 @@ void AlarmDataSource::cancel() {
 }
 
 void AlarmDataSource::on_folder_ready(StorageFolder^ root, bool newly_created) {
-	this->alerts_dbc = new SQLite3((root->Path + "/alerts.db")->Data(), this->get_logger());
-	this->alerts_dbc->set_busy_handler(alarm_busy_handler);
+	Platform::String^ journal_path = root->Path + "/alarms.journal";
+	Platform::String^ legacy_path = root->Path + "/alerts.db";
+	std::error_code ec;
+	bool migrating = !std::filesystem::exists(std::filesystem::path(journal_path->Data()), ec);
+
+	if (this->journal->open(journal_path)) {
+		if (migrating && std::filesystem::exists(std::filesystem::path(legacy_path->Data()), ec)) {
+			// alerts.db is no longer written, unfixed alarms in it are imported once and it is kept as is
+			ISQLite3* alerts_dbc = new SQLite3(legacy_path->Data(), this->get_logger());
+			AlarmJournalImporter importer(this->journal);
+
+			alerts_dbc->set_busy_handler(durability_busy_handler);
+			foreach_alarm(alerts_dbc, &importer);
+			this->journal->sync(); // the import is committed at once rather than alarm by alarm
+			delete alerts_dbc;
+
+			this->get_logger()->log_message(Log::Notice, L"imported %u unfixed alarm(s) from %s",
+				importer.count, legacy_path->Data());
+		}
+	}
+
+	this->journal->foreach_alerting(this->alerts_cursor);
 
-	create_alarm(this->alerts_dbc, true);
-	this->get_logger()->log_message(Log::Info, L"unfixed alarms file: %S", this->alerts_dbc->filename().c_str());
+	if ((!this->index->open(root->Path + "/alarms.index")) || (!this->do_checking_index())) {
+		this->do_reindexing();
+	}
 
-	foreach_alarm(this->alerts_dbc, this->alerts_cursor);
+	this->do_replaying_analytics();
 }
 
 void AlarmDataSource::on_database_rotated(SQLite3* prev_dbc, SQLite3* dbc, long long timepoint) {
 	// TODO: move the temporary data from in-memory SQLite3 into the current SQLite3 if necessary
 
-	create_alarm(dbc, true);
+	if (prev_dbc != nullptr) {
+		checkpoint_durability(prev_dbc);
+	}
+
+	alarm_prepare(dbc);
 	this->get_logger()->log_message(Log::Debug, L"current file: %S", dbc->filename().c_str());
 }
 
@@ -176,8 +294,21 @@ void AlarmDataSource::save(long long timepoint_ms, unsigned int index, Alarm& al
 	alarm.alarmtime = timepoint_ms;
 	alarm.fixedtime = 0LL;
 
-	insert_alarm(this->alerts_dbc, alarm);
-	insert_alarm(this, alarm);
+	// the journal commits the alarm in the background as soon as possible, so does the history file
+	this->journal->alert(alarm);
+
+	{ // write the history
+		Alarm alert = alarm;
+		Platform::String^ dbpath = this->resolve_pathname(timepoint_ms / 1000LL);
+		long long file_timepoint = this->resolve_timepoint(timepoint_ms / 1000LL);
+
+		this->persistence->push(dbpath, [=](IDBSystem* dbc) mutable {
+			insert_alarm(dbc, alert);
+		}, [=]() mutable {
+			this->do_indexing(file_timepoint, alert.alarmtime);
+			this->statistics->alert(alarm_index_to_code((unsigned int)alert.index), alert);
+		});
+	}
 }
 
 void AlarmDataSource::save(long long timepoint_ms, Alarm& alerting_alarm, Alarm& alarm) { // response
@@ -187,19 +318,49 @@ void AlarmDataSource::save(long long timepoint_ms, Alarm& alerting_alarm, Alarm&
 	alarm.alarmtime = timepoint_ms;
 	alarm.fixedtime = timepoint_ms;
 
-	insert_alarm(this, alarm);
+	alerting_alarm.fixedtime = timepoint_ms;
+	this->journal->fix(alerting_alarm);
 
-	{ // update alarm state
-		ISQLite3* target = new SQLite3(this->resolve_pathname(alerting_alarm.alarmtime / 1000LL)->Data(), this->get_logger());
-		Alarm_pk pk = alarm_identity(alerting_alarm); // TODO: why cannot do `delete_alarm(dbc, alarm_identity(a))` directly?
+	{ // update the history
+		Alarm response = alarm;
+		Alarm fixed = alerting_alarm;
+		Platform::String^ dbpath = this->resolve_pathname(timepoint_ms / 1000LL);
+		Platform::String^ target_path = this->resolve_pathname(alerting_alarm.alarmtime / 1000LL);
+		long long file_timepoint = this->resolve_timepoint(timepoint_ms / 1000LL);
 
-		alerting_alarm.fixedtime = timepoint_ms;
+		this->persistence->push(dbpath, [=](IDBSystem* dbc) mutable {
+			insert_alarm(dbc, response);
+		}, [=]() {
+			this->do_indexing(file_timepoint, response.alarmtime);
+		});
 
-		update_alarm(target, alerting_alarm);
-		delete_alarm(this->alerts_dbc, pk);
+		// the alerting alarm is in the file of its own period, which might have rotated out
+		this->persistence->push(target_path, [=](IDBSystem* target) mutable {
+			update_alarm(target, fixed);
+		}, [=]() mutable {
+			this->statistics->fix(alarm_index_to_code((unsigned int)fixed.index), fixed);
+		});
+	}
+}
 
-		delete target;
+task<unsigned long long> AlarmDataSource::export_async(Platform::String^ filename, long long open_s, long long close_s
+	, HistoryExportFormat format, cancellation_token token) {
+	std::vector<std::string> columns = { "code", "type", "fixedtime" };
+	std::vector<Platform::String^> sources;
+	long long end = this->resolve_timepoint(std::max(open_s, close_s));
+
+	for (long long ts = this->resolve_timepoint(std::min(open_s, close_s)); ts <= end; ts += this->span_seconds()) {
+		sources.push_back(this->resolve_pathname(ts));
 	}
+
+	// alarms are events, they are never aggregated
+	return history_export_async(filename, format, columns, sources,
+		std::min(open_s, close_s) * 1000LL, std::max(open_s, close_s) * 1000LL, 0LL,
+		[](IDBSystem* dbc, long long open_ms, long long close_ms, IHistoryExportSink* sink) {
+			AlarmExporter exporter(sink, open_ms, close_ms);
+
+			foreach_alarm(dbc, &exporter, 0, 0, alarm::alarmtime, true);
+		}, token, this->get_logger());
 }
 
 void AlarmDataSource::load(ITableDataReceiver* receiver, long long request_count) {
@@ -218,8 +379,14 @@ void AlarmDataSource::load(ITableDataReceiver* receiver, long long request_count
 void AlarmDataSource::do_loading_async(ITableDataReceiver* receiver, long long start, long long interval
 	, unsigned int actual_file_count, unsigned int search_file_count, long long total, double span_ms) {
 	bool asc = (interval > 0);
+	bool indexed = this->index->ready();
+	bool exhausted = false;
+
+	if (indexed) { // jump to the nearest file that has alarms, periods without alarms are not probed
+		exhausted = !this->index->seek(start, asc, &start);
+	}
 
-	if ((total >= this->request_count) || (search_file_count > this->search_file_count_max)) {
+	if (exhausted || (total >= this->request_count) || (search_file_count > this->search_file_count_max)) {
 		double span_total = current_inexact_milliseconds() - this->time0;
 
 		this->get_logger()->log_message(Log::Debug, L"loaded %d records from %d file(s) within %lfms(wasted: %lfms)",
@@ -230,31 +397,19 @@ void AlarmDataSource::do_loading_async(ITableDataReceiver* receiver, long long s
 	} else {
 		Platform::String^ dbsource = this->resolve_filename(start);
 		cancellation_token token = this->watcher.get_token();
+		long long next_timepoint = start + interval;
 
+		// with the index, `start` is already the file that has alarms, the receiver is fed in the same context anyway
 		create_task(this->rootdir()->TryGetItemAsync(dbsource), token).then([=](task<IStorageItem^> getting) {
 			IStorageItem^ db = getting.get();
-			long long next_timepoint = start + interval;
 
 			if ((db != nullptr) && (db->IsOfType(StorageItemTypes::File))) {
-				AlarmCursor acursor(receiver, this->request_count, total);
 				double ms = current_inexact_milliseconds();
-				
-				this->dbc = new SQLite3(db->Path->Data(), this->get_logger());
-				this->dbc->set_busy_handler(alarm_busy_handler);
-
-				receiver->begin_maniplation_sequence();
-				foreach_alarm(this->dbc, &acursor, this->request_count - total, 0, alarm::alarmtime, asc);
-				receiver->end_maniplation_sequence();
-
-				delete this->dbc;
-				this->dbc = nullptr;
+				long long loaded_count = this->do_loading_file(receiver, db->Path, asc, total);
 
 				ms = current_inexact_milliseconds() - ms;
-				this->get_logger()->log_message(Log::Debug, L"loaded %d record(s) from[%s] within %lfms",
-					acursor.loaded_count - total, dbsource->Data(), ms);
-
 				this->do_loading_async(receiver, next_timepoint, interval,
-					actual_file_count + 1U, search_file_count + 1U, acursor.loaded_count, span_ms + ms);
+					actual_file_count + 1U, search_file_count + 1U, loaded_count, span_ms + ms);
 			} else {
 				this->get_logger()->log_message(Log::Debug, L"skip non-existent source[%s]", dbsource->Data());
 				this->do_loading_async(receiver, next_timepoint, interval,
@@ -269,3 +424,119 @@ void AlarmDataSource::do_loading_async(ITableDataReceiver* receiver, long long s
 		});
 	}
 }
+
+long long AlarmDataSource::do_loading_file(ITableDataReceiver* receiver, Platform::String^ dbpath, bool asc, long long total) {
+	AlarmCursor acursor(receiver, this->request_count, total);
+	double ms = current_inexact_milliseconds();
+
+	this->dbc = new SQLite3(dbpath->Data(), this->get_logger());
+	this->dbc->set_busy_handler(durability_busy_handler);
+	apply_durability(this->dbc, DurabilityProfile::Reader);
+
+	receiver->begin_maniplation_sequence();
+	foreach_alarm(this->dbc, &acursor, this->request_count - total, 0, alarm::alarmtime, asc);
+	receiver->end_maniplation_sequence();
+
+	delete this->dbc;
+	this->dbc = nullptr;
+
+	ms = current_inexact_milliseconds() - ms;
+	this->get_logger()->log_message(Log::Debug, L"loaded %d record(s) from[%s] within %lfms",
+		acursor.loaded_count - total, dbpath->Data(), ms);
+
+	return acursor.loaded_count;
+}
+
+/*************************************************************************************************/
+void AlarmDataSource::do_indexing(long long file_timepoint, long long alarmtime_ms) {
+	// the index is flushed once the batch is committed
+	this->index->record(file_timepoint, alarmtime_ms);
+}
+
+bool AlarmDataSource::do_checking_index() {
+	long long timepoint = this->resolve_timepoint(current_seconds());
+	Platform::String^ dbpath = this->resolve_pathname(timepoint);
+	AlarmHistorySummary summary;
+	long long indexed_count = 0LL;
+	long long count = 0LL;
+	std::error_code ec;
+
+	/** NOTE
+	 * Alarms are indexed after they are written into the current file,
+	 *   the index falls behind if the application stops in between, and it only happens to the current file.
+	 */
+	if (std::filesystem::exists(std::filesystem::path(dbpath->Data()), ec)) {
+		ISQLite3* target = new SQLite3(dbpath->Data(), this->get_logger());
+
+		target->set_busy_handler(durability_busy_handler);
+		count = alarm_count(target);
+		delete target;
+	}
+
+	if (this->index->lookup(timepoint, &summary)) {
+		indexed_count = summary.count;
+	}
+
+	if (count != indexed_count) {
+		this->get_logger()->log_message(Log::Notice, L"the alarm index is stale: %lld record(s) indexed, but %lld in %s",
+			indexed_count, count, dbpath->Data());
+	}
+
+	return (count == indexed_count);
+}
+
+void AlarmDataSource::do_reindexing() {
+	long long timepoint = this->resolve_timepoint(current_seconds());
+	double ms = current_inexact_milliseconds();
+	std::error_code ec;
+
+	for (unsigned int i = 0; i <= this->search_file_count_max; i++, timepoint -= this->span_seconds()) {
+		Platform::String^ dbpath = this->resolve_pathname(timepoint);
+
+		if (std::filesystem::exists(std::filesystem::path(dbpath->Data()), ec)) {
+			ISQLite3* target = new SQLite3(dbpath->Data(), this->get_logger());
+			AlarmHistorySummary summary;
+
+			target->set_busy_handler(durability_busy_handler);
+			summary.count = alarm_count(target);
+			summary.earliest_alarmtime = (long long)(alarm_min(target, alarm::alarmtime).value_or(0.0));
+			summary.latest_alarmtime = (long long)(alarm_max(target, alarm::alarmtime).value_or(0.0));
+			this->index->summarize(timepoint, summary);
+
+			delete target;
+		}
+	}
+
+	this->index->flush();
+	this->get_logger()->log_message(Log::Info, L"rebuilt the alarm index with %lld record(s) within %lfms",
+		this->index->total(), current_inexact_milliseconds() - ms);
+}
+
+void AlarmDataSource::do_replaying_analytics() {
+	/** NOTE
+	 * Analytics are fed by the persistence queue after alarms are committed,
+	 *   so the replaying runs in the queue as well, it sees exactly the alarms committed before it,
+	 *   and the ones queued after it are fed as usual.
+	 */
+	this->persistence->push(nullptr, [=](IDBSystem* none) {
+		long long timepoint = this->resolve_timepoint(current_seconds());
+		long long horizon = timepoint - 31LL * 86400LL;
+		AlarmReplayer replayer(this->statistics);
+		double ms = current_inexact_milliseconds();
+
+		this->statistics->reset();
+
+		while ((timepoint >= horizon) && this->index->seek(timepoint, false, &timepoint)) {
+			ISQLite3* target = new SQLite3(this->resolve_pathname(timepoint)->Data(), this->get_logger());
+
+			target->set_busy_handler(durability_busy_handler);
+			foreach_alarm(target, &replayer, 0, 0, alarm::alarmtime, true);
+			delete target;
+
+			timepoint -= this->span_seconds();
+		}
+
+		this->get_logger()->log_message(Log::Info, L"replayed %u alarm(s) for analytics within %lfms",
+			replayer.count, current_inexact_milliseconds() - ms);
+	});
+}
@@ -4,11 +4,17 @@
 #include <map>
 
 #include "schema/alarm.hpp"
+#include "schema/datalet/alarm_journal.hpp"
+#include "schema/datalet/alarm_index.hpp"
+#include "schema/datalet/alarm_analytics.hpp"
 
 #include "graphlet/ui/tablet.hpp"
 
 #include "sqlite3/rotation.hpp"
 
+#include "persistence.hpp"
+#include "export.hpp"
+
 namespace WarGrey::SCADA {
 	private enum class AMS { Code, Event, Type, AlarmTime, FixedTime, _ };
 
@@ -34,6 +40,13 @@ namespace WarGrey::SCADA {
 		void save(long long timepoint_ms, unsigned int index, WarGrey::SCADA::Alarm& alarm);
 		void save(long long timepoint_ms, WarGrey::SCADA::Alarm& alerting_alarm, WarGrey::SCADA::Alarm& alarm);
 
+	public:
+		Concurrency::task<unsigned long long> export_async(Platform::String^ filename, long long open_s, long long close_s,
+			WarGrey::SCADA::HistoryExportFormat format, Concurrency::cancellation_token token);
+
+	public:
+		WarGrey::SCADA::AlarmAnalytics* analytics();
+
 	public:
 		bool ready() override;
 		bool loading() override;
@@ -53,6 +66,12 @@ namespace WarGrey::SCADA {
 		void do_loading_async(WarGrey::SCADA::ITableDataReceiver* receiver, long long start, long long interval,
 			unsigned int actual_file_count, unsigned int search_file_count, long long total, double span_ms);
 
+		long long do_loading_file(WarGrey::SCADA::ITableDataReceiver* receiver, Platform::String^ dbpath, bool asc, long long total);
+		void do_indexing(long long file_timepoint, long long alarmtime_ms);
+		void do_reindexing();
+		bool do_checking_index();
+		void do_replaying_analytics();
+
 	private:
 		Concurrency::cancellation_token_source watcher;
 		WarGrey::SCADA::ISQLite3* dbc;
@@ -61,7 +80,12 @@ namespace WarGrey::SCADA {
 		double time0;
 
 	private:
-		WarGrey::SCADA::ISQLite3* alerts_dbc;
+		WarGrey::SCADA::AlarmJournal* journal;
+		WarGrey::SCADA::AlarmHistoryIndex* index;
+		WarGrey::SCADA::AlarmAnalytics* statistics;
 		WarGrey::SCADA::IAlarmCursor* alerts_cursor; // managed by itself
+
+	private:
+		WarGrey::SCADA::PersistenceQueue* persistence;
 	};
 }
@@ -1,5 +1,12 @@
-﻿#include "schema/datalet/earthwork_ts.hpp"
+﻿#include <algorithm>
+#include <vector>
+
+#include "schema/datalet/earthwork_ts.hpp"
 #include "schema/earthwork.hpp"
+#include "configuration.hpp"
+#include "durability.hpp"
+#include "archive.hpp"
+#include "resultset.hpp"
 #include "dbmisc.hpp"
 
 using namespace WarGrey::SCADA;
@@ -28,6 +35,18 @@ CanvasSolidColorBrush^ WarGrey::SCADA::earthwork_line_color_dictionary(unsigned
 	return color;
 }
 
+struct WarGrey::SCADA::EarthWorkBatch {
+	Platform::String^ source;
+	std::vector<EarthWork> records;
+	long long timepoint;
+	long long open_ms;  // the range of this batch, which is narrowed past the previous batch of the same file
+	long long close_ms;
+	bool resumed;       // the batch continues the previous batch of the same file
+	bool exists;
+	bool more; // the file has records after this batch
+	double span_ms;
+};
+
 private class EarthWorkCursor : public IEarthWorkCursor {
 public:
 	EarthWorkCursor(ITimeSeriesDataReceiver* receiver, long long open_s, long long close_s) : receiver(receiver), open_s(open_s) {
@@ -60,7 +79,7 @@ public:
 	}
 
 public:
-	unsigned int count;
+	unsigned int count = 0U;
 
 private:
 	double tempdata[_N(EWTS)];
@@ -70,21 +89,152 @@ private:
 	long long open_s;
 };
 
-static int earthwork_busy_handler(void* args, int count) {
-	// keep trying until it works
-	return 1;
+private class EarthWorkCollector : public IEarthWorkCursor {
+public:
+	EarthWorkCollector(EarthWorkBatch* batch, long long open_ms, long long close_ms, size_t limit = 0U)
+		: batch(batch), open_timepoint(open_ms), close_timepoint(close_ms), limit(limit) {}
+
+public:
+	bool step(EarthWork& ework, bool asc, int code) override {
+		long long ts = ework.timestamp;
+		bool go_on = (asc ? (ts <= this->close_timepoint) : (ts >= this->open_timepoint));
+
+		if ((ts >= this->open_timepoint) && (ts <= this->close_timepoint)) {
+			this->batch->records.push_back(ework);
+		}
+
+		if (!go_on) {
+			this->exhausted = true;
+		} else if ((this->limit > 0U) && (this->batch->records.size() >= this->limit)) {
+			go_on = false;
+		}
+
+		return go_on;
+	}
+
+public:
+	bool exhausted = false;
+
+private:
+	EarthWorkBatch* batch;
+	long long open_timepoint;
+	long long close_timepoint;
+	size_t limit;
+};
+
+private class EarthWorkArchiver : public IEarthWorkCursor {
+public:
+	EarthWorkArchiver(ColumnarArchiveWriter* writer) : writer(writer) {}
+
+public:
+	bool step(EarthWork& ework, bool asc, int code) override {
+		this->tempdata[_I(EWTS::EarthWork)] = ework.product;
+		this->tempdata[_I(EWTS::Capacity)] = ework.vessel;
+		this->tempdata[_I(EWTS::HopperHeight)] = ework.hopper_height;
+		this->tempdata[_I(EWTS::Payload)] = ework.loading;
+		this->tempdata[_I(EWTS::Displacement)] = ework.displacement;
+
+		this->writer->append(ework.timestamp, this->tempdata);
+
+		return true;
+	}
+
+private:
+	double tempdata[_N(EWTS)];
+	ColumnarArchiveWriter* writer;
+};
+
+private class EarthWorkExporter : public IEarthWorkCursor {
+public:
+	EarthWorkExporter(IHistoryExportSink* sink, long long open_ms, long long close_ms)
+		: sink(sink), open_timepoint(open_ms), close_timepoint(close_ms) {}
+
+public:
+	bool step(EarthWork& ework, bool asc, int code) override {
+		long long ts = ework.timestamp;
+		bool go_on = true;
+
+		if ((ts >= this->open_timepoint) && (ts <= this->close_timepoint)) {
+			this->tempdata[_I(EWTS::EarthWork)] = ework.product;
+			this->tempdata[_I(EWTS::Capacity)] = ework.vessel;
+			this->tempdata[_I(EWTS::HopperHeight)] = ework.hopper_height;
+			this->tempdata[_I(EWTS::Payload)] = ework.loading;
+			this->tempdata[_I(EWTS::Displacement)] = ework.displacement;
+
+			go_on = this->sink->push(ts, this->tempdata);
+		}
+
+		return go_on && (ts <= this->close_timepoint);
+	}
+
+private:
+	double tempdata[_N(EWTS)];
+	IHistoryExportSink* sink;
+	long long open_timepoint;
+	long long close_timepoint;
+};
+
+static void earthwork_prepare(IDBSystem* dbc) {
+	apply_durability(dbc, DurabilityProfile::Telemetry);
+	create_earthwork(dbc, true);
+}
+
+static void earthwork_restore(EarthWork& ework, long long timepoint, const double* values) {
+	ework.timestamp = timepoint;
+	ework.product = values[_I(EWTS::EarthWork)];
+	ework.vessel = values[_I(EWTS::Capacity)];
+	ework.hopper_height = values[_I(EWTS::HopperHeight)];
+	ework.loading = values[_I(EWTS::Payload)];
+	ework.displacement = values[_I(EWTS::Displacement)];
+}
+
+/*************************************************************************************************/
+size_t WarGrey::SCADA::select_earthwork_into(IDBSystem* dbc, EarthWork* buffer, size_t capacity, long long open_ms, long long close_ms, bool asc) {
+	BufferResultSet<EarthWork, IEarthWorkCursor> rs(buffer, capacity);
+
+	if (capacity > 0U) {
+		// timestamps are unique, so that the range is answered by their index
+		IPreparedStatement* stmt = dbc->prepare(asc
+			? "SELECT uuid, product, vessel, hopper_height, loading, displacement, timestamp FROM earthwork"
+			  " WHERE timestamp >= ? AND timestamp <= ? ORDER BY timestamp ASC LIMIT ?;"
+			: "SELECT uuid, product, vessel, hopper_height, loading, displacement, timestamp FROM earthwork"
+			  " WHERE timestamp >= ? AND timestamp <= ? ORDER BY timestamp DESC LIMIT ?;");
+
+		if (stmt != nullptr) {
+			EarthWork self;
+
+			stmt->bind_parameter(0U, Integer(open_ms));
+			stmt->bind_parameter(1U, Integer(close_ms));
+			stmt->bind_parameter(2U, Integer(capacity));
+
+			while (stmt->step()) {
+				restore_earthwork(self, stmt);
+
+				if (!rs.step(self, asc, dbc->last_errno())) {
+					break;
+				}
+			}
+
+			delete stmt;
+		}
+	}
+
+	return rs.count;
 }
 
 /*************************************************************************************************/
 EarthWorkDataSource::EarthWorkDataSource(Syslog* logger, RotationPeriod period, unsigned int period_count)
-	: RotativeSQLite3("earthwork", logger, period, period_count), open_timepoint(0LL) {}
+	: RotativeSQLite3("earthwork", logger, period, period_count), open_timepoint(0LL) {
+	this->persistence = new PersistenceQueue(this->get_logger(), PersistencePolicy::Lossy,
+		persistence_queue_capacity, persistence_batch_size, earthwork_prepare);
+	this->recent = new HistoryRing<EarthWork>(history_ring_capacity);
+}
 
 EarthWorkDataSource::~EarthWorkDataSource() {
 	this->cancel();
 
-	if (this->dbc != nullptr) {
-		delete this->dbc;
-	}
+	delete this->persistence; // pending records are written before returning
+	delete this->recent;
 }
 
 bool EarthWorkDataSource::ready() {
@@ -104,12 +254,44 @@ void EarthWorkDataSource::cancel() {
 void EarthWorkDataSource::on_database_rotated(WarGrey::SCADA::SQLite3* prev_dbc, WarGrey::SCADA::SQLite3* dbc, long long timepoint) {
 	// TODO: move the temporary data from in-memory SQLite3 into the current SQLite3
 
-	create_earthwork(dbc, true);
+	if (prev_dbc != nullptr) {
+		checkpoint_durability(prev_dbc);
+	}
+
+	earthwork_prepare(dbc);
 	this->get_logger()->log_message(Log::Debug, L"current file: %S", dbc->filename().c_str());
+
+	this->do_compacting_async();
+}
+
+void EarthWorkDataSource::do_compacting_async() {
+	long long aged = this->resolve_timepoint(current_seconds()) - this->span_seconds() * history_archive_age;
+	std::vector<Platform::String^> sources;
+	Syslog* logger = this->get_logger();
+
+	for (unsigned int idx = 0; idx < history_archive_sweep; idx++) {
+		sources.push_back(this->resolve_pathname(aged - this->span_seconds() * idx));
+	}
+
+	create_task([=]() {
+		for (auto it = sources.begin(); it != sources.end(); it++) {
+			columnar_archive_compact((*it), columnar_archive_name(*it), _N(EWTS),
+				[](IDBSystem* dbc) {
+					return (unsigned long long)(earthwork_count(dbc));
+				},
+				[](IDBSystem* dbc, ColumnarArchiveWriter* writer) {
+					EarthWorkArchiver archiver(writer);
+
+					foreach_earthwork(dbc, &archiver, 0, 0, earthwork::timestamp, true);
+				}, logger);
+		}
+	});
 }
 
 void EarthWorkDataSource::load(ITimeSeriesDataReceiver* receiver, long long open_s, long long close_s) {
-	if (!this->loading()) {
+	if (this->recent->covers(open_s * 1000LL, close_s * 1000LL)) {
+		this->do_loading_from_memory(receiver, open_s, close_s);
+	} else if (!this->loading()) {
 		long long start = this->resolve_timepoint(open_s);
 		long long end = this->resolve_timepoint(close_s);
 		long long interval = this->span_seconds() * ((open_s < close_s) ? 1LL : -1LL);
@@ -120,7 +302,9 @@ void EarthWorkDataSource::load(ITimeSeriesDataReceiver* receiver, long long open
 		this->open_timepoint = open_s;
 		this->close_timepoint = close_s;
 		this->time0 = current_inexact_milliseconds();
-		this->do_loading_async(receiver, start, end, interval, 0LL, 0LL, 0.0);
+		this->prefetch_timepoint = start;
+		this->do_prefetching(end, interval);
+		this->do_loading_async(receiver, end, interval, 0LL, 0LL, 0.0);
 	}
 }
 
@@ -140,15 +324,138 @@ void EarthWorkDataSource::save(long long timepoint, double* values, unsigned int
 		}
 	}
 
-	insert_earthwork(this, ework);
+	this->recent->push(timepoint, ework);
+	this->persistence->push(this->resolve_pathname(timepoint / 1000LL), [=](IDBSystem* dbc) mutable { insert_earthwork(dbc, ework); });
 }
 
-void EarthWorkDataSource::do_loading_async(ITimeSeriesDataReceiver* receiver
-	, long long start, long long end, long long interval
-	, unsigned int file_count, unsigned int total, double span_ms) {
+task<unsigned long long> EarthWorkDataSource::export_async(Platform::String^ filename, long long open_s, long long close_s
+	, HistoryExportFormat format, long long bucket_s, cancellation_token token) {
+	std::vector<std::string> columns = { "earthwork", "capacity", "hopper_height", "payload", "displacement" };
+	std::vector<Platform::String^> sources;
+	long long end = this->resolve_timepoint(std::max(open_s, close_s));
+
+	for (long long ts = this->resolve_timepoint(std::min(open_s, close_s)); ts <= end; ts += this->span_seconds()) {
+		sources.push_back(this->resolve_pathname(ts));
+	}
+
+	return history_export_async(filename, format, columns, sources,
+		std::min(open_s, close_s) * 1000LL, std::max(open_s, close_s) * 1000LL, bucket_s * 1000LL,
+		[](IDBSystem* dbc, long long open_ms, long long close_ms, IHistoryExportSink* sink) {
+			EarthWorkExporter exporter(sink, open_ms, close_ms);
+
+			foreach_earthwork(dbc, &exporter, 0, 0, earthwork::timestamp, true);
+		}, token, this->get_logger());
+}
+
+void EarthWorkDataSource::do_loading_from_memory(ITimeSeriesDataReceiver* receiver, long long open_s, long long close_s) {
+	EarthWorkCursor ecursor(receiver, open_s, close_s);
+	double ms = current_inexact_milliseconds();
+	bool asc = (open_s < close_s);
+
+	receiver->begin_maniplation_sequence();
+	this->recent->foreach(open_s * 1000LL, close_s * 1000LL, asc, [&](EarthWork& ework) {
+		return ecursor.step(ework, asc, 0);
+	});
+	receiver->end_maniplation_sequence();
+
+	this->get_logger()->log_message(Log::Debug, L"loaded %d record(s) from memory within %lfms",
+		ecursor.count, current_inexact_milliseconds() - ms);
+
+	receiver->on_maniplation_complete(open_s, close_s);
+}
+
+/**
+ * Files are decoded ahead on the thread pool in batches of at most `history_prefetch_batch` records,
+ *   and at most `history_prefetch_depth` batches are in flight, in the direction of loading,
+ *   so that scrubbing backward prefetches backward and the memory is bounded no matter how long the period is.
+ * The rest of a file is queued right before the next file once its previous batch is delivered,
+ *   its range starts right after the timestamp of the last delivered record, rather than skipping the delivered ones.
+ * Records are still delivered to the receiver one batch after another, in the context of `load()`.
+ *
+ * This only serves `load()`, the snapshot reader of the timemachine playback lives in the shared module
+ *   and does not prefetch.
+ */
+void EarthWorkDataSource::do_prefetching(long long end, long long interval) {
 	bool asc = (interval > 0);
 
-	if ((asc ? (start > end) : (start < end))) {
+	while ((this->prefetches.size() < history_prefetch_depth)
+		&& (asc ? (this->prefetch_timepoint <= end) : (this->prefetch_timepoint >= end))) {
+		this->prefetches.push_back(this->prefetch_async(this->prefetch_timepoint,
+			std::min(this->open_timepoint, this->close_timepoint) * 1000LL,
+			std::max(this->open_timepoint, this->close_timepoint) * 1000LL,
+			asc, false));
+		this->prefetch_timepoint += interval;
+	}
+}
+
+task<std::shared_ptr<EarthWorkBatch>> EarthWorkDataSource::prefetch_async(long long timepoint, long long open_ms, long long close_ms, bool asc, bool resumed) {
+	Platform::String^ dbsource = this->resolve_filename(timepoint);
+	Platform::String^ archive = columnar_archive_name(this->resolve_pathname(timepoint));
+	cancellation_token token = this->watcher.get_token();
+	Syslog* logger = this->get_logger();
+
+	return create_task(this->rootdir()->TryGetItemAsync(dbsource), token).then([=](task<IStorageItem^> getting) {
+		std::shared_ptr<EarthWorkBatch> batch = std::make_shared<EarthWorkBatch>();
+		IStorageItem^ db = getting.get();
+
+		ColumnarArchiveReader reader(archive->Data());
+
+		batch->source = dbsource;
+		batch->timepoint = timepoint;
+		batch->open_ms = open_ms;
+		batch->close_ms = close_ms;
+		batch->resumed = resumed;
+		batch->exists = ((db != nullptr) && (db->IsOfType(StorageItemTypes::File)));
+		batch->more = false;
+		batch->span_ms = 0.0;
+		batch->records.reserve(history_prefetch_batch);
+
+		if (reader.ready()) { // aged periods are read from their archives, blocks out of the range are not decoded
+			EarthWorkCollector collector(batch.get(), open_ms, close_ms, history_prefetch_batch);
+			double ms = current_inexact_milliseconds();
+			EarthWork ework;
+
+			reader.foreach(open_ms, close_ms, asc,
+				[&](long long timepoint, const double* values) {
+					earthwork_restore(ework, timepoint, values);
+
+					return collector.step(ework, asc, 0);
+				});
+
+			batch->source = archive;
+			batch->exists = true;
+			batch->more = ((!collector.exhausted) && (batch->records.size() >= history_prefetch_batch));
+			batch->span_ms = current_inexact_milliseconds() - ms;
+		} else if (batch->exists) {
+			double ms = current_inexact_milliseconds();
+			SQLite3* dbc = new SQLite3(db->Path->Data(), logger);
+			size_t count = 0U;
+
+			dbc->set_busy_handler(durability_busy_handler);
+			apply_durability(dbc, DurabilityProfile::Reader);
+
+			batch->records.resize(history_prefetch_batch);
+			count = select_earthwork_into(dbc, batch->records.data(), history_prefetch_batch, open_ms, close_ms, asc);
+			batch->records.resize(count);
+			delete dbc;
+
+			if (count >= history_prefetch_batch) { // the rest of the file is still within the range
+				long long ts = batch->records.back().timestamp;
+
+				batch->more = (asc ? (ts < close_ms) : (ts > open_ms));
+			}
+
+			batch->span_ms = current_inexact_milliseconds() - ms;
+		}
+
+		return batch;
+	}, token, task_continuation_context::use_arbitrary());
+}
+
+void EarthWorkDataSource::do_loading_async(ITimeSeriesDataReceiver* receiver
+	, long long end, long long interval
+	, unsigned int file_count, unsigned int total, double span_ms) {
+	if (this->prefetches.empty()) {
 		double span_total = current_inexact_milliseconds() - this->time0;
 
 		this->get_logger()->log_message(Log::Debug, L"loaded %d records from %d file(s) within %lfms(wasted: %lfms)",
@@ -157,43 +464,55 @@ void EarthWorkDataSource::do_loading_async(ITimeSeriesDataReceiver* receiver
 		receiver->on_maniplation_complete(this->open_timepoint, this->close_timepoint);
 		this->open_timepoint = 0LL;
 	} else {
-		Platform::String^ dbsource = this->resolve_filename(start);
+		task<std::shared_ptr<EarthWorkBatch>> prefetching = this->prefetches.front();
 		cancellation_token token = this->watcher.get_token();
+		bool asc = (interval > 0);
+
+		this->prefetches.pop_front();
+		this->do_prefetching(end, interval);
 
-		create_task(this->rootdir()->TryGetItemAsync(dbsource), token).then([=](task<IStorageItem^> getting) {
-			IStorageItem^ db = getting.get();
-			long long next_timepoint = start + interval;
+		prefetching.then([=](task<std::shared_ptr<EarthWorkBatch>> decoding) {
+			std::shared_ptr<EarthWorkBatch> batch = decoding.get();
 
-			if ((db != nullptr) && (db->IsOfType(StorageItemTypes::File))) {
+			if (batch->more) { // the rest of the file goes before the next file
+				long long last = batch->records.back().timestamp;
+
+				this->prefetches.push_front(this->prefetch_async(batch->timepoint,
+					(asc ? (last + 1LL) : batch->open_ms), (asc ? batch->close_ms : (last - 1LL)),
+					asc, true));
+			}
+
+			if (batch->exists) {
 				EarthWorkCursor ecursor(receiver, this->open_timepoint, this->close_timepoint);
 				double ms = current_inexact_milliseconds();
-				
-				this->dbc = new SQLite3(db->Path->Data(), this->get_logger());
-				this->dbc->set_busy_handler(earthwork_busy_handler);
 
 				receiver->begin_maniplation_sequence();
-				foreach_earthwork(this->dbc, &ecursor, 0, 0, earthwork::timestamp, asc);
+				for (auto it = batch->records.begin(); it != batch->records.end(); it++) {
+					ecursor.step((*it), asc, 0);
+				}
 				receiver->end_maniplation_sequence();
 
-				delete this->dbc;
-				this->dbc = nullptr;
-
-				ms = current_inexact_milliseconds() - ms;
+				ms = current_inexact_milliseconds() - ms + batch->span_ms;
 				this->get_logger()->log_message(Log::Debug, L"loaded %d record(s) from[%s] within %lfms",
-					ecursor.count, dbsource->Data(), ms);
+					ecursor.count, batch->source->Data(), ms);
 
-				this->do_loading_async(receiver, next_timepoint, end, interval,
-					file_count + 1LL, total + ecursor.count, span_ms + ms);
+				this->do_loading_async(receiver, end, interval,
+					file_count + (batch->resumed ? 0U : 1U), total + ecursor.count, span_ms + ms);
 			} else {
-				this->get_logger()->log_message(Log::Debug, L"skip non-existent source[%s]", dbsource->Data());
-				this->do_loading_async(receiver, next_timepoint, end, interval, file_count, total, span_ms);
+				this->get_logger()->log_message(Log::Debug, L"skip non-existent source[%s]", batch->source->Data());
+				this->do_loading_async(receiver, end, interval, file_count, total, span_ms);
 			}
-		}).then([=](task<void> check_exn) {
+		}, token).then([=](task<void> check_exn) {
 			try {
 				check_exn.get();
 			} catch (Platform::Exception^ e) {
+				this->prefetches.clear();
+				this->open_timepoint = 0LL;
 				this->on_exception(e);
-			} catch (task_canceled&) {}
+			} catch (task_canceled&) {
+				this->prefetches.clear();
+				this->open_timepoint = 0LL;
+			}
 		});
 	}
 }
@@ -1,16 +1,34 @@
 #pragma once
 
 #include <ppltasks.h>
+#include <memory>
+#include <deque>
 
 #include "graphlet/time/timeserieslet.hpp"
 
 #include "sqlite3/rotation.hpp"
 
+#include "persistence.hpp"
+#include "hotring.hpp"
+#include "export.hpp"
+
+#include "schema/earthwork.hpp"
+
 namespace WarGrey::SCADA {
 	private enum class EWTS { EarthWork, Capacity, HopperHeight, Payload, Displacement, _ };
 
 	Microsoft::Graphics::Canvas::Brushes::CanvasSolidColorBrush^ earthwork_line_color_dictionary(unsigned int index);
 
+	/**
+	 * A result set that the generated DAO does not make, see `resultset.hpp`.
+	 * `select_earthwork_into` restores at most `capacity` rows within [`open_ms`, `close_ms`] into `buffer`,
+	 *   ordered by timestamp, and returns the number of rows restored.
+	 */
+	size_t select_earthwork_into(WarGrey::SCADA::IDBSystem* dbc, WarGrey::SCADA::EarthWork* buffer, size_t capacity,
+		long long open_ms, long long close_ms, bool asc = true);
+
+	struct EarthWorkBatch;
+
 	private class EarthWorkDataSource
 		: public WarGrey::SCADA::ITimeSeriesDataSource
 		, public WarGrey::SCADA::RotativeSQLite3 {
@@ -28,6 +46,10 @@ namespace WarGrey::SCADA {
 		void load(WarGrey::SCADA::ITimeSeriesDataReceiver* receiver, long long open_s, long long close_s) override;
 		void save(long long timepoint, double* values, unsigned int n) override;
 
+	public:
+		Concurrency::task<unsigned long long> export_async(Platform::String^ filename, long long open_s, long long close_s,
+			WarGrey::SCADA::HistoryExportFormat format, long long bucket_s, Concurrency::cancellation_token token);
+
 	protected:
 		void on_database_rotated(WarGrey::SCADA::SQLite3* prev_dbc, WarGrey::SCADA::SQLite3* current_dbc, long long timepoint) override;
 
@@ -36,14 +58,25 @@ namespace WarGrey::SCADA {
 
 	private:
 		void do_loading_async(WarGrey::SCADA::ITimeSeriesDataReceiver* receiver,
-			long long start, long long end, long long interval,
+			long long end, long long interval,
 			unsigned int file_count, unsigned int total, double span_ms);
 
+		void do_loading_from_memory(WarGrey::SCADA::ITimeSeriesDataReceiver* receiver, long long open_s, long long close_s);
+		void do_prefetching(long long end, long long interval);
+		void do_compacting_async();
+		Concurrency::task<std::shared_ptr<WarGrey::SCADA::EarthWorkBatch>> prefetch_async(long long timepoint,
+			long long open_ms, long long close_ms, bool asc, bool resumed);
+
 	private:
 		Concurrency::cancellation_token_source watcher;
-		WarGrey::SCADA::ISQLite3* dbc;
+		std::deque<Concurrency::task<std::shared_ptr<WarGrey::SCADA::EarthWorkBatch>>> prefetches;
+		long long prefetch_timepoint;
 		long long open_timepoint;
 		long long close_timepoint;
 		double time0;
+
+	private:
+		WarGrey::SCADA::PersistenceQueue* persistence;
+		WarGrey::SCADA::HistoryRing<WarGrey::SCADA::EarthWork>* recent;
 	};
 }
@@ -0,0 +1,270 @@
+#include <filesystem>
+#include <algorithm>
+
+#include "schema/datalet/trend_ts.hpp"
+
+#include "configuration.hpp"
+#include "durability.hpp"
+
+#include "iotables/ai_pumps.hpp"
+#include "iotables/ai_hopper_pumps.hpp"
+#include "iotables/ai_water_pumps.hpp"
+#include "iotables/ai_winches.hpp"
+#include "iotables/ai_dredges.hpp"
+#include "iotables/ai_metrics.hpp"
+
+#include "datum/time.hpp"
+
+using namespace WarGrey::SCADA;
+using namespace WarGrey::GYDM;
+
+using namespace Concurrency;
+
+/*************************************************************************************************/
+static const HistorianChannel default_historian_channels[] = {
+	// hydraulic pumps
+	{ HistorianDB::DB203, pump_A_pressure, SignalCompression::SwingingDoor, 0.1 },
+	{ HistorianDB::DB203, pump_B_pressure, SignalCompression::SwingingDoor, 0.1 },
+	{ HistorianDB::DB203, pump_C_pressure, SignalCompression::SwingingDoor, 0.1 },
+	{ HistorianDB::DB203, pump_D_pressure, SignalCompression::SwingingDoor, 0.1 },
+	{ HistorianDB::DB203, pump_E_pressure, SignalCompression::SwingingDoor, 0.1 },
+	{ HistorianDB::DB203, pump_F_pressure, SignalCompression::SwingingDoor, 0.1 },
+	{ HistorianDB::DB203, pump_G_pressure, SignalCompression::SwingingDoor, 0.1 },
+	{ HistorianDB::DB203, pump_H_pressure, SignalCompression::SwingingDoor, 0.1 },
+	{ HistorianDB::DB203, pump_I_pressure, SignalCompression::SwingingDoor, 0.1 },
+	{ HistorianDB::DB203, pump_J_pressure, SignalCompression::SwingingDoor, 0.1 },
+
+	// hydraulic tanks
+	{ HistorianDB::DB203, visor_tank_temperature, SignalCompression::Deadband, 0.5 },
+	{ HistorianDB::DB203, master_tank_temperature, SignalCompression::Deadband, 0.5 },
+	{ HistorianDB::DB203, visor_tank_level, SignalCompression::Deadband, 0.5 },
+	{ HistorianDB::DB203, master_back_oil_pressure, SignalCompression::SwingingDoor, 0.1 },
+
+	// gland pumps, hopper pumps and water pumps
+	{ HistorianDB::DB203, ps_hopper_gland_pump_A_rpm, SignalCompression::Deadband, 5.0 },
+	{ HistorianDB::DB203, ps_hopper_gland_pump_B_rpm, SignalCompression::Deadband, 5.0 },
+	{ HistorianDB::DB203, sb_hopper_gland_pump_A_rpm, SignalCompression::Deadband, 5.0 },
+	{ HistorianDB::DB203, sb_hopper_gland_pump_B_rpm, SignalCompression::Deadband, 5.0 },
+	{ HistorianDB::DB203, ps_hopper_gland_pump_pressure, SignalCompression::SwingingDoor, 0.1 },
+	{ HistorianDB::DB203, sb_hopper_gland_pump_pressure, SignalCompression::SwingingDoor, 0.1 },
+	{ HistorianDB::DB203, ps_hopper_pump_rpm, SignalCompression::Deadband, 5.0 },
+	{ HistorianDB::DB203, sb_hopper_pump_rpm, SignalCompression::Deadband, 5.0 },
+	{ HistorianDB::DB203, ps_underwater_pump_rpm, SignalCompression::Deadband, 5.0 },
+	{ HistorianDB::DB203, sb_underwater_pump_rpm, SignalCompression::Deadband, 5.0 },
+	{ HistorianDB::DB203, ps_water_pump_rpm, SignalCompression::Deadband, 5.0 },
+	{ HistorianDB::DB203, sb_water_pump_rpm, SignalCompression::Deadband, 5.0 },
+
+	// winches
+	{ HistorianDB::DB203, bow_anchor_winch_pressure, SignalCompression::SwingingDoor, 0.1 },
+	{ HistorianDB::DB203, stern_anchor_winch_pressure, SignalCompression::SwingingDoor, 0.1 },
+	{ HistorianDB::DB203, barge_winch_pressure, SignalCompression::SwingingDoor, 0.1 },
+	{ HistorianDB::DB203, shore_discharge_winch_pressure, SignalCompression::SwingingDoor, 0.1 },
+	{ HistorianDB::DB203, winch_ps_intermediate_remote_speed, SignalCompression::SwingingDoor, 0.1 },
+	{ HistorianDB::DB203, winch_ps_draghead_remote_speed, SignalCompression::SwingingDoor, 0.1 },
+	{ HistorianDB::DB203, winch_sb_intermediate_remote_speed, SignalCompression::SwingingDoor, 0.1 },
+	{ HistorianDB::DB203, winch_sb_draghead_remote_speed, SignalCompression::SwingingDoor, 0.1 },
+
+	// vessel
+	{ HistorianDB::DB2, gps_speed, SignalCompression::SwingingDoor, 0.1 },
+	{ HistorianDB::DB2, average_draught, SignalCompression::SwingingDoor, 0.01 }
+};
+
+private class TrendCursor : public ITrendCursor {
+public:
+	TrendCursor(std::function<bool(long long, double)> step, cancellation_token token)
+		: count(0ULL), go_on(true), step_fx(step), token(token) {}
+
+public:
+	bool step(Trend& trend, bool asc, int code) override {
+		this->go_on = ((!this->token.is_canceled()) && this->step_fx(trend.timestamp, trend.value));
+
+		if (this->go_on) {
+			this->count++;
+		}
+
+		return this->go_on;
+	}
+
+public:
+	unsigned long long count;
+	bool go_on;
+
+private:
+	std::function<bool(long long, double)> step_fx;
+	cancellation_token token;
+};
+
+/** NOTE
+ * The generated `foreach_trend()` walks the whole table, whereas a query only wants one channel within a range,
+ *   which is answered by the (channel, timestamp) index without touching the rows of other channels.
+ */
+static void trend_prepare(IDBSystem* dbc) {
+	apply_durability(dbc, DurabilityProfile::Telemetry);
+	create_trend(dbc, true);
+	dbc->exec("CREATE INDEX IF NOT EXISTS trend_channel_timestamp ON trend (channel, timestamp);");
+}
+
+static void foreach_channel_trend(IDBSystem* dbc, ITrendCursor* cursor, unsigned int channel, long long open_ms, long long close_ms) {
+	IPreparedStatement* stmt = dbc->prepare("SELECT uuid, channel, value, timestamp FROM trend"
+		" WHERE channel = ? AND timestamp >= ? AND timestamp <= ? ORDER BY timestamp ASC;");
+
+	if (stmt != nullptr) {
+		Trend self;
+
+		stmt->bind_parameter(0U, Integer(channel));
+		stmt->bind_parameter(1U, Integer(open_ms));
+		stmt->bind_parameter(2U, Integer(close_ms));
+
+		while (stmt->step()) {
+			restore_trend(self, stmt);
+
+			if (!cursor->step(self, true, dbc->last_errno())) {
+				break;
+			}
+		}
+
+		delete stmt;
+	}
+}
+
+/*************************************************************************************************/
+unsigned int WarGrey::SCADA::historian_channel(HistorianDB db, unsigned int address) {
+	return (static_cast<unsigned int>(db) << 16) | (address & 0xFFFF);
+}
+
+/*************************************************************************************************/
+TrendDataSource::TrendDataSource(Syslog* logger, RotationPeriod period, unsigned int period_count)
+	: RotativeSQLite3("trend", logger, period, period_count) {
+	this->persistence = new PersistenceQueue(this->get_logger(), PersistencePolicy::Lossy,
+		persistence_queue_capacity, persistence_batch_size, trend_prepare);
+}
+
+TrendDataSource::~TrendDataSource() {
+	delete this->persistence; // pending points are written before returning
+}
+
+void TrendDataSource::on_database_rotated(SQLite3* prev_dbc, SQLite3* dbc, long long timepoint) {
+	if (prev_dbc != nullptr) {
+		checkpoint_durability(prev_dbc);
+	}
+
+	trend_prepare(dbc);
+	this->get_logger()->log_message(Log::Debug, L"current file: %S", dbc->filename().c_str());
+}
+
+void TrendDataSource::save(long long timepoint_ms, unsigned int channel, double value) {
+	Trend point;
+
+	default_trend(point, channel, value, timepoint_ms);
+
+	this->persistence->push(this->resolve_pathname(timepoint_ms / 1000LL), [=](IDBSystem* dbc) mutable { insert_trend(dbc, point); });
+}
+
+task<unsigned long long> TrendDataSource::query_async(unsigned int channel, long long open_s, long long close_s
+	, std::function<bool(long long, double)> step, cancellation_token token) {
+	std::vector<Platform::String^> sources;
+	long long open_ms = std::min(open_s, close_s) * 1000LL;
+	long long close_ms = std::max(open_s, close_s) * 1000LL;
+	long long end = this->resolve_timepoint(std::max(open_s, close_s));
+	Syslog* logger = this->get_logger();
+
+	for (long long ts = this->resolve_timepoint(std::min(open_s, close_s)); ts <= end; ts += this->span_seconds()) {
+		sources.push_back(this->resolve_pathname(ts));
+	}
+
+	return create_task([=]() {
+		TrendCursor cursor(step, token);
+		double ms = current_inexact_milliseconds();
+		std::error_code ec;
+
+		this->persistence->flush(); // the latest points might still be in the queue
+
+		for (auto it = sources.begin(); (it != sources.end()) && cursor.go_on; it++) {
+			if (std::filesystem::exists(std::filesystem::path((*it)->Data()), ec)) {
+				SQLite3* dbc = new SQLite3((*it)->Data(), logger);
+
+				dbc->set_busy_handler(durability_busy_handler);
+				apply_durability(dbc, DurabilityProfile::Reader);
+				foreach_channel_trend(dbc, &cursor, channel, open_ms, close_ms);
+				delete dbc;
+			}
+		}
+
+		logger->log_message(Log::Debug, L"queried %llu point(s) of channel %u from %u file(s) within %lfms",
+			cursor.count, channel, (unsigned int)(sources.size()), current_inexact_milliseconds() - ms);
+
+		return cursor.count;
+	}, token);
+}
+
+/*************************************************************************************************/
+SignalHistorian::SignalHistorian(Syslog* logger, const HistorianChannel* channels, size_t count) : last_timepoint(0LL) {
+	if (channels == nullptr) {
+		channels = default_historian_channels;
+		count = sizeof(default_historian_channels) / sizeof(HistorianChannel);
+	}
+
+	for (size_t idx = 0; idx < count; idx++) {
+		this->channels.push_back(channels[idx]);
+		this->compressors.push_back(SignalCompressor(channels[idx].method, channels[idx].deviation, historian_heartbeat));
+	}
+
+	this->trends = new TrendDataSource(logger, RotationPeriod::Daily);
+	this->trends->reference();
+}
+
+SignalHistorian::~SignalHistorian() {
+	long long timepoint;
+	double value;
+
+	// so that trends end where the signals were last seen
+	for (size_t idx = 0; idx < this->channels.size(); idx++) {
+		if (this->compressors[idx].flush(&timepoint, &value)) {
+			HistorianChannel& self = this->channels[idx];
+
+			this->trends->save(timepoint, historian_channel(self.db, self.address), value);
+		}
+	}
+
+	this->trends->destroy();
+}
+
+TrendDataSource* SignalHistorian::datasource() {
+	return this->trends;
+}
+
+void SignalHistorian::on_analog_input(long long timepoint_ms, const uint8* DB2, size_t count2, const uint8* DB203, size_t count203, Syslog* logger) {
+	if (timepoint_ms > this->last_timepoint) {
+		long long timepoint;
+		double value;
+
+		for (size_t idx = 0; idx < this->channels.size(); idx++) {
+			HistorianChannel& self = this->channels[idx];
+			bool available = false;
+			float datum = 0.0F;
+
+			switch (self.db) {
+			case HistorianDB::DB2: {
+				available = ((self.address + 4U) <= count2);
+
+				if (available) {
+					datum = DBD(DB2, self.address);
+				}
+			}; break;
+			case HistorianDB::DB203: {
+				available = ((self.address * 4U + 4U) <= count203);
+
+				if (available) {
+					datum = RealData(DB203, self.address);
+				}
+			}; break;
+			}
+
+			if (available && this->compressors[idx].push(timepoint_ms, double(datum), &timepoint, &value)) {
+				this->trends->save(timepoint, historian_channel(self.db, self.address), value);
+			}
+		}
+
+		this->last_timepoint = timepoint_ms;
+	}
+}
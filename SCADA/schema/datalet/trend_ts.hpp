@@ -0,0 +1,81 @@
+#pragma once
+
+#include <ppltasks.h>
+#include <functional>
+#include <vector>
+
+#include "sqlite3/rotation.hpp"
+
+#include "persistence.hpp"
+#include "historian.hpp"
+#include "plc.hpp"
+
+#include "schema/trend.hpp"
+
+namespace WarGrey::SCADA {
+	private enum class HistorianDB { DB2 = 2, DB203 = 203 };
+
+	private struct HistorianChannel {
+		WarGrey::SCADA::HistorianDB db;
+		unsigned int address;
+		WarGrey::SCADA::SignalCompression method;
+		double deviation;
+	};
+
+	/**
+	 * channels are identified as alarms are, `(db << 16) | address`.
+	 */
+	unsigned int historian_channel(WarGrey::SCADA::HistorianDB db, unsigned int address);
+
+	private class TrendDataSource : public WarGrey::SCADA::RotativeSQLite3 {
+	public:
+		TrendDataSource(WarGrey::GYDM::Syslog* logger = nullptr,
+			WarGrey::SCADA::RotationPeriod period = RotationPeriod::Daily,
+			unsigned int period_count = 1U);
+
+	public:
+		void save(long long timepoint_ms, unsigned int channel, double value);
+
+	public:
+		/**
+		 * `step` is applied to archived points of `channel` within [open_s, close_s] in ascending order,
+		 *   it returns `false` to stop, the task returns the number of points delivered.
+		 */
+		Concurrency::task<unsigned long long> query_async(unsigned int channel, long long open_s, long long close_s,
+			std::function<bool(long long, double)> step, Concurrency::cancellation_token token);
+
+	protected:
+		void on_database_rotated(WarGrey::SCADA::SQLite3* prev_dbc, WarGrey::SCADA::SQLite3* current_dbc, long long timepoint) override;
+
+	protected:
+		~TrendDataSource() noexcept;
+
+	private:
+		WarGrey::SCADA::PersistenceQueue* persistence;
+	};
+
+	/** NOTE
+	 * The historian records analog channels read from the PLC, each channel is compressed on its own,
+	 *   only points that are needed to reconstruct the trend within the channel's deviation are written.
+	 */
+	private class SignalHistorian : public WarGrey::SCADA::PLCConfirmation {
+	public:
+		virtual ~SignalHistorian() noexcept;
+
+		SignalHistorian(WarGrey::GYDM::Syslog* logger,
+			const WarGrey::SCADA::HistorianChannel* channels = nullptr, size_t count = 0U);
+
+	public:
+		void on_analog_input(long long timepoint_ms, const uint8* DB2, size_t count2, const uint8* DB203, size_t count203,
+			WarGrey::GYDM::Syslog* logger) override;
+
+	public:
+		WarGrey::SCADA::TrendDataSource* datasource();
+
+	private:
+		WarGrey::SCADA::TrendDataSource* trends;
+		std::vector<WarGrey::SCADA::HistorianChannel> channels;
+		std::vector<WarGrey::SCADA::SignalCompressor> compressors;
+		long long last_timepoint;
+	};
+}
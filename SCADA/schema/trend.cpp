@@ -0,0 +1,239 @@
+#include "trend.hpp"
+
+#include "dbsystem.hpp"
+#include "dbtypes.hpp"
+
+#include "dbmisc.hpp"
+
+using namespace WarGrey::SCADA;
+
+static const char* trend_rowids[] = { "uuid" };
+
+static TableColumnInfo trend_columns[] = {
+    { "uuid", SDT::Integer, nullptr, DB_PRIMARY_KEY | 0 | 0 },
+    { "channel", SDT::Integer, nullptr, 0 | DB_NOT_NULL | 0 },
+    { "value", SDT::Float, nullptr, 0 | DB_NOT_NULL | 0 },
+    { "timestamp", SDT::Integer, nullptr, 0 | DB_NOT_NULL | 0 },
+};
+
+/**************************************************************************************************/
+Trend_pk WarGrey::SCADA::trend_identity(Trend& self) {
+    return self.uuid;
+}
+
+Trend WarGrey::SCADA::make_trend(std::optional<Integer> channel, std::optional<Float> value, std::optional<Integer> timestamp) {
+    Trend self;
+
+    default_trend(self, channel, value, timestamp);
+
+    return self;
+}
+
+void WarGrey::SCADA::default_trend(Trend& self, std::optional<Integer> channel, std::optional<Float> value, std::optional<Integer> timestamp) {
+    self.uuid = pk64_timestamp();
+    if (channel.has_value()) { self.channel = channel.value(); }
+    if (value.has_value()) { self.value = value.value(); }
+    if (timestamp.has_value()) { self.timestamp = timestamp.value(); }
+}
+
+void WarGrey::SCADA::refresh_trend(Trend& self) {
+}
+
+void WarGrey::SCADA::store_trend(Trend& self, IPreparedStatement* stmt) {
+    stmt->bind_parameter(0U, self.uuid);
+    stmt->bind_parameter(1U, self.channel);
+    stmt->bind_parameter(2U, self.value);
+    stmt->bind_parameter(3U, self.timestamp);
+}
+
+void WarGrey::SCADA::restore_trend(Trend& self, IPreparedStatement* stmt) {
+    self.uuid = stmt->column_int64(0U);
+    self.channel = stmt->column_int64(1U);
+    self.value = stmt->column_double(2U);
+    self.timestamp = stmt->column_int64(3U);
+}
+
+/**************************************************************************************************/
+void WarGrey::SCADA::create_trend(IDBSystem* dbc, bool if_not_exists) {
+    IVirtualSQL* vsql = dbc->make_sql_factory(trend_columns);
+    std::string sql = vsql->create_table("trend", trend_rowids, sizeof(trend_rowids)/sizeof(char*), if_not_exists);
+
+    dbc->exec(sql);
+}
+
+void WarGrey::SCADA::insert_trend(IDBSystem* dbc, Trend& self, bool replace) {
+    insert_trend(dbc, &self, 1, replace);
+}
+
+void WarGrey::SCADA::insert_trend(IDBSystem* dbc, Trend* selves, size_t count, bool replace) {
+    IVirtualSQL* vsql = dbc->make_sql_factory(trend_columns);
+    std::string sql = vsql->insert_into("trend", replace);
+    IPreparedStatement* stmt = dbc->prepare(sql);
+
+    if (stmt != nullptr) {
+        for (size_t i = 0; i < count; i ++) {
+            store_trend(selves[i], stmt);
+
+            dbc->exec(stmt);
+            stmt->reset(true);
+        }
+
+        delete stmt;
+    }
+}
+
+void WarGrey::SCADA::foreach_trend(IDBSystem* dbc, ITrendCursor* cursor, uint64 limit, uint64 offset, trend order_by, bool asc) {
+    IVirtualSQL* vsql = dbc->make_sql_factory(trend_columns);
+    const char* colname = ((order_by == trend::_) ? nullptr : trend_columns[static_cast<unsigned int>(order_by)].name);
+    std::string sql = vsql->select_from("trend", colname, asc, limit, offset);
+    IPreparedStatement* stmt = dbc->prepare(sql);
+
+    if (stmt != nullptr) {
+        Trend self;
+
+        while(stmt->step()) {
+            restore_trend(self, stmt);
+            if (!cursor->step(self, asc, dbc->last_errno())) break;
+        }
+
+        delete stmt;
+    }
+
+}
+
+std::list<Trend> WarGrey::SCADA::select_trend(IDBSystem* dbc, uint64 limit, uint64 offset, trend order_by, bool asc) {
+    IVirtualSQL* vsql = dbc->make_sql_factory(trend_columns);
+    const char* colname = ((order_by == trend::_) ? nullptr : trend_columns[static_cast<unsigned int>(order_by)].name);
+    std::string sql = vsql->select_from("trend", colname, asc, limit, offset);
+    IPreparedStatement* stmt = dbc->prepare(sql);
+    std::list<Trend> queries;
+
+    if (stmt != nullptr) {
+        Trend self;
+
+        while(stmt->step()) {
+            restore_trend(self, stmt);
+            queries.push_back(self);
+        }
+
+        delete stmt;
+    }
+
+    return queries;
+}
+
+std::optional<Trend> WarGrey::SCADA::seek_trend(IDBSystem* dbc, Trend_pk where) {
+    IVirtualSQL* vsql = dbc->make_sql_factory(trend_columns);
+    std::string sql = vsql->seek_from("trend", trend_rowids, sizeof(trend_rowids)/sizeof(char*));
+    IPreparedStatement* stmt = dbc->prepare(sql);
+    std::optional<Trend> query;
+
+    if (stmt != nullptr) {
+        Trend self;
+
+        stmt->bind_parameter(0U, where);
+
+        if (stmt->step()) {
+            restore_trend(self, stmt);
+            query = self;
+        }
+
+        delete stmt;
+    }
+
+    return query;
+}
+
+void WarGrey::SCADA::update_trend(IDBSystem* dbc, Trend& self, bool refresh) {
+    update_trend(dbc, &self, 1, refresh);
+}
+
+void WarGrey::SCADA::update_trend(IDBSystem* dbc, Trend* selves, size_t count, bool refresh) {
+    IVirtualSQL* vsql = dbc->make_sql_factory(trend_columns);
+    std::string sql = vsql->update_set("trend", trend_rowids, sizeof(trend_rowids)/sizeof(char*));
+    IPreparedStatement* stmt = dbc->prepare(sql);
+
+    if (stmt != nullptr) {
+        for (size_t i = 0; i < count; i ++) {
+            if (refresh) {
+                refresh_trend(selves[i]);
+            }
+
+            stmt->bind_parameter(3U, selves[i].uuid);
+
+            stmt->bind_parameter(0U, selves[i].channel);
+            stmt->bind_parameter(1U, selves[i].value);
+            stmt->bind_parameter(2U, selves[i].timestamp);
+
+            dbc->exec(stmt);
+            stmt->reset(true);
+        }
+
+        delete stmt;
+    }
+}
+
+void WarGrey::SCADA::delete_trend(IDBSystem* dbc, Trend_pk& where) {
+    delete_trend(dbc, &where, 1);
+}
+
+void WarGrey::SCADA::delete_trend(IDBSystem* dbc, Trend_pk* wheres, size_t count) {
+    IVirtualSQL* vsql = dbc->make_sql_factory(trend_columns);
+    std::string sql = vsql->delete_from("trend", trend_rowids, sizeof(trend_rowids)/sizeof(char*));
+    IPreparedStatement* stmt = dbc->prepare(sql);
+
+    if (stmt != nullptr) {
+        for (size_t i = 0; i < count; i ++) {
+            stmt->bind_parameter(0U, wheres[i]);
+
+            dbc->exec(stmt);
+            stmt->reset(true);
+        }
+
+        delete stmt;
+    }
+}
+
+void WarGrey::SCADA::drop_trend(IDBSystem* dbc) {
+    IVirtualSQL* vsql = dbc->make_sql_factory(trend_columns);
+    std::string sql = vsql->drop_table("trend");
+
+    dbc->exec(sql);
+}
+
+/**************************************************************************************************/
+double WarGrey::SCADA::trend_average(WarGrey::SCADA::IDBSystem* dbc, trend column, bool distinct) {
+    IVirtualSQL* vsql = dbc->make_sql_factory(trend_columns);
+    const char* colname = ((column == trend::_) ? nullptr : trend_columns[static_cast<unsigned int>(column)].name);
+
+    return dbc->query_double(vsql->table_average("trend", colname, distinct));
+}
+
+int64 WarGrey::SCADA::trend_count(WarGrey::SCADA::IDBSystem* dbc, trend column, bool distinct) {
+    IVirtualSQL* vsql = dbc->make_sql_factory(trend_columns);
+    const char* colname = ((column == trend::_) ? nullptr : trend_columns[static_cast<unsigned int>(column)].name);
+
+    return dbc->query_int64(vsql->table_count("trend", colname, distinct));
+}
+
+std::optional<double> WarGrey::SCADA::trend_max(WarGrey::SCADA::IDBSystem* dbc, trend column, bool distinct) {
+    IVirtualSQL* vsql = dbc->make_sql_factory(trend_columns);
+    const char* colname = ((column == trend::_) ? nullptr : trend_columns[static_cast<unsigned int>(column)].name);
+
+    return dbc->query_maybe_double(vsql->table_max("trend", colname, distinct));
+}
+
+std::optional<double> WarGrey::SCADA::trend_min(WarGrey::SCADA::IDBSystem* dbc, trend column, bool distinct) {
+    IVirtualSQL* vsql = dbc->make_sql_factory(trend_columns);
+    const char* colname = ((column == trend::_) ? nullptr : trend_columns[static_cast<unsigned int>(column)].name);
+
+    return dbc->query_maybe_double(vsql->table_min("trend", colname, distinct));
+}
+
+std::optional<double> WarGrey::SCADA::trend_sum(WarGrey::SCADA::IDBSystem* dbc, trend column, bool distinct) {
+    IVirtualSQL* vsql = dbc->make_sql_factory(trend_columns);
+    const char* colname = ((column == trend::_) ? nullptr : trend_columns[static_cast<unsigned int>(column)].name);
+
+    return dbc->query_maybe_double(vsql->table_sum("trend", colname, distinct));
+}
+
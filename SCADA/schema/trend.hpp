@@ -0,0 +1,66 @@
+#pragma once
+
+#include <list>
+#include <optional>
+
+#include "dbsystem.hpp"
+
+namespace WarGrey::SCADA {
+    typedef Integer Trend_pk;
+
+    private struct Trend {
+        Integer uuid;
+        Integer channel;
+        Float value;
+        Integer timestamp;
+    };
+
+    private class ITrendCursor abstract {
+    public:
+        virtual bool step(WarGrey::SCADA::Trend& occurrence, bool asc, int code) = 0;
+    };
+
+    private enum class trend { uuid, channel, value, timestamp, _ };
+
+    WarGrey::SCADA::Trend_pk trend_identity(WarGrey::SCADA::Trend& self);
+
+    WarGrey::SCADA::Trend make_trend(std::optional<Integer> channel = std::nullopt, std::optional<Float> value = std::nullopt, std::optional<Integer> timestamp = std::nullopt);
+    void default_trend(WarGrey::SCADA::Trend& self, std::optional<Integer> channel = std::nullopt, std::optional<Float> value = std::nullopt, std::optional<Integer> timestamp = std::nullopt);
+    void refresh_trend(WarGrey::SCADA::Trend& self);
+    void store_trend(WarGrey::SCADA::Trend& self, WarGrey::SCADA::IPreparedStatement* stmt);
+    void restore_trend(WarGrey::SCADA::Trend& self, WarGrey::SCADA::IPreparedStatement* stmt);
+
+    void create_trend(WarGrey::SCADA::IDBSystem* dbc, bool if_not_exists = true);
+    void insert_trend(WarGrey::SCADA::IDBSystem* dbc, Trend& self, bool replace = false);
+    void insert_trend(WarGrey::SCADA::IDBSystem* dbc, Trend* selves, size_t count, bool replace = false);
+    void foreach_trend(WarGrey::SCADA::IDBSystem* dbc, WarGrey::SCADA::ITrendCursor* cursor, uint64 limit = 0U, uint64 offset = 0U, WarGrey::SCADA::trend order_by = trend::timestamp, bool asc = true);
+    std::list<WarGrey::SCADA::Trend> select_trend(WarGrey::SCADA::IDBSystem* dbc, uint64 limit = 0U, uint64 offset = 0U, WarGrey::SCADA::trend order_by = trend::timestamp, bool asc = true);
+    std::optional<WarGrey::SCADA::Trend> seek_trend(WarGrey::SCADA::IDBSystem* dbc, WarGrey::SCADA::Trend_pk where);
+    void update_trend(WarGrey::SCADA::IDBSystem* dbc, WarGrey::SCADA::Trend& self, bool refresh = true);
+    void update_trend(WarGrey::SCADA::IDBSystem* dbc, WarGrey::SCADA::Trend* selves, size_t count, bool refresh = true);
+    void delete_trend(WarGrey::SCADA::IDBSystem* dbc, WarGrey::SCADA::Trend_pk& where);
+    void delete_trend(WarGrey::SCADA::IDBSystem* dbc, WarGrey::SCADA::Trend_pk* wheres, size_t count);
+    void drop_trend(WarGrey::SCADA::IDBSystem* dbc);
+
+    double trend_average(WarGrey::SCADA::IDBSystem* dbc, WarGrey::SCADA::trend column = trend::_, bool distinct = false);
+    int64 trend_count(WarGrey::SCADA::IDBSystem* dbc, WarGrey::SCADA::trend column = trend::_, bool distinct = false);
+    std::optional<double> trend_max(WarGrey::SCADA::IDBSystem* dbc, WarGrey::SCADA::trend column = trend::_, bool distinct = false);
+    std::optional<double> trend_min(WarGrey::SCADA::IDBSystem* dbc, WarGrey::SCADA::trend column = trend::_, bool distinct = false);
+    std::optional<double> trend_sum(WarGrey::SCADA::IDBSystem* dbc, WarGrey::SCADA::trend column = trend::_, bool distinct = false);
+
+    template<size_t N>
+    void insert_trend(WarGrey::SCADA::IDBSystem* dbc, Trend (&selves)[N], bool replace = false) {
+        WarGrey::SCADA::insert_trend(dbc, selves, N, replace);
+    }
+
+    template<size_t N>
+    void update_trend(WarGrey::SCADA::IDBSystem* dbc, Trend (&selves)[N], bool refresh = true) {
+        WarGrey::SCADA::update_trend(dbc, selves, N, refresh);
+    }
+
+    template<size_t N>
+    void delete_trend(WarGrey::SCADA::IDBSystem* dbc, Trend_pk (&wheres)[N]) {
+        WarGrey::SCADA::delete_trend(dbc, wheres, N);
+    }
+
+}
@@ -2,6 +2,8 @@
 #include <ppltasks.h>
 
 #include "configuration.hpp"
+#include "intern.hpp"
+#include "capture.hpp"
 
 #include "widget.hxx"
 #include "planet.hpp"
@@ -58,8 +60,8 @@ static ICanvasBrush^ about_fgcolor = Colours::Black;
 
 static const float widget_line_gap = tiny_font_size;
 
-static CanvasTextFormat^ widget_label_font = make_text_format("Microsoft YaHei", large_font_size);
-static CanvasTextFormat^ widget_icon_font = make_text_format("Consolas", 32.0F);
+static CanvasTextFormat^ widget_label_font = intern_text_format("Microsoft YaHei", large_font_size);
+static CanvasTextFormat^ widget_icon_font = intern_text_format("Consolas", 32.0F);
 
 /*************************************************************************************************/
 float WarGrey::SCADA::widget_evaluate_height() {
@@ -101,7 +103,7 @@ namespace {
 			float button_height, label_width;
 			ButtonStyle button_style;
 
-			button_style.font = make_bold_text_format(tiny_font_size);
+			button_style.font = intern_bold_text_format(tiny_font_size);
 			button_style.corner_radius = 2.0F;
 			button_style.thickness = 1.0F;
 
@@ -272,7 +274,7 @@ namespace {
 					}
 				}; break;
 				case Icon::PrintScreen: {
-					this->application->save(this->application->current_planet->name() + "-"
+					capture_enqueue(this->application->take_snapshot(), this->application->current_planet->name() + "-"
 						+ file_basename_from_second(current_seconds()) + ".png");
 				}; break;
 				case Icon::FullScreen: {
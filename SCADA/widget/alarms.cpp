@@ -182,7 +182,7 @@ void WarGrey::SCADA::initialize_the_alarm(PLCMaster* plc) {
 	if (the_alarm == nullptr) {
 		the_alarm = new AlarmMS();
 
-		plc->push_confirmation_receiver(the_alarm);
+		plc->push_frame_receiver(the_alarm);
 	}
 }
 
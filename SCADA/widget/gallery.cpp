@@ -2,6 +2,7 @@
 
 #include "widget/gallery.hpp"
 #include "configuration.hpp"
+#include "intern.hpp"
 
 #include "graphlet/ui/textlet.hpp"
 #include "graphlet/shapelet.hpp"
@@ -59,8 +60,8 @@ namespace {
 			float vinset = normal_font_size;
 			float unitsize = (height - vinset - vinset) / (float(_N(GS)) * 2.0F * 1.618F);
 
-			this->font = make_bold_text_format(std::fminf(unitsize, 18.0F));
-			this->status_font = make_bold_text_format(14.0F);
+			this->font = intern_bold_text_format(std::fminf(unitsize, 18.0F));
+			this->status_font = intern_bold_text_format(14.0F);
 
 			this->background = this->insert_one(new Rectanglet(width, height, Colours::Background));
 
@@ -2,6 +2,7 @@
 
 #include "widget/settings.hpp"
 #include "configuration.hpp"
+#include "intern.hpp"
 
 #include "graphlet/ui/textlet.hpp"
 #include "graphlet/ui/buttonlet.hpp"
@@ -26,11 +27,11 @@ using namespace Microsoft::Graphics::Canvas::Text;
 using namespace Microsoft::Graphics::Canvas::Brushes;
 
 /*************************************************************************************************/
-static CanvasSolidColorBrush^ region_background = Colours::make(diagnostics_region_background);
-static CanvasSolidColorBrush^ settings_background = Colours::make(diagnostics_alarm_background);
+static CanvasSolidColorBrush^ region_background = intern_brush(diagnostics_region_background);
+static CanvasSolidColorBrush^ settings_background = intern_brush(diagnostics_alarm_background);
 static CanvasSolidColorBrush^ settings_foreground = Colours::Silver;
-static CanvasSolidColorBrush^ caption_foreground = Colours::make(diagnostics_caption_foreground);
-static CanvasSolidColorBrush^ caption_background = Colours::make(diagnostics_caption_background);
+static CanvasSolidColorBrush^ caption_foreground = intern_brush(diagnostics_caption_foreground);
+static CanvasSolidColorBrush^ caption_background = intern_brush(diagnostics_caption_background);
 
 static const float settings_corner_radius = 8.0F;
 
@@ -72,16 +73,16 @@ namespace {
 	private class Settings : public ISatellite, public PLCConfirmation {
 	public:
 		Settings(PLCMaster* device) : ISatellite(default_logging_level, __MODULE__), gapsize(normal_font_size), device(device) {
-			this->caption_font = make_bold_text_format("Consolas", large_font_size);
-			this->label_font = make_bold_text_format("Consolas", normal_font_size);
-			this->setting_font = make_bold_text_format("Microsoft YeHei", normal_font_size);
+			this->caption_font = intern_bold_text_format("Consolas", large_font_size);
+			this->label_font = intern_bold_text_format("Consolas", normal_font_size);
+			this->setting_font = intern_bold_text_format("Microsoft YeHei", normal_font_size);
 			this->settings_style = make_highlight_dimension_style(large_font_size, 8U, 1);
 
-			this->button_style.font = make_bold_text_format("Microsoft YeHei", normal_font_size);
+			this->button_style.font = intern_bold_text_format("Microsoft YeHei", normal_font_size);
 			this->button_style.corner_radius = 3.0F;
 			this->button_style.thickness = 2.0F;
 
-			this->device->push_confirmation_receiver(this);
+			this->device->push_frame_receiver(this);
 
 			put_preference(settings_timestamp_key, 1LL); // Every relaunch requires authentication 
 		}
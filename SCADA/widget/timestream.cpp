@@ -1,4 +1,7 @@
-﻿#include "widget/timestream.hpp"
+﻿#include <deque>
+#include <mutex>
+
+#include "widget/timestream.hpp"
 #include "configuration.hpp"
 
 #include "page/hydraulics.hpp"
@@ -11,6 +14,8 @@
 #include "page/hopper_doors.hpp"
 #include "page/lubrications.hpp"
 
+#include "decorator/probe.hpp"
+
 #include "datum/box.hpp"
 
 #include "peer/slang.hpp"
@@ -30,11 +35,182 @@ using namespace Microsoft::Graphics::Canvas::UI;
 
 /*************************************************************************************************/
 namespace {
+	/** NOTE
+	 * At normal speed, the timemachine delivers one snapshot per frame of its own,
+	 *   pages of the timemachine receive every snapshot as soon as it arrives, parcel included.
+	 *
+	 * When the operator seeks (the playback starts over) or fast-forwards (snapshots arrive
+	 *   faster than half of the timemachine frame period), the page enters the fast-forward mode,
+	 *   snapshots are then queued and dispatched when the page itself is updated,
+	 *   pages with stateful dashboards fold every queued snapshot in order, the others only take the landing one,
+	 *   hence the hidden pages and the intermediate frames cost nothing but a memcpy.
+	 * The page leaves the fast-forward mode once the queue is drained and snapshots are paced again.
+	 *
+	 * Snapshots arrive in the thread of the timemachine, the queue is swapped out under the lock
+	 *   and dispatched after the lock is released, buffers are recycled.
+	 */
+	private enum class Folding { Landing, EveryFrame };
+
+	template<class Page>
+	private class LandingPage : public Page {
+	public:
+		template<typename... Args>
+		LandingPage(long long frame_period, Folding folding, Args... args) : Page(args...)
+			, frame_period(frame_period), last_arrival(0LL), folding(folding), fast_forwarding(false), folded(0U) {}
+
+		virtual ~LandingPage() noexcept {
+			this->recycle(this->pending);
+			this->recycle(this->landed);
+
+			for (auto spare : this->spares) {
+				delete[] spare.data;
+			}
+		}
+
+	public:
+		void on_startover(long long departure_ms, long long destination_ms) override {
+			{ std::unique_lock<std::mutex> lock(this->section);
+				// snapshots before a startover belong to the old history
+				this->folded += ((unsigned int)(this->pending.size()));
+				this->recycle(this->pending);
+				this->fast_forwarding = true;
+			}
+
+			Page::on_startover(departure_ms, destination_ms);
+		}
+
+		void on_timestream(long long timepoint_ms, size_t addr0, size_t addrn, uint8* data, size_t size, uint64 p_type, size_t p_size, Syslog* logger) override {
+			long long now = current_milliseconds();
+			bool immediate = false;
+
+			{ std::unique_lock<std::mutex> lock(this->section);
+				if ((now - this->last_arrival) < (this->frame_period / 2LL)) {
+					this->fast_forwarding = true;
+				}
+
+				this->last_arrival = now;
+
+				if (this->fast_forwarding) {
+					if ((this->folding == Folding::Landing) && (!this->pending.empty())) {
+						this->spares.push_back(this->pending.back());
+						this->pending.pop_back();
+						this->folded += 1U;
+					}
+
+					this->pending.push_back(this->make_snapshot(timepoint_ms, addr0, addrn, data, size, p_type, p_size, logger));
+				} else {
+					immediate = true;
+				}
+			}
+
+			if (immediate) {
+				Page::on_timestream(timepoint_ms, addr0, addrn, data, size, p_type, p_size, logger);
+			}
+		}
+
+		void update(long long count, long long interval, long long uptime) override {
+			unsigned int folded = 0U;
+
+			{ std::unique_lock<std::mutex> lock(this->section);
+				std::swap(this->pending, this->landed);
+				folded = this->folded;
+				this->folded = 0U;
+			}
+
+			if (!this->landed.empty()) {
+				LandingPage::Snapshot& self = this->landed.back();
+
+				if (folded > 0U) {
+					self.logger->log_message(Log::Debug, L"%s: landed at %lld, %u intermediate frames skipped",
+						this->name()->Data(), self.timepoint, folded);
+				}
+
+				for (auto snapshot : this->landed) {
+					Page::on_timestream(snapshot.timepoint, snapshot.addr0, snapshot.addrn,
+						snapshot.data, snapshot.size, snapshot.p_type, snapshot.p_size, snapshot.logger);
+				}
+			}
+
+			{ std::unique_lock<std::mutex> lock(this->section);
+				this->recycle(this->landed);
+
+				if (this->pending.empty() && ((current_milliseconds() - this->last_arrival) >= (this->frame_period / 2LL))) {
+					this->fast_forwarding = false;
+				}
+			}
+
+			Page::update(count, interval, uptime);
+		}
+
+	private:
+		struct Snapshot {
+			uint8* data;
+			size_t capacity;
+			long long timepoint;
+			size_t addr0;
+			size_t addrn;
+			size_t size;
+			uint64 p_type;
+			size_t p_size;
+			Syslog* logger;
+		};
+
+	private:
+		LandingPage::Snapshot make_snapshot(long long timepoint_ms, size_t addr0, size_t addrn, uint8* data, size_t size
+			, uint64 p_type, size_t p_size, Syslog* logger) {
+			LandingPage::Snapshot self = { nullptr, 0U, timepoint_ms, addr0, addrn, size, p_type, p_size, logger };
+			size_t total = size + p_size; // the parcel follows the signals
+
+			if (!this->spares.empty()) {
+				self.data = this->spares.back().data;
+				self.capacity = this->spares.back().capacity;
+				this->spares.pop_back();
+			}
+
+			if (self.capacity < total) {
+				if (self.data != nullptr) {
+					delete[] self.data;
+				}
+
+				self.data = new uint8[total];
+				self.capacity = total;
+			}
+
+			memcpy(self.data, data, total);
+
+			return self;
+		}
+
+		void recycle(std::deque<LandingPage::Snapshot>& snapshots) {
+			for (auto snapshot : snapshots) {
+				this->spares.push_back(snapshot);
+			}
+
+			snapshots.clear();
+		}
+
+	private:
+		std::deque<LandingPage::Snapshot> pending;
+		std::deque<LandingPage::Snapshot> landed;
+		std::deque<LandingPage::Snapshot> spares;
+		std::mutex section;
+		long long frame_period;
+		long long last_arrival;
+		Folding folding;
+		bool fast_forwarding;
+		unsigned int folded;
+	};
+
+	template<class Page, typename... Args>
+	Page* timemachine_page(long long frame_period, Folding folding, Args... args) {
+		return new InstrumentedPlanet<LandingPage<Page>>("timemachine", frame_period, folding, args...);
+	}
+
 	private class TimeStream : public TimeMachine, public PLCConfirmation, public SlangLocalPeer<uint8> {
 	public:
 		TimeStream(long long time_speed, int frame_rate)
 			: TimeMachine(L"timemachine", time_speed * 1000LL, frame_rate, make_system_logger(default_logging_level, __MODULE__))
-			, last_timepoint(current_milliseconds()) {}
+			, frame_period(1000LL / frame_rate), last_timepoint(current_milliseconds()), constructed(false) {}
 
 		void fill_extent(float* width, float* height) override {
 			float margin = normal_font_size * 2.0F;
@@ -60,23 +236,41 @@ namespace {
 
 	public:
 		void construct(CanvasCreateResourcesReason reason) override {
-			this->pickup(new HydraulicsPage());
-			this->pickup(new ChargesPage());
-			this->pickup(new DredgesPage(DragView::_));
-			this->pickup(new DischargesPage());
-			this->pickup(new GlandsPage());
-			this->pickup(new FlushsPage());
-			this->pickup(new DredgesPage(DragView::PortSide));
-			this->pickup(new HopperDoorsPage());
-			this->pickup(new LubricatingsPage());
-			this->pickup(new DraughtsPage());
-			this->pickup(new DredgesPage(DragView::Starboard));
-			//this->pickup(new DredgesPage(DragView::Suctions));
+			// pages are picked up when the timemachine is launched for the first time
+		}
+
+		void launch() {
+			if (!this->constructed) {
+				this->construct_pages();
+				this->constructed = true;
+			}
+
+			this->show();
+		}
+
+	private:
+		void construct_pages() {
+			long long fp = this->frame_period;
+
+			this->pickup(timemachine_page<HydraulicsPage>(fp, Folding::Landing));
+			this->pickup(timemachine_page<ChargesPage>(fp, Folding::Landing));
+			this->pickup(timemachine_page<DredgesPage>(fp, Folding::Landing, DragView::_));
+			this->pickup(timemachine_page<DischargesPage>(fp, Folding::Landing));
+			this->pickup(timemachine_page<GlandsPage>(fp, Folding::Landing));
+			this->pickup(timemachine_page<FlushsPage>(fp, Folding::Landing));
+			this->pickup(timemachine_page<DredgesPage>(fp, Folding::Landing, DragView::PortSide));
+			this->pickup(timemachine_page<HopperDoorsPage>(fp, Folding::Landing));
+			this->pickup(timemachine_page<LubricatingsPage>(fp, Folding::Landing));
+			this->pickup(timemachine_page<DraughtsPage>(fp, Folding::EveryFrame)); // the timeseries
+			this->pickup(timemachine_page<DredgesPage>(fp, Folding::Landing, DragView::Starboard));
+			//this->pickup(timemachine_page<DredgesPage>(fp, Folding::Landing, DragView::Suctions));
 		}
 
 	private:
+		long long frame_period;
 		long long last_timepoint;
 		DGPS dgps;
+		bool constructed;
 	};
 }
 
@@ -87,13 +281,13 @@ void WarGrey::SCADA::initialize_the_timemachine(PLCMaster* plc, long long speed,
 	if (the_timemachine == nullptr) {
 		the_timemachine = new TimeStream(speed, frame_rate);
 
-		plc->push_confirmation_receiver(the_timemachine);
+		plc->push_frame_receiver(the_timemachine);
 		dgps_slang_ref(SlangPort::SCADA)->push_slang_local_peer(the_timemachine);
 	}
 }
 
 void WarGrey::SCADA::launch_the_timemachine() {
 	if (the_timemachine != nullptr) {
-		the_timemachine->show();
+		the_timemachine->launch();
 	}
 }